@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <cmath>
+
+// Second-order IIR section, transposed direct form II.
+// Coefficient formulas and the per-sample update match juce::dsp::IIR
+// (ArrayCoefficients::makeLowPass/makeHighPass and Filter::processSample),
+// so swapping one for the other does not change the sound.
+class Biquad
+{
+public:
+    // { b0, b1, b2, a1, a2 }, already divided by a0
+    using Coefficients = std::array<float, 5>;
+
+    static constexpr float inverseRootTwo = 0.70710678118654752440f;
+
+    static Coefficients makeLowPass(double sampleRate, float frequency, float q = inverseRootTwo) noexcept
+    {
+        const float n = 1.0f / std::tan(pi * frequency / static_cast<float>(sampleRate));
+        const float nSquared = n * n;
+        const float invQ = 1.0f / q;
+        const float c1 = 1.0f / (1.0f + invQ * n + nSquared);
+
+        return { c1, c1 * 2.0f, c1, c1 * 2.0f * (1.0f - nSquared), c1 * (1.0f - invQ * n + nSquared) };
+    }
+
+    static Coefficients makeHighPass(double sampleRate, float frequency, float q = inverseRootTwo) noexcept
+    {
+        const float n = std::tan(pi * frequency / static_cast<float>(sampleRate));
+        const float nSquared = n * n;
+        const float invQ = 1.0f / q;
+        const float c1 = 1.0f / (1.0f + invQ * n + nSquared);
+
+        return { c1, c1 * -2.0f, c1, c1 * 2.0f * (nSquared - 1.0f), c1 * (1.0f - invQ * n + nSquared) };
+    }
+
+    // Keeps the state, so coefficients can move while the filter runs
+    void setCoefficients(const Coefficients& newCoefficients) noexcept { c = newCoefficients; }
+
+    void reset() noexcept { s1 = s2 = 0.0f; }
+
+    float processSample(float x) noexcept
+    {
+        const float y = c[0] * x + s1;
+        s1 = c[1] * x - c[3] * y + s2;
+        s2 = c[2] * x - c[4] * y;
+        return y;
+    }
+
+private:
+    static constexpr float pi = 3.14159265358979323846f;
+
+    Coefficients c { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    float s1 = 0.0f, s2 = 0.0f;
+};
@@ -1,20 +1,28 @@
 #pragma once
+#include "DspTables.h"
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <memory>
 
 // Pure brickwall limiter (mono, no oversampling)
 class BrickWallLimiter {
 public:
-    BrickWallLimiter() = default;
+    BrickWallLimiter() : tables(DspTables::get()), truePeakCoeffs(&tables->getTruePeakCoefficients()) {}
     int getLookaheadSamples() const { return lookaheadSamples; }
 
+    // True-peak mode also detects peaks between samples (4x interpolated, as
+    // a meter per ITU-R BS.1770 would). Costs 36 MACs per sample; offline only.
+    void setTruePeak(bool shouldDetectTruePeak) noexcept { truePeak = shouldDetectTruePeak; }
+    bool isTruePeak() const noexcept { return truePeak; }
+
     void prepare(double sampleRate, int maxBlockSize = 512) {
         this->sampleRate = sampleRate;
 
         // Lookahead buffer for true peak detection (1ms default)
         lookaheadSamples = static_cast<int>(0.003 * sampleRate); // 1ms lookahead
-        if (lookaheadSamples < 4) lookaheadSamples = 4;
+        if (lookaheadSamples < truePeakTaps) lookaheadSamples = truePeakTaps; // true-peak detector sits this far back
 
         lookaheadBuffer.resize(lookaheadSamples, 0.0f);
         lookaheadIndex = 0;
@@ -51,6 +59,8 @@ public:
 
             // True peak detection
             float peak = std::abs(input);
+            if (truePeak)
+                peak = std::max(peak, interSamplePeak(input));
 
             // Calculate required gain reduction
             float targetGain = 1.0f;
@@ -88,6 +98,9 @@ public:
         float delayed = lookaheadBuffer[delayedIndex];
 
         float peak = std::abs(input);
+        if (truePeak)
+            peak = std::max(peak, interSamplePeak(input));
+
         float targetGain = 1.0f;
         if (peak > ceiling && peak > 0.00001f)
             targetGain = ceiling / peak;
@@ -115,6 +128,8 @@ public:
         std::fill(lookaheadBuffer.begin(), lookaheadBuffer.end(), 0.0f);
         lookaheadIndex = 0;
         gainReduction = 1.0f;
+        truePeakHistory.fill(0.0f);
+        truePeakIndex = 0;
     }
 
 private:
@@ -132,4 +147,32 @@ private:
     // Envelope coefficients
     float attackCoeff = 0.9f;
     float releaseCoeff = 0.999f;
+
+    // True-peak detector: 12-tap Hann-windowed sinc, three fractional phases
+    // between the middle two samples of the history. The coefficients are
+    // the process-wide ones in DspTables.
+    static constexpr int truePeakTaps = DspTables::truePeakTaps;
+
+    bool truePeak = false;
+    std::array<float, truePeakTaps> truePeakHistory {};
+    int truePeakIndex = 0; // oldest sample
+    std::shared_ptr<const DspTables> tables;
+    const DspTables::TruePeakCoefficients* truePeakCoeffs;
+
+    float interSamplePeak(float input) noexcept
+    {
+        truePeakHistory[truePeakIndex] = input;
+        truePeakIndex = (truePeakIndex + 1) % truePeakTaps;
+
+        float peak = 0.0f;
+        for (const auto& coeffs : *truePeakCoeffs)
+        {
+            float sum = 0.0f;
+            for (int k = 0; k < truePeakTaps; ++k)
+                sum += coeffs[k] * truePeakHistory[(truePeakIndex + k) % truePeakTaps];
+            peak = std::max(peak, std::abs(sum));
+        }
+
+        return peak;
+    }
 };
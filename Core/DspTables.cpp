@@ -0,0 +1,103 @@
+#include "DspTables.h"
+#include <cassert>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    // First stage carries the audio band right up to the base-rate Nyquist,
+    // so it gets the long filter; the second only has to clear its images
+    constexpr int stageTaps[DspTables::numHalfBandStages] = { 63, 31 };
+    constexpr double kaiserBeta = 8.0; // ~80 dB stopband
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            const double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+        return sum;
+    }
+
+    void designHalfBand(DspTables::HalfBandKernel& kernel, int numTaps)
+    {
+        assert(numTaps >= 7 && (numTaps - 3) % 4 == 0); // centre tap on an odd index
+        assert((numTaps + 1) / 2 <= DspTables::maxHalfBandTaps);
+
+        const int centre = (numTaps - 1) / 2;
+        kernel.centrePhase = (centre - 1) / 2;
+        kernel.numTaps = (numTaps + 1) / 2;
+
+        double sum = 0.0;
+
+        for (int i = 0; i < kernel.numTaps; ++i)
+        {
+            const double x = 2.0 * (double) i - centre;
+            const double ratio = x / (centre + 1);
+            const double window = besselI0(kaiserBeta * std::sqrt(1.0 - ratio * ratio)) / besselI0(kaiserBeta);
+            const double tap = std::sin(pi * x * 0.5) / (pi * x) * window;
+            kernel.taps[(size_t) i] = (float) tap;
+            sum += tap;
+        }
+
+        // Each polyphase branch at exactly half gain, so DC passes at unity
+        for (int i = 0; i < kernel.numTaps; ++i)
+            kernel.taps[(size_t) i] = (float) (kernel.taps[(size_t) i] * 0.5 / sum);
+    }
+
+    void designTruePeak(DspTables::TruePeakCoefficients& coeffs)
+    {
+        const double halfSpan = DspTables::truePeakTaps / 2;
+
+        for (int p = 0; p < DspTables::truePeakPhases; ++p)
+        {
+            const double position = (halfSpan - 1) + (p + 1) / 4.0; // between taps 5 and 6
+            double sum = 0.0;
+
+            for (int k = 0; k < DspTables::truePeakTaps; ++k)
+            {
+                const double x = position - k;
+                const double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+                const double window = 0.5 * (1.0 + std::cos(pi * x / halfSpan));
+                coeffs[(size_t) p][(size_t) k] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+
+            for (auto& c : coeffs[(size_t) p])
+                c = static_cast<float>(c / sum); // unity gain at DC
+        }
+    }
+}
+
+//==============================================================================
+DspTables::DspTables()
+{
+    for (int s = 0; s < numHalfBandStages; ++s)
+        designHalfBand(halfBand[(size_t) s], stageTaps[s]);
+
+    designTruePeak(truePeak);
+}
+
+std::shared_ptr<const DspTables> DspTables::get()
+{
+    // Only a weak reference here, so the tables go with the last engine
+    static std::mutex lock;
+    static std::weak_ptr<const DspTables> current;
+
+    const std::lock_guard<std::mutex> guard(lock);
+
+    auto tables = current.lock();
+    if (tables == nullptr)
+    {
+        // Plain new rather than make_shared: it honours the 64-byte alignment
+        tables.reset(new DspTables());
+        current = tables;
+    }
+
+    return tables;
+}
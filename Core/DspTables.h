@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <memory>
+
+// Read-only coefficient tables shared by every engine in the process.
+//
+// The half-band kernels of the oversampler stages and the true-peak
+// interpolator's phases are the same for every instance, so they are built
+// once, by whichever engine asks first, and never written again. Each table
+// starts on its own cache line; with many plugin instances in a session they
+// all read the same few kilobytes instead of one private copy each.
+//
+// Lifetime works like juce::SharedResourcePointer (the core has no JUCE):
+// get() hands out shared ownership, the first call builds the tables, and
+// they are freed when the last holder lets go. Safe to call from any thread,
+// though it may allocate, so not from the audio thread.
+class DspTables
+{
+public:
+    static std::shared_ptr<const DspTables> get();
+
+    //==============================================================================
+    // Half-band low-pass for each oversampler stage. Only the taps at even
+    // indices are stored: the others are zero apart from the 0.5 centre tap,
+    // which sits at 2 * centrePhase + 1.
+    static constexpr int numHalfBandStages = 2;
+    static constexpr int maxHalfBandTaps = 32;
+
+    struct alignas(64) HalfBandKernel
+    {
+        std::array<float, maxHalfBandTaps> taps {};
+        int numTaps = 0;
+        int centrePhase = 0;
+    };
+
+    const HalfBandKernel& getHalfBandKernel(int stage) const noexcept { return halfBand[(size_t) stage]; }
+
+    //==============================================================================
+    // True-peak interpolator: 12-tap Hann-windowed sinc at three fractional
+    // positions between the middle two samples of the history
+    static constexpr int truePeakTaps = 12;
+    static constexpr int truePeakPhases = 3;
+
+    using TruePeakCoefficients = std::array<std::array<float, truePeakTaps>, truePeakPhases>;
+
+    const TruePeakCoefficients& getTruePeakCoefficients() const noexcept { return truePeak; }
+
+private:
+    DspTables();
+
+    std::array<HalfBandKernel, numHalfBandStages> halfBand;
+    alignas(64) TruePeakCoefficients truePeak {};
+};
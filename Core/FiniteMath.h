@@ -0,0 +1,10 @@
+#pragma once
+
+// The core washes NaN and Inf out of its input, parameters and filter states
+// with std::isfinite. -ffinite-math-only (part of -ffast-math) lets the
+// compiler assume those checks always pass and delete them, so a build with it
+// would pass NaNs straight through. Any file relying on the checks includes
+// this, and such a build fails here instead of shipping without them.
+#if defined(__FINITE_MATH_ONLY__) && __FINITE_MATH_ONLY__
+ #error "Build with -fno-finite-math-only: the NaN/Inf guards depend on it"
+#endif
@@ -0,0 +1,968 @@
+#include "FmEngineCore.h"
+#include "FiniteMath.h"
+#include "SineClipper.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <string>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define FM_ENGINE_SSE_DENORMALS 1
+#endif
+
+namespace
+{
+    constexpr float pi = 3.14159265358979323846f;
+
+    // Flush-to-zero / denormals-are-zero for the scope, like juce::ScopedNoDenormals.
+    // The feedback-free filters here still crawl through denormals on silence.
+    // Canonical: the whole control register is set rather than OR'ed into, so
+    // the host's rounding mode doesn't leak into the output either.
+    class ScopedFlushDenormals
+    {
+    public:
+        explicit ScopedFlushDenormals(bool canonical) noexcept
+        {
+           #if FM_ENGINE_SSE_DENORMALS
+            saved = _mm_getcsr();
+            _mm_setcsr(canonical ? 0x9fc0 : (saved | 0x8040)); // FTZ | DAZ (canonical: + all masked, round to nearest)
+           #elif defined(__aarch64__)
+            asm volatile("mrs %0, fpcr" : "=r"(saved));
+            asm volatile("msr fpcr, %0" : : "r"(canonical ? (1ull << 24) : (saved | (1ull << 24)))); // FZ (canonical: round to nearest)
+           #else
+            (void) canonical;
+           #endif
+        }
+
+        ~ScopedFlushDenormals() noexcept
+        {
+           #if FM_ENGINE_SSE_DENORMALS
+            _mm_setcsr(saved);
+           #elif defined(__aarch64__)
+            asm volatile("msr fpcr, %0" : : "r"(saved));
+           #endif
+        }
+
+    private:
+       #if defined(__aarch64__) && !FM_ENGINE_SSE_DENORMALS
+        unsigned long long saved = 0;
+       #else
+        unsigned int saved = 0;
+       #endif
+    };
+
+    // one liner to wash audio floats so they don't go to nans
+    inline float sanitize(float x) noexcept { return std::isfinite(x) ? x : 0.0f; }
+
+    inline const float* offset(const float* p, int start) noexcept { return p != nullptr ? p + start : nullptr; }
+}
+
+//==============================================================================
+void FmEngineCore::LinearSmoother::setTargetValue(float newTarget) noexcept
+{
+    if (newTarget == targetValue)
+        return;
+
+    if (stepsToTarget <= 0)
+    {
+        current = targetValue = newTarget;
+        countdown = 0;
+        return;
+    }
+
+    targetValue = newTarget;
+    countdown = stepsToTarget;
+    step = (targetValue - current) / (float) countdown;
+}
+
+void FmEngineCore::LinearSmoother::rampTo(float newTarget, int numSteps) noexcept
+{
+    if (numSteps <= 0)
+    {
+        jumpTo(newTarget);
+        return;
+    }
+
+    // From wherever it is now, mid-ramp or not
+    targetValue = newTarget;
+    countdown = numSteps;
+    step = (targetValue - current) / (float) countdown;
+}
+
+float FmEngineCore::LinearSmoother::getNextValue() noexcept
+{
+    if (countdown <= 0)
+        return targetValue;
+
+    --countdown;
+    current = countdown > 0 ? current + step : targetValue;
+    return current;
+}
+
+//==============================================================================
+FmEngineCore::FmEngineCore()
+{
+    limiterOutL.setCeiling(-0.1f);
+    limiterOutR.setCeiling(-0.1f);
+}
+
+const char* FmEngineCore::getBuildId() noexcept
+{
+    // Whatever decides how the float code was generated: same id, same renders
+    static const std::string id = []
+    {
+        std::string s = "dsp" + std::to_string(dspRevision);
+
+       #if defined(__clang__)
+        s += " clang " __clang_version__;
+       #elif defined(__GNUC__)
+        s += " gcc " __VERSION__;
+       #elif defined(_MSC_VER)
+        s += " msvc " + std::to_string(_MSC_FULL_VER);
+       #endif
+
+       #if defined(__x86_64__) || defined(_M_X64)
+        s += " x86_64";
+       #elif defined(__aarch64__) || defined(_M_ARM64)
+        s += " arm64";
+       #endif
+
+       #if defined(__FMA__)
+        s += " fma";
+       #endif
+       #if defined(__FAST_MATH__) || defined(_M_FP_FAST)
+        s += " fast-math";
+       #endif
+       #if defined(__OPTIMIZE__) || defined(NDEBUG)
+        s += " optimised";
+       #endif
+
+        return s;
+    }();
+
+    return id.c_str();
+}
+
+float FmEngineCore::rangeToMs(int rangeIndex) noexcept
+{
+    static constexpr float delayChoices[] = { 1.0f, 10.0f, 100.0f, 500.0f };
+    return delayChoices[std::clamp(rangeIndex, 0, 3)];
+}
+
+void FmEngineCore::prepare(double newSampleRate, int newMaxBlockSize)
+{
+    assert(newSampleRate > 0.0 && newMaxBlockSize > 0);
+    sampleRate = newSampleRate;
+    maxBlockSize = newMaxBlockSize;
+
+    // Lane stride rounded up to whole cache lines, plus the slack to align the first
+    constexpr size_t floatsPerLine = scratchAlignment / sizeof(float);
+    const size_t stride = ((size_t) maxBlockSize + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+    const size_t graphStride = stride * maxOversamplingFactor;
+    const size_t totalFloats = stride * numScratchLanes + graphStride * numGraphLanes;
+    scratchArena.assign(totalFloats + floatsPerLine - 1, 0.0f);
+
+    void* base = scratchArena.data();
+    size_t space = scratchArena.size() * sizeof(float);
+    std::align(scratchAlignment, totalFloats * sizeof(float), base, space);
+
+    for (int lane = 0; lane < numScratchLanes; ++lane)
+        scratch[(size_t) lane] = static_cast<float*>(base) + stride * (size_t) lane;
+
+    for (int lane = 0; lane < numGraphLanes; ++lane)
+        graphScratch[(size_t) lane] = static_cast<float*>(base) + stride * numScratchLanes + graphStride * (size_t) lane;
+
+    oversampler.prepare(1, maxBlockSize);
+    renderOversampler.prepare(2, maxBlockSize);
+
+    // 0.5 is the resting (zero-depth) position of the normalised modulator
+    lastNormalizedModL = 0.5f;
+    lastNormalizedModR = 0.5f;
+
+    modulatorLowPassL.prepare(sampleRate, maxBlockSize);
+    modulatorLowPassR.prepare(sampleRate, maxBlockSize);
+
+    // Start out on the current settings; no switch dip pending
+    applied = target;
+    appliedOversamplingFactor.store(applied.oversamplingFactor, std::memory_order_relaxed);
+    switchPhase = SwitchPhase::idle;
+    switchFadeRemaining = 0;
+    switchFadeLength = std::max(1, (int) std::lround(switchFadeTimeMs * 0.001 * sampleRate));
+
+    // Delays run at the oversampled rate
+    const float safeMaxDelay = rangeToMs(applied.range);
+    delayL.prepare(sampleRate * applied.oversamplingFactor, safeMaxDelay);
+    delayR.prepare(sampleRate * applied.oversamplingFactor, safeMaxDelay);
+
+    // The graph's delays only as long as the longest range needs, and only
+    // once there are operators to run: they cost megabytes
+    preparedGraph.reset();
+    if (applied.operatorAlgorithm != OperatorGraph::single || graph != nullptr)
+    {
+        graph = std::make_unique<OperatorGraph>();
+        graph->prepare(sampleRate, maxOversamplingFactor, rangeToMs(3));
+        graph->setSampleRate(sampleRate * applied.oversamplingFactor);
+        graph->setRange(safeMaxDelay);
+        graph->setAlgorithm(applied.operatorAlgorithm);
+    }
+    graphHandoff.store(graph != nullptr ? graphAdopted : noGraph, std::memory_order_relaxed);
+
+    modulatorLowPassL.setCutoff(applied.lpCutoff);
+    modulatorLowPassR.setCutoff(applied.lpCutoff);
+
+    // Smoothing times in milliseconds (adjust to taste)
+    const float modDepthSmoothingTimeMs = 10.0f;
+    const float cutoffSmoothingTimeMs = 15.0f; // it sucks for audio rate modulation of this LPF but that's not supposed to be a feature
+
+    smoothedModDepth.reset((int) std::floor(modDepthSmoothingTimeMs * 0.001f * sampleRate));
+    smoothedModDepth.jumpTo(applied.modDepth);
+
+    smoothedCutoff.reset((int) std::floor(cutoffSmoothingTimeMs * 0.001f * sampleRate));
+    smoothedCutoff.setTargetValue(applied.lpCutoff);
+
+    // HPF to account for the insane low freq introduced
+    highPassL.setCoefficients(Biquad::makeHighPass(sampleRate, 10.0f, 0.707f));
+    highPassR.setCoefficients(Biquad::makeHighPass(sampleRate, 10.0f, 0.707f));
+
+    limiterOutL.prepare(sampleRate, maxBlockSize);
+    limiterOutR.prepare(sampleRate, maxBlockSize);
+
+    applyRenderQuality(applied.renderQuality);
+}
+
+void FmEngineCore::prepareOperatorGraph()
+{
+    if (sampleRate <= 0.0 || graphHandoff.load(std::memory_order_acquire) != noGraph)
+        return;
+
+    preparedGraph = std::make_unique<OperatorGraph>();
+    preparedGraph->prepare(sampleRate, maxOversamplingFactor, rangeToMs(3));
+    graphHandoff.store(graphPending, std::memory_order_release);
+}
+
+void FmEngineCore::adoptPreparedGraph() noexcept
+{
+    if (graphHandoff.load(std::memory_order_acquire) != graphPending)
+        return;
+
+    graph = std::move(preparedGraph); // graph was null: nothing freed here
+    graph->setSampleRate(sampleRate * applied.oversamplingFactor);
+    graph->setRange(rangeToMs(applied.range));
+    graph->setInterpolation(applied.renderQuality ? InterpolatedDelay::Interpolation::lagrange6
+                                                  : InterpolatedDelay::Interpolation::cubic);
+    graph->setAlgorithm(applied.operatorAlgorithm);
+    graphHandoff.store(graphAdopted, std::memory_order_relaxed);
+}
+
+void FmEngineCore::reset() noexcept
+{
+    if (maxBlockSize <= 0)
+        return;
+
+    applied = target;
+
+    // Operators without a graph yet stay off until it comes in
+    if (graph == nullptr)
+        adoptPreparedGraph();
+    if (graph == nullptr)
+        applied.operatorAlgorithm = OperatorGraph::single;
+    appliedOversamplingFactor.store(applied.oversamplingFactor, std::memory_order_relaxed);
+    switchPhase = SwitchPhase::idle;
+    switchFadeRemaining = 0;
+
+    const float maxDelayMs = rangeToMs(applied.range);
+    for (auto* delay : { &delayL, &delayR })
+    {
+        delay->setMaxDelayMs(maxDelayMs);
+        delay->changeSampleRate(sampleRate * applied.oversamplingFactor);
+        delay->reset();
+    }
+    lastBaseDelay = 0.0f;
+    delayL.setBaseDelayMs(0.0f);
+    delayR.setBaseDelayMs(0.0f);
+
+    if (graph != nullptr)
+    {
+        graph->setRange(maxDelayMs);
+        graph->setSampleRate(sampleRate * applied.oversamplingFactor);
+        graph->setAlgorithm(applied.operatorAlgorithm);
+        graph->reset();
+    }
+
+    modulatorLowPassL.setCutoff(applied.lpCutoff);
+    modulatorLowPassR.setCutoff(applied.lpCutoff);
+    resetModulatorFilters();
+
+    oversampler.reset();
+    renderOversampler.reset();
+    highPassL.reset();
+    highPassR.reset();
+    limiterOutL.clear();
+    limiterOutR.clear();
+    applyRenderQuality(applied.renderQuality);
+
+    lastNormalizedModL = 0.5f;
+    lastNormalizedModR = 0.5f;
+    smoothedModDepth.jumpTo(applied.modDepth);
+    smoothedCutoff.jumpTo(applied.lpCutoff);
+    lpfSoloFade = applied.modulatorSolo ? 1.0f : 0.0f;
+}
+
+void FmEngineCore::resetDelays() noexcept
+{
+    delayL.reset();
+    delayR.reset();
+    if (graph != nullptr)
+        graph->reset();
+}
+
+void FmEngineCore::resetModulatorFilters() noexcept
+{
+    modulatorLowPassL.reset();
+    modulatorLowPassR.reset();
+}
+
+int FmEngineCore::computeLatencySamples(bool predelay, int range, bool limiter, int oversamplingFactor) const noexcept
+{
+    if (sampleRate <= 0.0)
+        return 0;
+
+    int latencySamples = 0;
+
+    if (predelay)
+        latencySamples = std::max(0, static_cast<int>(rangeToMs(range) * 0.001 * sampleRate * 0.5));
+
+    // The oversampling filters delay the carrier too. The 4x pair's 38.5
+    // samples round to 39: that half sample is left uncompensated
+    if (oversamplingFactor > 1)
+    {
+        const auto& activeOversampler = oversamplingFactor > 2 ? renderOversampler : oversampler;
+        latencySamples += (int) std::lround(activeOversampler.getLatencyInSamples());
+    }
+
+    // The limiter's lookahead line plays each sample lookahead - 1 samples late
+    if (limiter)
+        latencySamples += limiterOutL.getLookaheadSamples() - 1;
+
+    return latencySamples;
+}
+
+int FmEngineCore::computeWarmupSamples() const noexcept
+{
+    if (sampleRate <= 0.0)
+        return 0;
+
+    // An IIR stage's memory of the past is down to about -140 dB after this
+    // many time constants, with room for the low-pass's four repeated poles
+    constexpr double settleTimeConstants = 24.0;
+    constexpr double butterworthDamping = 0.7071;
+    auto settleSeconds = [](double cutoffHz)
+    {
+        return settleTimeConstants / (butterworthDamping * 2.0 * pi * cutoffHz);
+    };
+
+    const double lowPassCutoff = std::max(target.lpCutoff, LowPass::getMinCutoff());
+    // An operator graph reaches back through each of its delays in turn, and
+    // every operator steered by another settles its own low-pass on the way.
+    // With feedback this is an estimate: the loop never quite lets go.
+    const int operators = target.operatorAlgorithm;
+    const double reach = OperatorGraph::getReach(operators);
+    const int filterStages = 1 + OperatorGraph::getNumFilterStages(operators);
+
+    double seconds = rangeToMs(target.range) * 0.001 * reach       // the carrier the delays can reach back to
+                   + settleSeconds(lowPassCutoff) * filterStages   // the modulators setting them
+                   + settleSeconds(10.0);                          // DC high-pass
+
+    if (target.limiter)
+        seconds += 0.003 + settleTimeConstants * 0.002;   // lookahead, then the 2 ms release
+
+    // The oversampling kernels and the delay's interpolation taps
+    constexpr int firHistorySamples = 128;
+
+    return (int) std::ceil(seconds * sampleRate) + firHistorySamples;
+}
+
+//==============================================================================
+// Hosts may hand us more samples than prepare() promised (offline bounces,
+// variable-size buffers). Rather than growing buffers on the audio thread, work
+// through the block in prepared-size slices; every stage is stateful per sample,
+// so the output does not depend on how the block was cut.
+
+void FmEngineCore::process(const float* inL, const float* inR, const float* scL, const float* scR,
+                           float* outL, float* outR, int numSamples) noexcept
+{
+    assert(outL != nullptr && outR != nullptr);
+
+    if (numSamples <= 0)
+        return;
+
+    if (maxBlockSize <= 0)
+    {
+        // Not prepared yet: pass the input through
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float l = inL != nullptr ? inL[i] : 0.0f;
+            outR[i] = inR != nullptr ? inR[i] : l;
+            outL[i] = l;
+        }
+        return;
+    }
+
+    ScopedFlushDenormals noDenormals(deterministic);
+
+    for (int start = 0; start < numSamples;)
+    {
+        updateDiscreteSwitch();
+
+        int subBlockSize = std::min(maxBlockSize, startAutomationRamps(start, numSamples) - start);
+
+        // A fade-out ends on a slice boundary so the switch lands at its
+        // bottom; fade-ins and crossfades too, so a change waiting on one
+        // starts at the same sample whatever the block size
+        if (switchPhase != SwitchPhase::idle)
+            subBlockSize = std::min(subBlockSize, std::max(1, switchFadeRemaining));
+
+        processSubBlock(offset(inL, start), offset(inR, start), offset(scL, start), offset(scR, start),
+                        outL + start, outR + start, subBlockSize);
+        start += subBlockSize;
+    }
+
+    // Points are for one call. A ramp to one past its end carries on into
+    // the next calls; any points after that one are dropped
+    for (auto* lane : { &modDepthLane, &cutoffLane })
+        lane->numPoints = lane->nextPoint = lane->rampEnd = 0;
+}
+
+//==============================================================================
+// Sample-accurate automation. Each parameter's points are kept sorted; when
+// the ramp to one arrives, the ramp to the next starts, and process() cuts a
+// sub-block wherever that happens. The same cut falls wherever a ramp ends,
+// so every sub-block either ramps all the way through or holds still.
+
+bool FmEngineCore::addAutomationPoint(AutomatedParameter parameter, int sampleOffset, float value) noexcept
+{
+    auto& lane = parameter == AutomatedParameter::modDepth ? modDepthLane : cutoffLane;
+
+    if (lane.numPoints >= maxAutomationPoints || !std::isfinite(value))
+        return false;
+
+    // Insertion sort, after any points at the same offset
+    int i = lane.numPoints++;
+    for (; i > 0 && lane.points[(size_t) i - 1].sampleOffset > sampleOffset; --i)
+        lane.points[(size_t) i] = lane.points[(size_t) i - 1];
+
+    lane.points[(size_t) i] = { std::max(0, sampleOffset), value };
+    return true;
+}
+
+int FmEngineCore::startAutomationRamps(int position, int numSamples) noexcept
+{
+    // A new target from setSettings() glides over the smoothing time; points
+    // due now take over from that
+    smoothedModDepth.setTargetValue(target.modDepth);
+    smoothedCutoff.setTargetValue(target.lpCutoff);
+
+    int end = numSamples;
+
+    const auto follow = [position, &end](AutomationLane& lane, LinearSmoother& smoother, float& targetValue)
+    {
+        // Several points can fall due at once: a point at the position is a jump
+        while (lane.nextPoint < lane.numPoints && lane.rampEnd <= position)
+        {
+            const auto& point = lane.points[(size_t) lane.nextPoint++];
+            lane.rampEnd = point.sampleOffset;
+            smoother.rampTo(point.value, lane.rampEnd - position);
+            targetValue = point.value;
+        }
+
+        if (smoother.isSmoothing())
+            end = std::min(end, position + smoother.getStepsRemaining());
+    };
+
+    follow(modDepthLane, smoothedModDepth, target.modDepth);
+    follow(cutoffLane, smoothedCutoff, target.lpCutoff);
+
+    return end;
+}
+
+// A discrete change is never applied mid-signal. Algorithm, swap and limiter
+// crossfade over switchFadeTimeMs: the old routing, clipping and limiting run
+// alongside the new ones and the mix moves across. The other settings reset
+// state, so for them the output dips to silence over switchFadeTimeMs, the
+// switch happens on the slice boundary at the bottom, and the output comes
+// back up. A change that needs the dip turns a fade-in around from the
+// current level; anything else waits for the fade or crossfade to finish.
+void FmEngineCore::updateDiscreteSwitch() noexcept
+{
+    // Operators wait for their graph; the rest of a change goes ahead
+    if (graph == nullptr)
+        adoptPreparedGraph();
+
+    auto wanted = target;
+    if (graph == nullptr)
+        wanted.operatorAlgorithm = applied.operatorAlgorithm;
+
+    if (!wanted.sameDiscreteAs(applied))
+    {
+        const bool crossfade = wanted.canCrossfadeFrom(applied);
+
+        if (switchPhase == SwitchPhase::idle && crossfade)
+        {
+            startCrossfade(wanted);
+        }
+        else if (switchPhase == SwitchPhase::idle || (switchPhase == SwitchPhase::fadingIn && !crossfade))
+        {
+            switchFadeRemaining = switchPhase == SwitchPhase::fadingIn ? switchFadeLength - switchFadeRemaining
+                                                                       : switchFadeLength;
+            switchPhase = SwitchPhase::fadingOut;
+        }
+    }
+
+    // At the bottom (possibly straight away, if a fade-in had only just begun)
+    if (switchPhase == SwitchPhase::fadingOut && switchFadeRemaining <= 0)
+    {
+        applyDiscreteSettings(wanted);
+        switchPhase = SwitchPhase::fadingIn;
+        switchFadeRemaining = switchFadeLength;
+    }
+}
+
+void FmEngineCore::startCrossfade(const Settings& wanted) noexcept
+{
+    switchFrom = applied;
+
+    // A limiter coming in starts from silence, and plays that for its
+    // lookahead: it gets fed that long before its share goes up
+    switchPriming = 0;
+    if (wanted.limiter && !applied.limiter)
+    {
+        limiterOutL.clear();
+        limiterOutR.clear();
+        switchPriming = limiterOutL.getLookaheadSamples();
+    }
+
+    applyDiscreteSettings(wanted);
+    switchPhase = SwitchPhase::crossfading;
+    switchFadeRemaining = switchPriming + switchFadeLength;
+}
+
+void FmEngineCore::applyRenderQuality(bool renderQuality) noexcept
+{
+    const auto interpolation = renderQuality ? InterpolatedDelay::Interpolation::lagrange6
+                                             : InterpolatedDelay::Interpolation::cubic;
+    delayL.setInterpolation(interpolation);
+    delayR.setInterpolation(interpolation);
+    if (graph != nullptr)
+        graph->setInterpolation(interpolation);
+    limiterOutL.setTruePeak(renderQuality);
+    limiterOutR.setTruePeak(renderQuality);
+}
+
+void FmEngineCore::applyDiscreteSettings(const Settings& wanted) noexcept
+{
+    if (wanted.range != applied.range)
+    {
+        const float maxDelayMs = rangeToMs(wanted.range);
+        delayL.setMaxDelayMs(maxDelayMs);
+        delayR.setMaxDelayMs(maxDelayMs);
+        if (graph != nullptr)
+            graph->setRange(maxDelayMs);
+    }
+
+    if (wanted.oversamplingFactor != applied.oversamplingFactor)
+    {
+        // Fresh filter state for the oversampler taking over, delays moved to
+        // the new rate; the dip covers both
+        if (wanted.oversamplingFactor > 1)
+            getOversampler(wanted.oversamplingFactor).reset();
+
+        delayL.changeSampleRate(sampleRate * wanted.oversamplingFactor);
+        delayR.changeSampleRate(sampleRate * wanted.oversamplingFactor);
+        if (graph != nullptr)
+            graph->setSampleRate(sampleRate * wanted.oversamplingFactor);
+    }
+
+    if (wanted.operatorAlgorithm != applied.operatorAlgorithm)
+    {
+        // Whichever takes over starts from silence rather than from what it
+        // last held, however long ago that was
+        assert(graph != nullptr); // wanted waits for it
+        graph->setAlgorithm(wanted.operatorAlgorithm);
+        resetDelays();
+    }
+
+    if (wanted.renderQuality != applied.renderQuality)
+        applyRenderQuality(wanted.renderQuality);
+
+    applied.algorithm = wanted.algorithm;
+    applied.range = wanted.range;
+    applied.limiter = wanted.limiter;
+    applied.swap = wanted.swap;
+    applied.oversamplingFactor = wanted.oversamplingFactor;
+    applied.renderQuality = wanted.renderQuality;
+    applied.operatorAlgorithm = wanted.operatorAlgorithm;
+    appliedOversamplingFactor.store(applied.oversamplingFactor, std::memory_order_relaxed);
+
+    if (observer != nullptr)
+        observer->discreteSettingsApplied(applied);
+}
+
+//==============================================================================
+void FmEngineCore::processSubBlock(const float* inL, const float* inR, const float* scL, const float* scR,
+                                   float* outL, float* outR, int numSamples) noexcept
+{
+    assert(numSamples > 0 && numSamples <= maxBlockSize);
+
+    // === PREDELAY STUFF ===
+    // if predelay is enabled, set the basedelay, otherwise basedelay is always set to 0.0f
+    const float newBaseDelay = target.predelay ? (0.5f * delayL.getMaxDelayMs()) : 0.0f;
+    if (newBaseDelay != lastBaseDelay)
+    {
+        delayL.setBaseDelayMs(newBaseDelay);
+        delayR.setBaseDelayMs(newBaseDelay);
+        lastBaseDelay = newBaseDelay;
+    }
+
+    // Discrete settings as last switched; continuous ones straight from the target
+    const int algorithm = applied.algorithm;
+    const bool swap = applied.swap;
+    const bool currentLimiter = applied.limiter;
+    assert(std::isfinite(target.modDepth));
+
+    float* carrierL = scratch[carrierLaneL];
+    float* carrierR = scratch[carrierLaneR];
+    float* modInL = scratch[modulatorLaneL];
+    float* modInR = scratch[modulatorLaneR];
+    float* modOutL = scratch[depthModLaneL];
+    float* modOutR = scratch[depthModLaneR];
+
+    // Each sample is read from modIn before its normalised value replaces it
+    float* normL = modInL;
+    float* normR = modInR;
+
+    // --- Routing. Reads all of the input before anything is written out, so
+    //     the outputs may be the input buffers ---
+    routeBlock(inL, inR, scL, scR, numSamples, algorithm, swap, carrierL, carrierR, modInL, modInR);
+
+    // --- Crossfade: the new settings' share per sample, raised cosine after
+    //     any priming; the old routing mixed out of the lanes ---
+    const float* limiterMix = nullptr;
+
+    if (switchPhase == SwitchPhase::crossfading)
+    {
+        float* switchMix = scratch[switchMixLane];
+        const int elapsed = switchPriming + switchFadeLength - switchFadeRemaining;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float level = std::clamp((float) (elapsed + i + 1 - switchPriming) / (float) switchFadeLength, 0.0f, 1.0f);
+            switchMix[i] = 0.5f * (1.0f - std::cos(level * pi));
+        }
+
+        if (switchFrom.algorithm != algorithm || switchFrom.swap != swap)
+        {
+            float* oldCarrierL = scratch[fadeCarrierLaneL];
+            float* oldCarrierR = scratch[fadeCarrierLaneR];
+            float* oldModL = scratch[fadeModulatorLaneL];
+            float* oldModR = scratch[fadeModulatorLaneR];
+            routeBlock(inL, inR, scL, scR, numSamples, switchFrom.algorithm, switchFrom.swap,
+                       oldCarrierL, oldCarrierR, oldModL, oldModR);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                carrierL[i] = oldCarrierL[i] + switchMix[i] * (carrierL[i] - oldCarrierL[i]);
+                carrierR[i] = oldCarrierR[i] + switchMix[i] * (carrierR[i] - oldCarrierR[i]);
+                modInL[i] = oldModL[i] + switchMix[i] * (modInL[i] - oldModL[i]);
+                modInR[i] = oldModR[i] + switchMix[i] * (modInR[i] - oldModR[i]);
+            }
+        }
+
+        if (switchFrom.limiter != currentLimiter)
+        {
+            float* mix = scratch[limiterMixLane];
+            for (int i = 0; i < numSamples; ++i)
+                mix[i] = currentLimiter ? switchMix[i] : 1.0f - switchMix[i];
+            limiterMix = mix;
+        }
+    }
+
+    // --- PRE-PROCESS MODULATOR: Smoothing, Lowpass, depth ---
+    // process() cuts sub-blocks where ramps end, so this one either ramps
+    // throughout or holds still
+    const bool ramping = smoothedModDepth.isSmoothing() || smoothedCutoff.isSmoothing();
+
+    if (ramping)
+    {
+        float* depthRamp = scratch[depthRampLane];
+        float* cutoffRamp = scratch[cutoffRampLane];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Parameter smoothing
+            const float depth = smoothedModDepth.getNextValue();
+
+            const float smoothedCutoffValue = smoothedCutoff.getNextValue();
+            depthRamp[i] = depth;
+            cutoffRamp[i] = smoothedCutoffValue;
+            modulatorLowPassL.setCutoff(smoothedCutoffValue);
+            modulatorLowPassR.setCutoff(smoothedCutoffValue);
+
+            // Filter first, then depth while the signal is still bipolar
+            const float filteredL = modulatorLowPassL.processSample(sanitize(modInL[i]));
+            const float filteredR = modulatorLowPassR.processSample(sanitize(modInR[i]));
+
+            modOutL[i] = sanitize(filteredL * depth);
+            modOutR[i] = sanitize(filteredR * depth);
+
+            // normalize modulator from bipolar to unipolar
+            normL[i] = (modOutL[i] + 1.0f) * 0.5f;
+            normR[i] = (modOutR[i] + 1.0f) * 0.5f;
+        }
+    }
+    else
+    {
+        // Settled: one cutoff check (a jump lands here without a ramp) and a fixed depth
+        const float depth = smoothedModDepth.getTargetValue();
+        modulatorLowPassL.setCutoff(smoothedCutoff.getTargetValue());
+        modulatorLowPassR.setCutoff(smoothedCutoff.getTargetValue());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            modOutL[i] = sanitize(modulatorLowPassL.processSample(sanitize(modInL[i])) * depth);
+            modOutR[i] = sanitize(modulatorLowPassR.processSample(sanitize(modInR[i])) * depth);
+
+            normL[i] = (modOutL[i] + 1.0f) * 0.5f;
+            normR[i] = (modOutR[i] + 1.0f) * 0.5f;
+        }
+    }
+
+    // --- Delay lines, at the oversampled rate if enabled ---
+    const int oversamplingFactor = applied.oversamplingFactor;
+
+    if (applied.operatorAlgorithm != OperatorGraph::single)
+    {
+        processOperatorGraph(carrierL, carrierR, normL, normR, numSamples, ramping);
+    }
+    else if (oversamplingFactor > 1)
+    {
+        auto& activeOversampler = getOversampler(oversamplingFactor);
+        const float* const carriers[] = { carrierL, carrierR };
+        activeOversampler.processUp(carriers, numSamples);
+
+        float* osCarrierL = activeOversampler.getChannel(0);
+        float* osCarrierR = activeOversampler.getChannel(1);
+        const int osSamples = numSamples * oversamplingFactor;
+
+        for (int i = 0; i < osSamples; ++i)
+        {
+            const int idx = i / oversamplingFactor;
+            const float frac = static_cast<float>(i - idx * oversamplingFactor + 1) / oversamplingFactor;
+
+            // Linear interpolation of the modulator up to the oversampled rate. It looks
+            // back to the previous base-rate sample (carried over from the last block)
+            // instead of ahead, so a block boundary never changes the result.
+            const float prevModL = idx > 0 ? normL[idx - 1] : lastNormalizedModL;
+            const float prevModR = idx > 0 ? normR[idx - 1] : lastNormalizedModR;
+
+            float modL = prevModL + frac * (normL[idx] - prevModL);
+            float modR = prevModR + frac * (normR[idx] - prevModR);
+
+            if (limiterMix != nullptr)
+            {
+                modL += limiterMix[idx] * (sineClipper(modL) - modL);
+                modR += limiterMix[idx] * (sineClipper(modR) - modR);
+            }
+            else if (currentLimiter)
+            {
+                modL = sineClipper(modL);  // tried limiting. trying sine clip again.
+                modR = sineClipper(modR);  // sine clip adds ringing. limiter creates latency issue.
+            }
+
+            osCarrierL[i] = sanitize(delayL.process(osCarrierL[i], modL));
+            osCarrierR[i] = sanitize(delayR.process(osCarrierR[i], modR));
+        }
+
+        float* const downTargets[] = { carrierL, carrierR };
+        activeOversampler.processDown(downTargets, numSamples);
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float modL = normL[i];
+            float modR = normR[i];
+
+            if (limiterMix != nullptr)
+            {
+                modL += limiterMix[i] * (sineClipper(modL) - modL);
+                modR += limiterMix[i] * (sineClipper(modR) - modR);
+            }
+            else if (currentLimiter)
+            {
+                modL = sineClipper(modL);
+                modR = sineClipper(modR);
+            }
+
+            carrierL[i] = sanitize(delayL.process(carrierL[i], modL));
+            carrierR[i] = sanitize(delayR.process(carrierR[i], modR));
+        }
+    }
+
+    lastNormalizedModL = normL[numSamples - 1];
+    lastNormalizedModR = normR[numSamples - 1];
+
+    // --- Output: modulator solo crossfade, HPF, limiter, switch dip ---
+    // The fade advances per sample (only while moving) so block size doesn't change its shape.
+    const float fadeTimeSamples = lpfSoloFadeTimeMs * 0.001f * (float) sampleRate;
+    const float fadeStep = (fadeTimeSamples > 0.0f) ? (1.0f / fadeTimeSamples) : 1.0f;
+    const float targetFade = target.modulatorSolo ? 1.0f : 0.0f;
+    float fadeMix = 0.5f * (1.0f - std::cos(lpfSoloFade * pi));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (lpfSoloFade != targetFade)
+        {
+            lpfSoloFade = (lpfSoloFade < targetFade) ? std::min(targetFade, lpfSoloFade + fadeStep)
+                                                     : std::max(targetFade, lpfSoloFade - fadeStep);
+            fadeMix = 0.5f * (1.0f - std::cos(lpfSoloFade * pi));
+        }
+
+        const float mixL = (1.0f - fadeMix) * carrierL[i] + fadeMix * modOutL[i];
+        const float mixR = (1.0f - fadeMix) * carrierR[i] + fadeMix * modOutR[i];
+
+        // High-pass filter after delay (and after any other processing)
+        float hpL = highPassL.processSample(mixL);
+        float hpR = highPassR.processSample(mixR);
+
+        if (limiterMix != nullptr)
+        {
+            hpL += limiterMix[i] * (limiterOutL.processSample(hpL) - hpL);
+            hpR += limiterMix[i] * (limiterOutR.processSample(hpR) - hpR);
+        }
+        else if (currentLimiter)
+        {
+            hpL = limiterOutL.processSample(hpL);
+            hpR = limiterOutR.processSample(hpR);
+        }
+
+        // Discrete switch dip, raised cosine
+        if ((switchPhase == SwitchPhase::fadingOut || switchPhase == SwitchPhase::fadingIn) && switchFadeRemaining > 0)
+        {
+            --switchFadeRemaining;
+            float level = (float) switchFadeRemaining / (float) switchFadeLength;
+            if (switchPhase == SwitchPhase::fadingIn)
+                level = 1.0f - level;
+
+            const float dipGain = 0.5f * (1.0f - std::cos(level * pi));
+            hpL *= dipGain;
+            hpR *= dipGain;
+
+            if (switchPhase == SwitchPhase::fadingIn && switchFadeRemaining == 0)
+                switchPhase = SwitchPhase::idle;
+        }
+
+        outL[i] = hpL;
+        outR[i] = hpR;
+    }
+
+    // process() ends a slice where the crossfade does
+    if (switchPhase == SwitchPhase::crossfading)
+    {
+        switchFadeRemaining -= numSamples;
+        if (switchFadeRemaining <= 0)
+            switchPhase = SwitchPhase::idle;
+    }
+
+    if (observer == nullptr)
+        return;
+
+    // Delay-time range from the base-rate modulator (the oversampled path only
+    // interpolates between these, and the clipper is monotonic on [0, 1])
+    const auto [minL, maxL] = std::minmax_element(normL, normL + numSamples);
+    const auto [minR, maxR] = std::minmax_element(normR, normR + numSamples);
+    float modMin = std::min(*minL, *minR);
+    float modMax = std::max(*maxL, *maxR);
+
+    if (currentLimiter)
+    {
+        modMin = sineClipper(modMin);
+        modMax = sineClipper(modMax);
+    }
+
+    const float gainReductionDb = currentLimiter ? std::min(limiterOutL.getGainReductionDb(),
+                                                            limiterOutR.getGainReductionDb())
+                                                 : 0.0f;
+
+    // Through the delay's own clamps (minimum delay, the 6-point kernel's
+    // three samples), so the scope shows what actually plays
+    observer->subBlockProcessed(delayL.getDelayMs(modMin), delayL.getDelayMs(modMax),
+                                modOutL, modOutR, numSamples, gainReductionDb);
+}
+
+//==============================================================================
+// The operators all run in the one oversampled region the delay pair would
+// have: the carrier goes up once, through the whole schedule, and down once.
+void FmEngineCore::processOperatorGraph(float* carrierL, float* carrierR, const float* normL, const float* normR,
+                                        int numSamples, bool ramping) noexcept
+{
+    const int oversamplingFactor = applied.oversamplingFactor;
+    const int osSamples = numSamples * oversamplingFactor;
+
+    float* carriers[] = { carrierL, carrierR };
+    const float* norms[] = { normL, normR };
+    const float lastNorms[] = { lastNormalizedModL, lastNormalizedModR };
+
+    if (oversamplingFactor > 1)
+    {
+        auto& activeOversampler = getOversampler(oversamplingFactor);
+        const float* const upSources[] = { carrierL, carrierR };
+        activeOversampler.processUp(upSources, numSamples);
+
+        carriers[0] = activeOversampler.getChannel(0);
+        carriers[1] = activeOversampler.getChannel(1);
+    }
+
+    OperatorGraph::Block block;
+    block.lanes = graphScratch.data();
+    block.numSamples = osSamples;
+    block.depthRamp = ramping ? scratch[depthRampLane] : nullptr;
+    block.cutoffRamp = ramping ? scratch[cutoffRampLane] : nullptr;
+    block.depth = smoothedModDepth.getTargetValue();
+    block.cutoff = smoothedCutoff.getTargetValue();
+    block.oversampling = oversamplingFactor;
+    block.clip = applied.limiter;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float* norm = norms[ch];
+
+        if (oversamplingFactor > 1)
+        {
+            // The same look-back interpolation as the delay pair's
+            float* osMod = graphScratch[graphModulationLane];
+
+            for (int i = 0; i < osSamples; ++i)
+            {
+                const int idx = i / oversamplingFactor;
+                const float frac = static_cast<float>(i - idx * oversamplingFactor + 1) / oversamplingFactor;
+                const float prevMod = idx > 0 ? norm[idx - 1] : lastNorms[ch];
+                osMod[i] = prevMod + frac * (norm[idx] - prevMod);
+            }
+
+            norm = osMod;
+        }
+
+        block.carrier = carriers[ch];
+        block.modulation = norm;
+        block.output = carriers[ch];
+        graph->process(ch, block);
+    }
+
+    if (oversamplingFactor > 1)
+    {
+        float* const downTargets[] = { carrierL, carrierR };
+        getOversampler(oversamplingFactor).processDown(downTargets, numSamples);
+    }
+}
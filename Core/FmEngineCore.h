@@ -0,0 +1,317 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Biquad.h"
+#include "BrickWallLimiter.h"
+#include "HalfBandOversampler.h"
+#include "InterpolatedDelay.h"
+#include "LowPass.h"
+#include "OperatorGraph.h"
+#include "Routing.h"
+
+/**
+ * The whole FM engine, without a plugin around it: routing, the modulator
+ * low-pass and depth smoothing, the two modulated delay lines (or an operator
+ * graph in their place) with their oversampling, the sine clipper and output
+ * limiters, the DC-blocking high pass and the modulator-solo crossfade.
+ *
+ * Plain C++17, no JUCE. FmEngineAudioProcessor wraps one of these; the C API
+ * in fm_engine.h exposes it to everything else.
+ *
+ * Threading: prepare() allocates and belongs to whoever owns the engine.
+ * setSettings() and process() are called from the processing thread;
+ * process() never allocates, locks or makes system calls. The only state
+ * meant to be read from elsewhere is getAppliedOversamplingFactor(), and
+ * prepareOperatorGraph() is the one call meant to be made from elsewhere.
+ */
+class FmEngineCore
+{
+public:
+    // What the engine should run with. Continuous values are followed
+    // (smoothed) straight away; discrete ones switch behind a short crossfade,
+    // or a dip to silence where the engine has to reset state.
+    struct Settings
+    {
+        float modDepth = 0.0f;       // 0..1
+        float lpCutoff = 20000.0f;   // modulator low-pass, Hz
+        int algorithm = 0;           // 0..2, see routeSample()
+        int range = 1;               // 0..3: 1, 10, 100, 500 ms
+        bool limiter = false;
+        bool swap = false;
+        bool predelay = false;       // reports half the range as latency
+        int oversamplingFactor = 1;  // 1, 2 or 4
+        bool renderQuality = false;  // 6-point delay interpolation, true-peak limiter
+        bool modulatorSolo = false;  // crossfades the output to the filtered modulator
+        int operatorAlgorithm = 0;   // OperatorGraph::Algorithm; 0: the single delay pair
+
+        bool sameDiscreteAs(const Settings& other) const noexcept
+        {
+            return algorithm == other.algorithm && range == other.range
+                && limiter == other.limiter && swap == other.swap
+                && oversamplingFactor == other.oversamplingFactor
+                && renderQuality == other.renderQuality
+                && operatorAlgorithm == other.operatorAlgorithm;
+        }
+
+        // Differing from other only where a crossfade can take it (algorithm,
+        // swap, limiter); the rest reset state and dip. The operator graph
+        // clips inside, out of the crossfade's reach, so with operators
+        // running the limiter dips too.
+        bool canCrossfadeFrom(const Settings& other) const noexcept
+        {
+            return range == other.range && oversamplingFactor == other.oversamplingFactor
+                && renderQuality == other.renderQuality
+                && operatorAlgorithm == other.operatorAlgorithm
+                && (limiter == other.limiter || operatorAlgorithm == OperatorGraph::single);
+        }
+    };
+
+    // Called from process(), on the processing thread
+    struct Observer
+    {
+        virtual ~Observer() = default;
+
+        // Once per sub-block. modL/modR: the filtered, depth-scaled modulator
+        virtual void subBlockProcessed(float delayMinMs, float delayMaxMs, const float* modL, const float* modR,
+                                       int numSamples, float gainReductionDb) noexcept
+        {
+            (void) delayMinMs; (void) delayMaxMs; (void) modL; (void) modR; (void) numSamples; (void) gainReductionDb;
+        }
+
+        // Once new discrete settings are in: at the bottom of a switch dip, or
+        // as a crossfade to them starts
+        virtual void discreteSettingsApplied(const Settings& applied) noexcept { (void) applied; }
+    };
+
+    FmEngineCore();
+
+    // The scratch lanes point into the engine's own arena
+    FmEngineCore(const FmEngineCore&) = delete;
+    FmEngineCore& operator=(const FmEngineCore&) = delete;
+
+    /** Allocates everything for blocks of up to maxBlockSize samples and starts
+        on the current settings with no dip pending. The operator graph only
+        if the settings use it, or it was asked for before. */
+    void prepare(double sampleRate, int maxBlockSize);
+
+    /** Allocates the operator graph, if prepare() hasn't, for the processing
+        thread to pick up. Its delays reach the longest range at 4x: about
+        48 bytes per Hz of sample rate, 2.3 MB at 48 kHz. Call it off the
+        processing thread (but not during prepare()) once the operators are
+        wanted; until the graph is in, a change of operators waits and the
+        rest of the settings go ahead without it. */
+    void prepareOperatorGraph();
+
+    /** Back to silence everywhere, on the current settings with no dip and no
+        smoothing ramps pending. No allocation: after prepare(), a reset engine
+        renders exactly like a freshly prepared one that was reset. */
+    void reset() noexcept;
+
+    /** Clears the delay lines / the modulator filters. */
+    void resetDelays() noexcept;
+    void resetModulatorFilters() noexcept;
+
+    void setSettings(const Settings& newSettings) noexcept { target = newSettings; }
+    const Settings& getSettings() const noexcept { return target; }
+    const Settings& getAppliedSettings() const noexcept { return applied; }
+
+    void setObserver(Observer* newObserver) noexcept { observer = newObserver; }
+
+    // Continuous settings that take sample-accurate automation
+    enum class AutomatedParameter { modDepth, lpCutoff };
+
+    /** A point of sample-accurate automation for the next process() call. The
+        parameter ramps linearly from its previous point (or from where it is
+        at the start of the call) to value, arriving sampleOffset samples into
+        the call, and holds after its last point; the target settings follow.
+        A point past the end of the call is reached that many samples after
+        its start, the ramp running on through the calls that follow; points
+        after it are dropped. Points may be added in any order.
+        Without points a new target glides over the usual smoothing time.
+        Returns false, dropping the point, if the parameter has
+        maxAutomationPoints for this call already. */
+    bool addAutomationPoint(AutomatedParameter parameter, int sampleOffset, float value) noexcept;
+
+    static constexpr int maxAutomationPoints = 128;
+
+    /** Processes any number of samples, in prepared-size slices. Any input may
+        be null (silence; a missing right channel follows the left) and the
+        outputs may be the same buffers as the inputs. */
+    void process(const float* inL, const float* inR, const float* scL, const float* scR,
+                 float* outL, float* outR, int numSamples) noexcept;
+
+    /** Latency for the given predelay/range/limiter at an oversampling factor. */
+    int computeLatencySamples(bool predelay, int range, bool limiter, int oversamplingFactor) const noexcept;
+
+    /** Latency of the current settings, with the oversampling actually running. */
+    int getLatencySamples() const noexcept
+    {
+        return computeLatencySamples(target.predelay, target.range, target.limiter, getAppliedOversamplingFactor());
+    }
+
+    /** Samples of preceding input after which the output of the current
+        settings no longer depends on anything earlier (to about -140 dB): the
+        longest delay plus the settling of the modulator low-pass, limiter and
+        DC high-pass. A render that starts this far ahead of the part it keeps
+        matches an uninterrupted one, which is what lets a long file be cut
+        into chunks and rendered in parallel. */
+    int computeWarmupSamples() const noexcept;
+
+    /** Safe from any thread. */
+    int getAppliedOversamplingFactor() const noexcept { return appliedOversamplingFactor.load(std::memory_order_relaxed); }
+
+    double getSampleRate() const noexcept { return sampleRate; }
+    int getMaxBlockSize() const noexcept { return maxBlockSize; }
+
+    /** Deterministic mode: process() runs in a fixed floating-point
+        environment (round to nearest, flush-to-zero, denormals-are-zero)
+        rather than adding FTZ to whatever the calling thread had set. The
+        output is then a function of the settings and the input alone, for
+        any block sizes, thread or host FPU state. */
+    void setDeterministic(bool shouldBeDeterministic) noexcept { deterministic = shouldBeDeterministic; }
+    bool isDeterministic() const noexcept { return deterministic; }
+
+    // Bump whenever a change alters what the engine renders: stored renders
+    // (the batch tool's cache) are keyed on it
+    static constexpr int dspRevision = 5;
+
+    /** dspRevision plus the compiler, target and float model of this build.
+        Two engines with the same id render bit-identically in deterministic mode. */
+    static const char* getBuildId() noexcept;
+
+    static float rangeToMs(int rangeIndex) noexcept;
+
+private:
+    void updateDiscreteSwitch() noexcept;
+    void applyDiscreteSettings(const Settings& wanted) noexcept;
+
+    // Takes over a graph from prepareOperatorGraph(), set up for the applied settings
+    void adoptPreparedGraph() noexcept;
+    void applyRenderQuality(bool renderQuality) noexcept;
+    HalfBandOversampler& getOversampler(int factor) noexcept { return factor > 2 ? renderOversampler : oversampler; }
+
+    static constexpr int maxOversamplingFactor = 4;
+
+    // Starts the ramps to any automation points due at position, and returns
+    // how far the next sub-block may run: to the next point or ramp end
+    int startAutomationRamps(int position, int numSamples) noexcept;
+
+    // At most maxBlockSize samples
+    void processSubBlock(const float* inL, const float* inR, const float* scL, const float* scR,
+                         float* outL, float* outR, int numSamples) noexcept;
+
+    // The graph in place of the delay pair, carriers replaced in place.
+    // ramping: the depth / cutoff lanes hold this sub-block's smoothed values
+    void processOperatorGraph(float* carrierL, float* carrierR, const float* normL, const float* normR,
+                              int numSamples, bool ramping) noexcept;
+
+    // Linear ramp with juce::SmoothedValue's stepping, so the cutoff glides as it
+    // always has. Depth and automation ramps run on it too: a ramp has an end,
+    // so the sub-blocks after it can skip the smoothing altogether.
+    class LinearSmoother
+    {
+    public:
+        void reset(int numSteps) noexcept { stepsToTarget = numSteps; current = targetValue; countdown = 0; }
+        void jumpTo(float value) noexcept { current = targetValue = value; countdown = 0; }
+        void setTargetValue(float newTarget) noexcept;
+        void rampTo(float newTarget, int numSteps) noexcept; // arrives on the numSteps-th getNextValue()
+        float getNextValue() noexcept;
+
+        bool isSmoothing() const noexcept { return countdown > 0; }
+        int getStepsRemaining() const noexcept { return countdown; }
+        float getTargetValue() const noexcept { return targetValue; }
+
+    private:
+        float current = 0.0f, targetValue = 0.0f, step = 0.0f;
+        int countdown = 0, stepsToTarget = 0;
+    };
+
+    Settings target, applied;
+    std::atomic<int> appliedOversamplingFactor { 1 };
+    Observer* observer = nullptr;
+
+    double sampleRate = 0.0;
+    int maxBlockSize = 0;
+    bool deterministic = false;
+
+    // Discrete switch: fade out, switch on the slice boundary, fade back in;
+    // or crossfade from switchFrom, after switchPriming samples of feeding a
+    // limiter coming in
+    enum class SwitchPhase { idle, fadingOut, fadingIn, crossfading };
+    SwitchPhase switchPhase = SwitchPhase::idle;
+    int switchFadeRemaining = 0;
+    int switchFadeLength = 1;
+    int switchPriming = 0;
+    Settings switchFrom;
+    static constexpr float switchFadeTimeMs = 5.0f;
+
+    void startCrossfade(const Settings& wanted) noexcept;
+
+    // Scratch: one allocation, carved in prepare() into 64-byte aligned lanes
+    // of maxBlockSize. Every stage writes its lanes in full before reading
+    // them, so nothing is cleared per block. The modulator lanes hold the
+    // routed modulator, then its normalised form, written over it in place.
+    // While the smoothers ramp, the ramp lanes keep their values for the
+    // operator graph. During a crossfade the fade lanes hold the old routing
+    // and the mix: the new settings' share, and the limited path's.
+    enum ScratchLane { carrierLaneL, carrierLaneR, modulatorLaneL, modulatorLaneR,
+                       depthModLaneL, depthModLaneR, depthRampLane, cutoffRampLane,
+                       fadeCarrierLaneL, fadeCarrierLaneR, fadeModulatorLaneL, fadeModulatorLaneR,
+                       switchMixLane, limiterMixLane, numScratchLanes };
+
+    static constexpr size_t scratchAlignment = 64;
+
+    // The operator graph's lanes follow, at maxOversamplingFactor times the
+    // length: one per operator, then the oversampled modulator. The channels
+    // take turns with them.
+    enum GraphLane { graphModulationLane = OperatorGraph::maxOperators, numGraphLanes };
+
+    std::vector<float> scratchArena;
+    std::array<float*, numScratchLanes> scratch {};
+    std::array<float*, numGraphLanes> graphScratch {};
+
+    // Last normalised modulator sample of the previous sub-block, for the
+    // oversampled interpolation across block boundaries
+    float lastNormalizedModL = 0.5f;
+    float lastNormalizedModR = 0.5f;
+
+    LinearSmoother smoothedModDepth, smoothedCutoff;
+
+    // This call's automation points for one parameter, by offset
+    struct AutomationLane
+    {
+        struct Point { int sampleOffset; float value; };
+
+        std::array<Point, maxAutomationPoints> points {};
+        int numPoints = 0;
+        int nextPoint = 0;  // the first not yet ramped to
+        int rampEnd = 0;    // where the ramp to the previous point arrives
+    };
+
+    AutomationLane modDepthLane, cutoffLane;
+
+    float lastBaseDelay = 0.0f;
+
+    // Modulator solo crossfade; 0 = normal, 1 = fully soloed
+    float lpfSoloFade = 0.0f;
+    static constexpr float lpfSoloFadeTimeMs = 20.0f;
+
+    LowPass modulatorLowPassL, modulatorLowPassR;
+    InterpolatedDelay delayL, delayR;
+
+    // Null until the operators are wanted. prepareOperatorGraph() fills
+    // preparedGraph and sets the handoff to pending; the processing thread
+    // moves it into graph and sets it to adopted.
+    enum GraphHandoff { noGraph, graphPending, graphAdopted };
+    std::unique_ptr<OperatorGraph> graph, preparedGraph;
+    std::atomic<int> graphHandoff { noGraph };
+
+    Biquad highPassL, highPassR;
+    BrickWallLimiter limiterOutL, limiterOutR;
+
+    // 2x for OVERSAMPLING, 4x for the render profile; both prepared so switching never allocates
+    HalfBandOversampler oversampler, renderOversampler;
+};
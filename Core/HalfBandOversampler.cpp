@@ -0,0 +1,151 @@
+#include "HalfBandOversampler.h"
+#include <algorithm>
+#include <cassert>
+
+//==============================================================================
+void HalfBandOversampler::Stage::prepare(int maxInputSamples)
+{
+    const size_t historySize = (size_t) kernel->numTaps - 1;
+    const size_t centrePhase = (size_t) kernel->centrePhase;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        upHistory[(size_t) ch].assign(historySize + (size_t) maxInputSamples, 0.0f);
+        downEven[(size_t) ch].assign(historySize + (size_t) maxInputSamples, 0.0f);
+        downOdd[(size_t) ch].assign(centrePhase + 1 + (size_t) maxInputSamples, 0.0f);
+    }
+}
+
+void HalfBandOversampler::Stage::reset() noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        std::fill(upHistory[(size_t) ch].begin(), upHistory[(size_t) ch].end(), 0.0f);
+        std::fill(downEven[(size_t) ch].begin(), downEven[(size_t) ch].end(), 0.0f);
+        std::fill(downOdd[(size_t) ch].begin(), downOdd[(size_t) ch].end(), 0.0f);
+    }
+}
+
+// The taps are symmetric, so the dot products can run forwards over the history
+void HalfBandOversampler::Stage::up(int channel, const float* in, float* out, int n) noexcept
+{
+    auto& history = upHistory[(size_t) channel];
+    const int numTaps = kernel->numTaps;
+    const int centrePhase = kernel->centrePhase;
+    const int tail = numTaps - 1;
+    assert(tail + n <= (int) history.size());
+
+    std::copy(in, in + n, history.begin() + tail);
+
+    const float* taps = kernel->taps.data();
+    const float* x = history.data();
+
+    for (int p = 0; p < n; ++p)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < numTaps; ++k)
+            sum += taps[k] * x[p + k];
+
+        // Zero-stuffing halves the level; the factor 2 puts it back
+        out[2 * p] = 2.0f * sum;
+        out[2 * p + 1] = x[tail + p - centrePhase];
+    }
+
+    std::copy(history.begin() + n, history.begin() + n + tail, history.begin());
+}
+
+void HalfBandOversampler::Stage::down(int channel, const float* in, float* out, int n) noexcept
+{
+    auto& even = downEven[(size_t) channel];
+    auto& odd = downOdd[(size_t) channel];
+    const int numTaps = kernel->numTaps;
+    const int evenTail = numTaps - 1;
+    const int oddTail = kernel->centrePhase + 1;
+    assert(evenTail + n <= (int) even.size());
+
+    for (int p = 0; p < n; ++p)
+    {
+        even[(size_t) (evenTail + p)] = in[2 * p];
+        odd[(size_t) (oddTail + p)] = in[2 * p + 1];
+    }
+
+    const float* taps = kernel->taps.data();
+    const float* e = even.data();
+    const float* o = odd.data();
+
+    for (int p = 0; p < n; ++p)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < numTaps; ++k)
+            sum += taps[k] * e[p + k];
+
+        out[p] = sum + 0.5f * o[p];
+    }
+
+    std::copy(even.begin() + n, even.begin() + n + evenTail, even.begin());
+    std::copy(odd.begin() + n, odd.begin() + n + oddTail, odd.begin());
+}
+
+//==============================================================================
+void HalfBandOversampler::prepare(int newNumStages, int maxBlockSize)
+{
+    assert(newNumStages >= 1 && newNumStages <= maxStages);
+    numStages = std::clamp(newNumStages, 1, maxStages);
+
+    if (tables == nullptr)
+        tables = DspTables::get();
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[(size_t) s];
+        stage.setKernel(tables->getHalfBandKernel(s));
+        stage.prepare(maxBlockSize << s);
+
+        for (auto& channel : stageOutput[(size_t) s])
+            channel.assign((size_t) (maxBlockSize << (s + 1)), 0.0f);
+    }
+}
+
+void HalfBandOversampler::reset() noexcept
+{
+    for (int s = 0; s < numStages; ++s)
+        stages[(size_t) s].reset();
+}
+
+float HalfBandOversampler::getLatencyInSamples() const noexcept
+{
+    // Up and down filter each delay by the centre tap at the stage's output rate
+    float latency = 0.0f;
+    for (int s = 0; s < numStages; ++s)
+        latency += (float) stages[(size_t) s].getCentre() / (float) (1 << s);
+    return latency;
+}
+
+void HalfBandOversampler::processUp(const float* const* input, int numSamples) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        stages[0].up(ch, input[ch], stageOutput[0][(size_t) ch].data(), numSamples);
+
+        for (int s = 1; s < numStages; ++s)
+            stages[(size_t) s].up(ch, stageOutput[(size_t) s - 1][(size_t) ch].data(),
+                                  stageOutput[(size_t) s][(size_t) ch].data(), numSamples << s);
+    }
+}
+
+float* HalfBandOversampler::getChannel(int channel) noexcept
+{
+    return stageOutput[(size_t) numStages - 1][(size_t) channel].data();
+}
+
+void HalfBandOversampler::processDown(float* const* output, int numSamples) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int s = numStages - 1; s > 0; --s)
+            stages[(size_t) s].down(ch, stageOutput[(size_t) s][(size_t) ch].data(),
+                                    stageOutput[(size_t) s - 1][(size_t) ch].data(), numSamples << s);
+
+        stages[0].down(ch, stageOutput[0][(size_t) ch].data(), output[ch], numSamples);
+    }
+}
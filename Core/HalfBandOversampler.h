@@ -0,0 +1,65 @@
+#pragma once
+#include "DspTables.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+// Stereo 2x/4x oversampler built from linear-phase half-band FIR stages.
+//
+// Each stage doubles the rate with a Kaiser-windowed half-band low-pass run
+// in polyphase form: every other tap of a half-band filter is zero and the
+// centre tap is 0.5, so upsampling costs one short dot product per input
+// sample (the odd output is a plain delayed copy) and downsampling the same.
+// The kernels are the process-wide ones in DspTables. All buffers are sized
+// in prepare(); processing never allocates.
+class HalfBandOversampler
+{
+public:
+    static constexpr int numChannels = 2;
+    static constexpr int maxStages = DspTables::numHalfBandStages;
+
+    // numStages: 1 = 2x, 2 = 4x
+    void prepare(int numStages, int maxBlockSize);
+    void reset() noexcept;
+
+    int getFactor() const noexcept { return 1 << numStages; }
+
+    // Round trip (up then down) delay, in base-rate samples
+    float getLatencyInSamples() const noexcept;
+
+    // Upsamples numSamples (<= maxBlockSize) per channel into the internal
+    // buffer, numSamples * getFactor() long, available from getChannel()
+    void processUp(const float* const* input, int numSamples) noexcept;
+    float* getChannel(int channel) noexcept;
+
+    // Filters the internal buffer back down into numSamples per channel
+    void processDown(float* const* output, int numSamples) noexcept;
+
+private:
+    class Stage
+    {
+    public:
+        void setKernel(const DspTables::HalfBandKernel& newKernel) noexcept { kernel = &newKernel; }
+        void prepare(int maxInputSamples);
+        void reset() noexcept;
+
+        // in: n samples at the lower rate, out: 2n
+        void up(int channel, const float* in, float* out, int n) noexcept;
+        // in: 2n samples at the higher rate, out: n
+        void down(int channel, const float* in, float* out, int n) noexcept;
+
+        int getCentre() const noexcept { return 2 * kernel->centrePhase + 1; }
+
+    private:
+        const DspTables::HalfBandKernel* kernel = nullptr; // shared, owned by the oversampler's tables
+
+        // Per channel: the input history the dot products look back into,
+        // followed by room for one block
+        std::array<std::vector<float>, numChannels> upHistory, downEven, downOdd;
+    };
+
+    std::shared_ptr<const DspTables> tables;
+    std::array<Stage, maxStages> stages;
+    std::array<std::array<std::vector<float>, numChannels>, maxStages> stageOutput;
+    int numStages = 1;
+};
@@ -0,0 +1,214 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+class InterpolatedDelay
+{
+public:
+    // 4-point cubic for tracking; 6-point Lagrange for offline renders
+    enum class Interpolation { cubic, lagrange6 };
+
+    InterpolatedDelay()
+    {
+        constexpr double maxDelaySeconds = 2.0;
+        constexpr double maxSampleRate = 192000.0;
+        constexpr int maxOversampling = 4;
+        const size_t maxBufferSize = static_cast<size_t>(maxDelaySeconds * maxSampleRate * maxOversampling) + 4;
+
+        buffer.resize(maxBufferSize, 0.0f);
+        writePos = 0;
+    }
+
+    // Room for longestDelayMs at up to maxSampleRate (oversampling included)
+    // only, rather than 2 s at 192 kHz x 4; longer delays are cut to what fits
+    InterpolatedDelay(double maxSampleRate, float longestDelayMs)
+    {
+        buffer.resize(static_cast<size_t>(longestDelayMs * 0.001 * maxSampleRate) + 8, 0.0f);
+        writePos = 0;
+    }
+
+    void setMaxDelayMs(float newMaxDelayMs) noexcept
+    {
+        constexpr float maxDelayMsPossible = 2000.0f; 
+        maxDelayMs = std::clamp(newMaxDelayMs, 1.0f, maxDelayMsPossible);
+    }
+
+    void setBaseDelayMs(float newBaseDelayMs) noexcept { baseDelayMs = newBaseDelayMs; }
+    void setMinDelayMs(float newMinDelayMs) noexcept { minDelayMs = newMinDelayMs; }
+
+    float getMaxDelayMs() const noexcept { return maxDelayMs; }
+    float getBaseDelayMs() const noexcept { return baseDelayMs; }
+    float getMinDelayMs() const noexcept { return minDelayMs; }
+
+    void prepare(double newSampleRate, float newMaxDelayMs) noexcept
+    {
+        sampleRate = newSampleRate;
+        setMaxDelayMs(newMaxDelayMs);
+        minDelayMs = std::min(static_cast<float>(1.0 / sampleRate * 1000.0), maxDelayMs - 0.1f);
+        writePos = 0;
+    }
+
+    // Switches the processing rate while running (oversampling factor change).
+    // No allocation; only the history the new rate can reach is cleared, since
+    // samples written at the old rate would play back time-scaled.
+    void changeSampleRate(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        minDelayMs = std::min(static_cast<float>(1.0 / sampleRate * 1000.0), maxDelayMs - 0.1f);
+
+        const int size = static_cast<int>(buffer.size());
+        const int reach = std::min(size, static_cast<int>(maxDelayMs * 0.001 * sampleRate) + 8);
+
+        for (int i = 1; i <= reach; ++i)
+            buffer[static_cast<size_t>((writePos - i + size) % size)] = 0.0f;
+    }
+
+    // The delay process() plays for a modulator value, in samples at the
+    // processing rate, after every clamp it applies
+    double getDelaySamples(float modSignal) const noexcept
+    {
+        // Calculate delay time
+        // float effectiveBaseDelayMs = (baseDelayMs > 0.0f) ? baseDelayMs : 0.5f * maxDelayMs;
+        float effectiveBaseDelayMs = 0.0f;
+
+        float delayMs = effectiveBaseDelayMs + std::clamp(modSignal, 0.0f, 1.0f) * 
+                        (maxDelayMs - effectiveBaseDelayMs);
+        delayMs = std::clamp(delayMs, minDelayMs, maxDelayMs); 
+
+        // Convert to samples. The 6-point kernel reads three samples ahead of
+        // the read position, so it needs at least that much delay to stay
+        // behind the write position.
+        const bool sixPoint = interpolation == Interpolation::lagrange6;
+        return std::clamp(
+            delayMs * sampleRate * 0.001,
+            sixPoint ? 3.0 : 0.0,
+            static_cast<double>(static_cast<int>(buffer.size()) - 6)
+        );
+    }
+
+    // The same, in milliseconds
+    float getDelayMs(float modSignal) const noexcept
+    {
+        return static_cast<float>(getDelaySamples(modSignal) * 1000.0 / sampleRate);
+    }
+
+    void setInterpolation(Interpolation newInterpolation) noexcept { interpolation = newInterpolation; }
+    Interpolation getInterpolation() const noexcept { return interpolation; }
+
+    void reset() noexcept
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        writePos = 0;
+    }
+
+    float process(float input, float modSignal) noexcept
+    {
+        if (!std::isfinite(input)) input = 0.0f;
+        if (!std::isfinite(modSignal)) modSignal = 0.0f;
+        
+        if (buffer.empty() || sampleRate <= 0.0f || buffer.size() < 4)
+            return input;
+
+        // Handle write position
+        if (writePos < 0 || writePos >= static_cast<int>(buffer.size()))
+            writePos = 0;
+
+        // Write to buffer
+        buffer[writePos] = input;
+
+        const int size = static_cast<int>(buffer.size());
+        const bool sixPoint = interpolation == Interpolation::lagrange6;
+        const double delaySamples = getDelaySamples(modSignal);
+
+        // Read position in 32.32 fixed point: the sample index in the top
+        // half, the fraction in the bottom. A float position only has a 1/8
+        // sample grid by the end of a 1.5 M sample buffer; this one is exact
+        // everywhere, so the interpolation does not get noisier with writePos.
+        const uint64_t writeFixed = static_cast<uint64_t>(writePos) << fractionBits;
+        const uint64_t delayFixed = static_cast<uint64_t>(delaySamples * fixedOne);
+        const uint64_t readFixed = writeFixed >= delayFixed
+                                 ? writeFixed - delayFixed
+                                 : writeFixed + (static_cast<uint64_t>(size) << fractionBits) - delayFixed;
+
+        const int idx = static_cast<int>(readFixed >> fractionBits);
+
+        // The top 24 bits of the fraction: exact as a float, and below 1
+        const float frac = static_cast<float>(static_cast<int32_t>((readFixed & fractionMask) >> 8)) * (1.0f / 16777216.0f);
+
+        // Lagrange interpolation. Neighbours are at most three samples away,
+        // so one add or subtract wraps them
+        auto wrap = [size](int i) noexcept { return i < 0 ? i + size : (i >= size ? i - size : i); };
+
+        const float* y = buffer.data();
+        float out = 0.0f;
+
+        if (sixPoint)
+        {
+            out = lagrange6Interp(
+                y[wrap(idx - 2)],
+                y[wrap(idx - 1)],
+                y[idx],
+                y[wrap(idx + 1)],
+                y[wrap(idx + 2)],
+                y[wrap(idx + 3)],
+                frac
+            );
+        }
+        else
+        {
+            out = lagrangeInterp(
+                y[wrap(idx - 1)],
+                y[idx],
+                y[wrap(idx + 1)],
+                y[wrap(idx + 2)],
+                frac
+            );
+        }
+
+        // Advance write pointer
+        if (++writePos == size)
+            writePos = 0;
+
+        return out;
+    }
+
+private:
+    std::vector<float> buffer;
+    int writePos = 0;
+    double sampleRate = 44100.0;
+    float maxDelayMs = 100.0f;
+    float baseDelayMs = 0.0f;
+    float minDelayMs = 0.0f;
+    Interpolation interpolation = Interpolation::cubic;
+
+    static constexpr int fractionBits = 32;
+    static constexpr uint64_t fractionMask = 0xffffffffu;
+    static constexpr double fixedOne = 4294967296.0; // 1 << fractionBits
+
+    static inline float lagrangeInterp(float y0, float y1, float y2, float y3, float frac) noexcept
+    {
+        float c0 = y1;
+        float c1 = 0.5f * (y2 - y0);
+        float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+        return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    }
+
+    // 5th-order Lagrange through points at -2..3, evaluated at frac in [0, 1]
+    static inline float lagrange6Interp(float ym2, float ym1, float y0, float y1, float y2, float y3, float frac) noexcept
+    {
+        const float dp2 = frac + 2.0f, dp1 = frac + 1.0f, d = frac;
+        const float dm1 = frac - 1.0f, dm2 = frac - 2.0f, dm3 = frac - 3.0f;
+
+        const float cm2 = -dp1 * d * dm1 * dm2 * dm3 * (1.0f / 120.0f);
+        const float cm1 =  dp2 * d * dm1 * dm2 * dm3 * (1.0f / 24.0f);
+        const float c0  = -dp2 * dp1 * dm1 * dm2 * dm3 * (1.0f / 12.0f);
+        const float c1  =  dp2 * dp1 * d * dm2 * dm3 * (1.0f / 12.0f);
+        const float c2  = -dp2 * dp1 * d * dm1 * dm3 * (1.0f / 24.0f);
+        const float c3  =  dp2 * dp1 * d * dm1 * dm2 * (1.0f / 120.0f);
+
+        return cm2 * ym2 + cm1 * ym1 + c0 * y0 + c1 * y1 + c2 * y2 + c3 * y3;
+    }
+};
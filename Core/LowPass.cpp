@@ -0,0 +1,69 @@
+#include "LowPass.h"
+#include "FiniteMath.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <cmath>
+
+LowPass::LowPass()
+    : currentCutoff(20000.0f),
+      currentSampleRate(44100.0)
+{
+}
+
+void LowPass::prepare(double sampleRate, int)
+{
+    assert(sampleRate > std::numeric_limits<double>::epsilon());
+    currentSampleRate = sampleRate;
+    currentCutoff = std::clamp(currentCutoff, minCutoff, static_cast<float>(currentSampleRate * maxCutoffRatio));
+    updateCoefficients(); // always, the sample rate may have changed
+    reset();
+}
+
+// Called per sample from processBlock while the cutoff is smoothing, so it must not allocate
+void LowPass::setCutoff(float frequencyHz)
+{
+    const float maxCutoff = static_cast<float>(currentSampleRate * maxCutoffRatio); // Just below Nyquist
+    float safeCutoff = std::clamp(frequencyHz, minCutoff, maxCutoff);
+
+    // Avoid unnecessary coefficient calculation if unchanged
+    if (std::abs(currentCutoff - safeCutoff) <= 0.01f)
+        return;
+
+    currentCutoff = safeCutoff;
+    updateCoefficients();
+}
+
+void LowPass::updateCoefficients()
+{
+    if (currentSampleRate <= std::numeric_limits<double>::epsilon())
+        return;
+
+    const auto coeffs = Biquad::makeLowPass(currentSampleRate, currentCutoff);
+    filter1.setCoefficients(coeffs);
+    filter2.setCoefficients(coeffs);
+    filter3.setCoefficients(coeffs);
+    filter4.setCoefficients(coeffs);
+}
+
+void LowPass::reset()
+{
+    filter1.reset();
+    filter2.reset();
+    filter3.reset();
+    filter4.reset();
+}
+
+float LowPass::processSample(float input)
+{
+    float y = filter1.processSample(input);
+    y = filter2.processSample(y);
+    y = filter3.processSample(y);
+    y = filter4.processSample(y);
+
+    // Sanitize output to avoid NaN/Inf propagation
+    if (!std::isfinite(y))
+        y = 0.0f;
+
+    return y;
+}
@@ -1,20 +1,10 @@
 #pragma once
 
-#if __has_include("JuceHeader.h")
-// Projucer build
-#include "JuceHeader.h"
-#else
-// CMake build: include only the modules you need
-#include <juce_audio_processors/juce_audio_processors.h>
-#include <juce_gui_basics/juce_gui_basics.h>
-#include <juce_dsp/juce_dsp.h>
-// ... add more as needed
-// #include "BinaryData.h" // Only if you use binary data in this file
-#endif
-
 #include <limits>
 #include <cmath>
 
+#include "Biquad.h"
+
 // 8-pole (48 dB/octave) low-pass filter using four cascaded biquads
 class LowPass
 {
@@ -26,9 +16,13 @@ public:
     void reset();
     float processSample(float input);
 
+    static constexpr float getMinCutoff() noexcept { return minCutoff; }
+
 private:
-    juce::dsp::IIR::Filter<float> filter1, filter2, filter3, filter4, filter5, filter6; // 8-pole filter (cascade)
-    juce::dsp::IIR::Coefficients<float>::Ptr coeffs;
+    // Writes the current cutoff into the filters' coefficients (no allocation)
+    void updateCoefficients();
+
+    Biquad filter1, filter2, filter3, filter4; // 8-pole filter (cascade)
     float currentCutoff = 20000.0f; // Default to a safe, typical value
     double currentSampleRate = 44100.0;
 
@@ -0,0 +1,275 @@
+#include "OperatorGraph.h"
+#include "FiniteMath.h"
+#include "SineClipper.h"
+#include <algorithm>
+#include <cassert>
+
+//==============================================================================
+const OperatorGraph::AlgorithmSpec& OperatorGraph::getSpec(int algorithm) noexcept
+{
+    // Operators are numbered as on a DX: 1 is the one you hear. Per operator:
+    // audio from, modulation from, feedback, range scale, output gain
+    static const AlgorithmSpec specs[numAlgorithms] =
+    {
+        // single: no graph
+        {},
+
+        // cascade: carrier -> 3 -> 2 -> 1, each on the modulator. Three
+        // engines in a row, with one oversampling pass instead of three
+        {{ { 1, external, 0.0f, 1.0f, 1.0f },
+           { 2, external, 0.0f, 1.0f, 0.0f },
+           { external, external, 0.0f, 1.0f, 0.0f } }},
+
+        // stack: the modulator drives 3, 3 drives 2, 2 drives 1; each one
+        // delays the carrier
+        {{ { external, 1, 0.0f, 1.0f, 1.0f },
+           { external, 2, 0.0f, 1.0f, 0.0f },
+           { external, external, 0.0f, 1.0f, 0.0f } }},
+
+        // parallel: three carriers on the one modulator, at full, half and
+        // quarter range, mixed
+        {{ { external, external, 0.0f, 1.0f, 1.0f / 3.0f },
+           { external, external, 0.0f, 0.5f, 1.0f / 3.0f },
+           { external, external, 0.0f, 0.25f, 1.0f / 3.0f } }},
+
+        // feedback: 2 on the modulator and its own output, driving 1
+        {{ { external, 1, 0.0f, 1.0f, 1.0f },
+           { external, external, 0.7f, 1.0f, 0.0f },
+           {} }},
+    };
+
+    return specs[std::clamp(algorithm, 0, numAlgorithms - 1)];
+}
+
+const char* OperatorGraph::getAlgorithmName(int algorithm) noexcept
+{
+    static constexpr const char* names[numAlgorithms] = { "Single", "Cascade", "Stack", "Parallel", "Feedback" };
+    return names[std::clamp(algorithm, 0, numAlgorithms - 1)];
+}
+
+std::array<bool, OperatorGraph::maxOperators> OperatorGraph::findUsed(const AlgorithmSpec& spec) noexcept
+{
+    std::array<bool, maxOperators> used {};
+    for (int op = 0; op < maxOperators; ++op)
+        used[(size_t) op] = spec[(size_t) op].outputGain != 0.0f;
+
+    // A chain is at most maxOperators long
+    for (int pass = 1; pass < maxOperators; ++pass)
+    {
+        for (int op = 0; op < maxOperators; ++op)
+        {
+            if (!used[(size_t) op])
+                continue;
+
+            for (const int source : { spec[(size_t) op].audioFrom, spec[(size_t) op].modulationFrom })
+                if (source != external)
+                    used[(size_t) source] = true;
+        }
+    }
+
+    return used;
+}
+
+float OperatorGraph::getReach(int algorithm) noexcept
+{
+    if (algorithm <= single)
+        return 1.0f;
+
+    // Any path back through the graph passes each operator at most once
+    const auto& spec = getSpec(algorithm);
+    const auto used = findUsed(spec);
+
+    float reach = 0.0f;
+    for (int op = 0; op < maxOperators; ++op)
+        if (used[(size_t) op])
+            reach += spec[(size_t) op].rangeScale;
+
+    return reach;
+}
+
+int OperatorGraph::getNumFilterStages(int algorithm) noexcept
+{
+    if (algorithm <= single)
+        return 0;
+
+    const auto& spec = getSpec(algorithm);
+    const auto used = findUsed(spec);
+
+    int stages = 0;
+    for (int op = 0; op < maxOperators; ++op)
+        if (used[(size_t) op] && (spec[(size_t) op].modulationFrom != external || spec[(size_t) op].feedback != 0.0f))
+            ++stages;
+
+    return stages;
+}
+
+//==============================================================================
+void OperatorGraph::prepare(double sampleRate, int maxOversampling, float maxRangeMs)
+{
+    for (auto& channel : operators)
+    {
+        for (auto& op : channel)
+        {
+            op.delay = InterpolatedDelay(sampleRate * maxOversampling, maxRangeMs);
+            op.delay.prepare(sampleRate, maxRangeMs);
+            op.filter.prepare(sampleRate, 0);
+            op.lastOutput = 0.0f;
+        }
+    }
+
+    applyRanges();
+}
+
+void OperatorGraph::reset() noexcept
+{
+    for (auto& channel : operators)
+    {
+        for (auto& op : channel)
+        {
+            op.delay.reset();
+            op.filter.reset();
+            op.lastOutput = 0.0f;
+        }
+    }
+}
+
+void OperatorGraph::setAlgorithm(int newAlgorithm) noexcept
+{
+    algorithm = std::clamp(newAlgorithm, (int) single, numAlgorithms - 1);
+    numSteps = 0;
+    numOutputs = 0;
+
+    if (algorithm == single)
+        return;
+
+    const auto& spec = getSpec(algorithm);
+    const auto used = findUsed(spec);
+    std::array<bool, maxOperators> scheduled {};
+
+    auto ready = [&scheduled](int source) { return source == external || scheduled[(size_t) source]; };
+
+    // Dependency order. Feedback reads the operator's own previous output,
+    // so it is not an edge; the wiring is otherwise acyclic and this finishes
+    for (bool progress = true; progress;)
+    {
+        progress = false;
+
+        for (int op = 0; op < maxOperators; ++op)
+        {
+            const auto& operatorSpec = spec[(size_t) op];
+
+            if (used[(size_t) op] && !scheduled[(size_t) op]
+                && ready(operatorSpec.audioFrom) && ready(operatorSpec.modulationFrom))
+            {
+                schedule[(size_t) numSteps++] = { op, operatorSpec.audioFrom, operatorSpec.modulationFrom, operatorSpec.feedback };
+                scheduled[(size_t) op] = true;
+                progress = true;
+            }
+        }
+    }
+
+    assert(std::equal(used.begin(), used.end(), scheduled.begin()));
+
+    for (int op = 0; op < maxOperators; ++op)
+    {
+        if (spec[(size_t) op].outputGain != 0.0f)
+        {
+            outputs[(size_t) numOutputs] = op;
+            outputGains[(size_t) numOutputs++] = spec[(size_t) op].outputGain;
+        }
+    }
+
+    applyRanges();
+}
+
+void OperatorGraph::setSampleRate(double processingRate) noexcept
+{
+    for (auto& channel : operators)
+    {
+        for (auto& op : channel)
+        {
+            op.delay.changeSampleRate(processingRate);
+            op.filter.prepare(processingRate, 0);
+        }
+    }
+}
+
+void OperatorGraph::setRange(float newRangeMs) noexcept
+{
+    rangeMs = newRangeMs;
+    applyRanges();
+}
+
+void OperatorGraph::applyRanges() noexcept
+{
+    const auto& spec = getSpec(algorithm);
+
+    for (auto& channel : operators)
+        for (int op = 0; op < maxOperators; ++op)
+            channel[(size_t) op].delay.setMaxDelayMs(rangeMs * spec[(size_t) op].rangeScale);
+}
+
+void OperatorGraph::setInterpolation(InterpolatedDelay::Interpolation interpolation) noexcept
+{
+    for (auto& channel : operators)
+        for (auto& op : channel)
+            op.delay.setInterpolation(interpolation);
+}
+
+//==============================================================================
+void OperatorGraph::process(int channel, const Block& block) noexcept
+{
+    const int n = block.numSamples;
+    const int factor = block.oversampling;
+    assert(n > 0 && numSteps > 0 && factor > 0);
+
+    for (int s = 0; s < numSteps; ++s)
+    {
+        const auto& step = schedule[(size_t) s];
+        auto& op = operators[(size_t) channel][(size_t) step.op];
+
+        const float* audio = step.audioFrom == external ? block.carrier : block.lanes[step.audioFrom];
+        const float* drive = step.modulationFrom == external ? nullptr : block.lanes[step.modulationFrom];
+        float* out = block.lanes[step.op];
+
+        // Steered by another operator or itself: filtered and depth-scaled,
+        // as the engine treats its modulator, around the resting 0.5
+        const bool filtered = drive != nullptr || step.feedback != 0.0f;
+        if (filtered && block.cutoffRamp == nullptr)
+            op.filter.setCutoff(block.cutoff);
+
+        float last = op.lastOutput;
+
+        for (int i = 0; i < n; ++i)
+        {
+            float modulation = drive == nullptr ? block.modulation[i] : 0.5f;
+
+            if (filtered)
+            {
+                if (block.cutoffRamp != nullptr)
+                    op.filter.setCutoff(block.cutoffRamp[i / factor]);
+
+                const float depth = block.depthRamp != nullptr ? block.depthRamp[i / factor] : block.depth;
+                const float x = (drive != nullptr ? drive[i] : 0.0f) + step.feedback * last;
+                modulation += 0.5f * depth * op.filter.processSample(x);
+            }
+
+            if (block.clip)
+                modulation = sineClipper(modulation);
+
+            last = op.delay.process(audio[i], modulation);
+            out[i] = last;
+        }
+
+        op.lastOutput = last;
+    }
+
+    // After every step, so the output may be the carrier
+    for (int i = 0; i < n; ++i)
+    {
+        float sum = 0.0f;
+        for (int o = 0; o < numOutputs; ++o)
+            sum += outputGains[(size_t) o] * block.lanes[outputs[(size_t) o]][i];
+        block.output[i] = sum;
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+
+#include "InterpolatedDelay.h"
+#include "LowPass.h"
+
+// Several FM operators in one engine, instead of several engines in a chain.
+//
+// An operator is a modulated delay with its own low-pass: it delays the
+// carrier, or another operator's output, by an amount steered by the engine's
+// modulator or by another operator's output (filtered, depth-scaled), plus
+// optionally its own last output (feedback). The algorithms wire three of
+// them the way DX patches do: stacks, parallel carriers, feedback.
+//
+// setAlgorithm() compiles the wiring into a flat schedule, operators in
+// dependency order, so process() is straight loops over whole blocks. The
+// engine runs the graph where its single delay pair would be, inside its one
+// oversampled region: the carrier goes up once and comes down once, however
+// many operators there are.
+//
+// prepare() allocates; everything else is real-time safe.
+class OperatorGraph
+{
+public:
+    static constexpr int maxOperators = 3;
+    static constexpr int numChannels = 2;
+
+    // single: the engine's own delay pair, no graph
+    enum Algorithm { single = 0, cascade, stack, parallel, feedback, numAlgorithms };
+
+    static const char* getAlgorithmName(int algorithm) noexcept;
+
+    /** Allocates delays reaching maxRangeMs at sampleRate x maxOversampling. */
+    void prepare(double sampleRate, int maxOversampling, float maxRangeMs);
+    void reset() noexcept;
+
+    /** Compiles the algorithm into the schedule; state carries over, so call
+        reset() too unless the caller fades around the change. */
+    void setAlgorithm(int algorithm) noexcept;
+    int getAlgorithm() const noexcept { return algorithm; }
+
+    /** Rate the graph runs at (the oversampled one). Clears the operator
+        low-passes and the delay history the new rate can reach. */
+    void setSampleRate(double processingRate) noexcept;
+    void setRange(float rangeMs) noexcept;
+    void setInterpolation(InterpolatedDelay::Interpolation interpolation) noexcept;
+
+    /** For the engine's warm-up: the longest delay a render can reach back
+        through, in multiples of the range, and the low-passes settling on
+        the way. */
+    static float getReach(int algorithm) noexcept;
+    static int getNumFilterStages(int algorithm) noexcept;
+
+    // One channel's block at the processing rate
+    struct Block
+    {
+        const float* carrier = nullptr;
+        const float* modulation = nullptr;      // the engine's normalised modulator, 0..1
+        float* const* lanes = nullptr;          // maxOperators scratch lanes of numSamples
+        float* output = nullptr;                // may be carrier
+        int numSamples = 0;
+
+        // Modulation depth and operator low-pass cutoff: the engine's smoothed
+        // values per base-rate sample, each held for oversampling samples, or
+        // null to hold depth / cutoff throughout. Taking the smoothers' own
+        // values keeps the output independent of how blocks are cut.
+        const float* depthRamp = nullptr;
+        const float* cutoffRamp = nullptr;
+        float depth = 0.0f;
+        float cutoff = 20000.0f;
+        int oversampling = 1;
+
+        bool clip = false;                      // sine-clip each operator's modulation
+    };
+
+    void process(int channel, const Block& block) noexcept;
+
+private:
+    // Where an operator's audio or modulation comes from: another operator,
+    // or outside the graph (the carrier, the engine's modulator)
+    static constexpr int external = -1;
+
+    struct OperatorSpec
+    {
+        int audioFrom = external;
+        int modulationFrom = external;
+        float feedback = 0.0f;      // own last output into the modulation
+        float rangeScale = 1.0f;    // of the engine's range
+        float outputGain = 0.0f;    // into the graph's output
+    };
+
+    using AlgorithmSpec = std::array<OperatorSpec, maxOperators>;
+    static const AlgorithmSpec& getSpec(int algorithm) noexcept;
+
+    // The operators the output depends on, directly or through others
+    static std::array<bool, maxOperators> findUsed(const AlgorithmSpec& spec) noexcept;
+
+    void applyRanges() noexcept;
+
+    struct Step
+    {
+        int op = 0;
+        int audioFrom = external;
+        int modulationFrom = external;
+        float feedback = 0.0f;
+    };
+
+    struct Operator
+    {
+        InterpolatedDelay delay { 0.0, 0.0f }; // sized in prepare()
+        LowPass filter;
+        float lastOutput = 0.0f;
+    };
+
+    int algorithm = single;
+    std::array<Step, maxOperators> schedule {};
+    int numSteps = 0;
+    std::array<int, maxOperators> outputs {};
+    std::array<float, maxOperators> outputGains {};
+    int numOutputs = 0;
+
+    std::array<std::array<Operator, maxOperators>, numChannels> operators;
+    float rangeMs = 10.0f;
+};
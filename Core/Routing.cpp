@@ -0,0 +1,146 @@
+// Routing.cpp
+#include "Routing.h"
+#include "FiniteMath.h"
+#include <algorithm>  // For std::swap
+#include <cmath>      // For std::atan
+#include <utility>
+
+
+// Removed softClip from here as per user's request to move to PluginProcessor.cpp
+
+RoutingOutputs routeSample(float L, float R, float SC_L, float SC_R, int algorithm, int invert)
+{
+    RoutingOutputs output;
+    output.sideChain.left = SC_L;
+    output.sideChain.right = SC_R;
+
+    StereoSample carrier {};
+    StereoSample modulator {};
+
+    switch (algorithm)
+    {
+        case 0:  // algorithm 1: L = carrier, R = modulator (mono)
+            carrier.left = L;
+            carrier.right = L;
+            modulator.left = R; // softClip removed
+            modulator.right = R;
+            break;
+
+        case 1:  // algorithm 2: mono mix of L+R and SC_L+SC_R
+            {
+                float carrierMono = (L + R) * 0.5f;
+                float modulatorMono = (SC_L + SC_R) * 0.5f; // softClip removed
+                carrier.left = carrierMono;
+                carrier.right = carrierMono;
+                modulator.left = modulatorMono;
+                modulator.right = modulatorMono;
+            }
+            break;
+
+        case 2:  // algorithm 3: full stereo
+            carrier.left = L;
+            carrier.right = R;
+            modulator.left = SC_L; // softClip removed
+            modulator.right = SC_R; // softClip removed
+            break;
+
+        default:  // fallback to algo 1
+            carrier.left = L;
+            carrier.right = 0.0f;
+            modulator.left = R; // softClip removed
+            modulator.right = 0.0f;
+            break;
+    }
+
+    if (invert == 1)
+    {
+        // Swap carrier and modulator if invert is active
+        std::swap(carrier.left, modulator.left);
+        std::swap(carrier.right, modulator.right);
+    }
+
+    output.carrier = carrier;
+    output.modulator = modulator;
+
+    return output;
+}
+//==============================================================================
+namespace
+{
+    inline float sanitize(float x) noexcept { return std::isfinite(x) ? x : 0.0f; }
+
+    // One kernel per input layout; what is missing is constant-folded away
+    template <bool hasMain, bool hasSidechain>
+    void routeKernel(const float* L, const float* R, const float* SC_L, const float* SC_R, int numSamples,
+                     int algorithm, float* carrierL, float* carrierR, float* modulatorL, float* modulatorR)
+    {
+        const auto read = [](const float* channel, int i) noexcept { return sanitize(channel[i]); };
+
+        switch (algorithm)
+        {
+            case 0:  // algorithm 1: L = carrier, R = modulator (mono); no sidechain either way
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float l = hasMain ? read(L, i) : 0.0f;
+                    const float r = hasMain ? read(R, i) : 0.0f;
+                    carrierL[i] = carrierR[i] = l;
+                    modulatorL[i] = modulatorR[i] = r;
+                }
+                break;
+
+            case 1:  // algorithm 2: mono mix of L+R and SC_L+SC_R
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float carrierMono = hasMain ? (read(L, i) + read(R, i)) * 0.5f : 0.0f;
+                    const float modulatorMono = hasSidechain ? (read(SC_L, i) + read(SC_R, i)) * 0.5f : 0.0f;
+                    carrierL[i] = carrierR[i] = carrierMono;
+                    modulatorL[i] = modulatorR[i] = modulatorMono;
+                }
+                break;
+
+            case 2:  // algorithm 3: full stereo
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    carrierL[i] = hasMain ? read(L, i) : 0.0f;
+                    carrierR[i] = hasMain ? read(R, i) : 0.0f;
+                    modulatorL[i] = hasSidechain ? read(SC_L, i) : 0.0f;
+                    modulatorR[i] = hasSidechain ? read(SC_R, i) : 0.0f;
+                }
+                break;
+
+            default:  // fallback to algo 1
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    carrierL[i] = hasMain ? read(L, i) : 0.0f;
+                    modulatorL[i] = hasMain ? read(R, i) : 0.0f;
+                    carrierR[i] = modulatorR[i] = 0.0f;
+                }
+                break;
+        }
+    }
+}
+
+void routeBlock(const float* L, const float* R, const float* SC_L, const float* SC_R, int numSamples,
+                int algorithm, bool invert, float* carrierL, float* carrierR, float* modulatorL, float* modulatorR)
+{
+    // Swapping is just writing each lane to the other's buffer
+    if (invert)
+    {
+        std::swap(carrierL, modulatorL);
+        std::swap(carrierR, modulatorR);
+    }
+
+    if (R == nullptr)
+        R = L;
+    if (SC_R == nullptr)
+        SC_R = SC_L;
+
+    if (L != nullptr && SC_L != nullptr)
+        routeKernel<true, true>(L, R, SC_L, SC_R, numSamples, algorithm, carrierL, carrierR, modulatorL, modulatorR);
+    else if (L != nullptr)
+        routeKernel<true, false>(L, R, SC_L, SC_R, numSamples, algorithm, carrierL, carrierR, modulatorL, modulatorR);
+    else if (SC_L != nullptr)
+        routeKernel<false, true>(L, R, SC_L, SC_R, numSamples, algorithm, carrierL, carrierR, modulatorL, modulatorR);
+    else
+        routeKernel<false, false>(L, R, SC_L, SC_R, numSamples, algorithm, carrierL, carrierR, modulatorL, modulatorR);
+}
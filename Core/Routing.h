@@ -26,4 +26,13 @@ struct RoutingOutputs
 //             1 (mono main = carrier, mono SC = modulator)
 //             2 (main stereo = carrier, SC stereo = modulator)
 // - invert: if 1, swaps carrier and modulator
-RoutingOutputs routeSample(float L, float R, float SC_L, float SC_R, int algorithm, int invert);
\ No newline at end of file
+RoutingOutputs routeSample(float L, float R, float SC_L, float SC_R, int algorithm, int invert);
+
+// Routes a block into the carrier and modulator lanes, as routeSample() does
+// sample by sample. Any input may be null: a missing right channel follows
+// the left, and a missing main or sidechain pair is silence. Which inputs
+// exist is settled once per block by picking a kernel, so the per-sample
+// loops never test for them and never read zeros. Inputs are sanitised
+// (NaN/inf to 0) on the way in.
+void routeBlock(const float* L, const float* R, const float* SC_L, const float* SC_R, int numSamples,
+                int algorithm, bool invert, float* carrierL, float* carrierR, float* modulatorL, float* modulatorR);
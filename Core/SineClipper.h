@@ -0,0 +1,10 @@
+#pragma once
+#include <cmath>
+
+// Sine soft clip of the normalised (0..1) delay modulation, applied when the
+// limiter is on
+inline float sineClipper(float x) noexcept
+{
+    x = (float) std::sin(x * (3.14159265358979323846 / 2));
+    return x * 0.6310f; // 0.6310f corresponds to a gain reduction of -4db that this clipper seems to add
+}
@@ -0,0 +1,213 @@
+#include "fm_engine.h"
+#include "FmEngineCore.h"
+#include "FiniteMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+struct fm_engine
+{
+    FmEngineCore core;
+    bool oversampling = false; // remembered while render quality overrides it
+};
+
+namespace
+{
+    // In fm_engine_param order
+    constexpr const char* paramNames[FM_ENGINE_NUM_PARAMS] =
+    {
+        "MOD_DEPTH",
+        "MAX_DELAY_MS",
+        "ALGORITHM",
+        "LIMITER",
+        "SWAP",
+        "OVERSAMPLING",
+        "PREDELAY",
+        "LP_CUTOFF",
+        "RENDER_QUALITY",
+        "MODULATOR_SOLO",
+        "OPERATORS",
+    };
+
+    float getValue(const FmEngineCore::Settings& settings, fm_engine_param param) noexcept
+    {
+        switch (param)
+        {
+            case FM_ENGINE_PARAM_MOD_DEPTH:      return settings.modDepth;
+            case FM_ENGINE_PARAM_MAX_DELAY_MS:   return (float) settings.range;
+            case FM_ENGINE_PARAM_ALGORITHM:      return (float) settings.algorithm;
+            case FM_ENGINE_PARAM_LIMITER:        return settings.limiter ? 1.0f : 0.0f;
+            case FM_ENGINE_PARAM_SWAP:           return settings.swap ? 1.0f : 0.0f;
+            case FM_ENGINE_PARAM_OVERSAMPLING:   return settings.oversamplingFactor == 2 ? 1.0f : 0.0f;
+            case FM_ENGINE_PARAM_PREDELAY:       return settings.predelay ? 1.0f : 0.0f;
+            case FM_ENGINE_PARAM_LP_CUTOFF:      return settings.lpCutoff;
+            case FM_ENGINE_PARAM_RENDER_QUALITY: return settings.renderQuality ? 1.0f : 0.0f;
+            case FM_ENGINE_PARAM_MODULATOR_SOLO: return settings.modulatorSolo ? 1.0f : 0.0f;
+            case FM_ENGINE_PARAM_OPERATORS:      return (float) settings.operatorAlgorithm;
+            case FM_ENGINE_NUM_PARAMS:
+            default:                             return 0.0f;
+        }
+    }
+
+    int toIndex(float value, int maxIndex) noexcept
+    {
+        return std::clamp((int) std::lround(value), 0, maxIndex);
+    }
+}
+
+fm_engine_param fm_engine_param_from_name(const char* name)
+{
+    if (name == nullptr)
+        return FM_ENGINE_NUM_PARAMS;
+
+    for (int i = 0; i < FM_ENGINE_NUM_PARAMS; ++i)
+        if (std::strcmp(name, paramNames[i]) == 0)
+            return (fm_engine_param) i;
+
+    // The plugin's name for the render profile switch
+    if (std::strcmp(name, "OFFLINE_HQ") == 0)
+        return FM_ENGINE_PARAM_RENDER_QUALITY;
+
+    return FM_ENGINE_NUM_PARAMS;
+}
+
+const char* fm_engine_param_name(fm_engine_param param)
+{
+    return param >= 0 && param < FM_ENGINE_NUM_PARAMS ? paramNames[param] : nullptr;
+}
+
+fm_engine* fm_engine_create(void)
+{
+    return new (std::nothrow) fm_engine();
+}
+
+void fm_engine_destroy(fm_engine* engine)
+{
+    delete engine;
+}
+
+int fm_engine_prepare(fm_engine* engine, double sample_rate, int max_block_size)
+{
+    if (engine == nullptr || !(sample_rate > 0.0) || max_block_size <= 0)
+        return -1;
+
+    engine->core.prepare(sample_rate, max_block_size);
+    return 0;
+}
+
+void fm_engine_reset(fm_engine* engine)
+{
+    if (engine == nullptr)
+        return;
+
+    engine->core.reset();
+}
+
+int fm_engine_set_param(fm_engine* engine, fm_engine_param param, float value)
+{
+    if (engine == nullptr || !std::isfinite(value))
+        return -1;
+
+    auto settings = engine->core.getSettings();
+
+    switch (param)
+    {
+        case FM_ENGINE_PARAM_MOD_DEPTH:      settings.modDepth = std::clamp(value, 0.0f, 1.0f); break;
+        case FM_ENGINE_PARAM_MAX_DELAY_MS:   settings.range = toIndex(value, 3); break;
+        case FM_ENGINE_PARAM_ALGORITHM:      settings.algorithm = toIndex(value, 2); break;
+        case FM_ENGINE_PARAM_LIMITER:        settings.limiter = value >= 0.5f; break;
+        case FM_ENGINE_PARAM_SWAP:           settings.swap = value >= 0.5f; break;
+        case FM_ENGINE_PARAM_PREDELAY:       settings.predelay = value >= 0.5f; break;
+        case FM_ENGINE_PARAM_LP_CUTOFF:      settings.lpCutoff = std::clamp(value, 20.0f, 20000.0f); break;
+        case FM_ENGINE_PARAM_MODULATOR_SOLO: settings.modulatorSolo = value >= 0.5f; break;
+        case FM_ENGINE_PARAM_OPERATORS:      settings.operatorAlgorithm = toIndex(value, OperatorGraph::numAlgorithms - 1); break;
+
+        case FM_ENGINE_PARAM_OVERSAMPLING:   engine->oversampling = value >= 0.5f; break;
+        case FM_ENGINE_PARAM_RENDER_QUALITY: settings.renderQuality = value >= 0.5f; break;
+
+        case FM_ENGINE_NUM_PARAMS:
+        default:
+            return -1;
+    }
+
+    // Render quality implies 4x; otherwise OVERSAMPLING picks 1x/2x
+    settings.oversamplingFactor = settings.renderQuality ? 4 : (engine->oversampling ? 2 : 1);
+
+    engine->core.setSettings(settings);
+
+    // A handle is used from one thread, so the graph is allocated right here
+    if (settings.operatorAlgorithm != OperatorGraph::single)
+        engine->core.prepareOperatorGraph();
+
+    return 0;
+}
+
+int fm_engine_automate(fm_engine* engine, fm_engine_param param, int sample_offset, float value)
+{
+    if (engine == nullptr || !std::isfinite(value))
+        return -1;
+
+    bool added = false;
+
+    if (param == FM_ENGINE_PARAM_MOD_DEPTH)
+        added = engine->core.addAutomationPoint(FmEngineCore::AutomatedParameter::modDepth, sample_offset,
+                                                std::clamp(value, 0.0f, 1.0f));
+    else if (param == FM_ENGINE_PARAM_LP_CUTOFF)
+        added = engine->core.addAutomationPoint(FmEngineCore::AutomatedParameter::lpCutoff, sample_offset,
+                                                std::clamp(value, 20.0f, 20000.0f));
+
+    return added ? 0 : -1;
+}
+
+float fm_engine_get_param(const fm_engine* engine, fm_engine_param param)
+{
+    if (engine == nullptr)
+        return 0.0f;
+
+    if (param == FM_ENGINE_PARAM_OVERSAMPLING)
+        return engine->oversampling ? 1.0f : 0.0f;
+
+    return getValue(engine->core.getSettings(), param);
+}
+
+float fm_engine_param_default(fm_engine_param param)
+{
+    return getValue(FmEngineCore::Settings {}, param);
+}
+
+int fm_engine_get_latency(const fm_engine* engine)
+{
+    return engine != nullptr ? engine->core.getLatencySamples() : 0;
+}
+
+int fm_engine_get_warmup(const fm_engine* engine)
+{
+    return engine != nullptr ? engine->core.computeWarmupSamples() : 0;
+}
+
+void fm_engine_set_deterministic(fm_engine* engine, int enabled)
+{
+    if (engine == nullptr)
+        return;
+
+    engine->core.setDeterministic(enabled != 0);
+}
+
+const char* fm_engine_build_id(void)
+{
+    return FmEngineCore::getBuildId();
+}
+
+void fm_engine_process(fm_engine* engine,
+                       const float* in_l, const float* in_r,
+                       const float* sc_l, const float* sc_r,
+                       float* out_l, float* out_r,
+                       int num_samples)
+{
+    if (engine == nullptr || out_l == nullptr || out_r == nullptr)
+        return;
+
+    engine->core.process(in_l, in_r, sc_l, sc_r, out_l, out_r, num_samples);
+}
@@ -0,0 +1,117 @@
+#ifndef FM_ENGINE_H
+#define FM_ENGINE_H
+
+/*
+ * C interface to the FM engine core (libfm_engine_core), for batch renderers,
+ * servers and other hosts that do not want a plugin or JUCE.
+ *
+ *   fm_engine* engine = fm_engine_create();
+ *   fm_engine_set_param(engine, FM_ENGINE_PARAM_MOD_DEPTH, 0.4f);
+ *   fm_engine_prepare(engine, 48000.0, 512);
+ *   fm_engine_process(engine, inL, inR, scL, scR, outL, outR, numSamples);
+ *   fm_engine_destroy(engine);
+ *
+ * A handle is not thread-safe; use one per thread. fm_engine_process never
+ * allocates, so it can run on a real-time thread once prepared.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct fm_engine fm_engine;
+
+/* Values are plain (not normalised), as in the plugin's parameters */
+typedef enum fm_engine_param
+{
+    FM_ENGINE_PARAM_MOD_DEPTH = 0,     /* 0..1 */
+    FM_ENGINE_PARAM_MAX_DELAY_MS,      /* range index 0..3: 1, 10, 100, 500 ms */
+    FM_ENGINE_PARAM_ALGORITHM,         /* 0..2 */
+    FM_ENGINE_PARAM_LIMITER,           /* 0/1 */
+    FM_ENGINE_PARAM_SWAP,              /* 0/1 */
+    FM_ENGINE_PARAM_OVERSAMPLING,      /* 0/1: 2x */
+    FM_ENGINE_PARAM_PREDELAY,          /* 0/1 */
+    FM_ENGINE_PARAM_LP_CUTOFF,         /* 20..20000 Hz */
+    FM_ENGINE_PARAM_RENDER_QUALITY,    /* 0/1: 4x, 6-point interpolation, true-peak limiter */
+    FM_ENGINE_PARAM_MODULATOR_SOLO,    /* 0/1: output the filtered modulator */
+    FM_ENGINE_PARAM_OPERATORS,         /* 0..4: single delay, cascade, stack, parallel, feedback */
+    FM_ENGINE_NUM_PARAMS
+} fm_engine_param;
+
+/* Parameter by its plugin ID ("MOD_DEPTH", "LP_CUTOFF", ...) or the names
+   below without the prefix ("RENDER_QUALITY"). FM_ENGINE_NUM_PARAMS if unknown. */
+fm_engine_param fm_engine_param_from_name(const char* name);
+const char* fm_engine_param_name(fm_engine_param param);
+
+/* What a new engine starts with */
+float fm_engine_param_default(fm_engine_param param);
+
+/* NULL if out of memory */
+fm_engine* fm_engine_create(void);
+void fm_engine_destroy(fm_engine* engine);
+
+/* Allocates for blocks of up to max_block_size; longer blocks are processed
+   in slices. Returns 0 on success, -1 for invalid arguments. */
+int fm_engine_prepare(fm_engine* engine, double sample_rate, int max_block_size);
+
+/* Back to silence, on the current parameters with no fade or smoothing.
+   Renders after a reset do not depend on anything processed before, so one
+   prepared engine can be reused for many files at the same sample rate. */
+void fm_engine_reset(fm_engine* engine);
+
+/* Returns 0 on success, -1 for an unknown parameter. Discrete changes take
+   effect behind a 5 ms crossfade (ALGORITHM, SWAP, and LIMITER while
+   OPERATORS is 0) or a 5 ms fade out and in (the rest). The first OPERATORS
+   above 0 after fm_engine_prepare allocates the operator graph (about 48
+   bytes per Hz of sample rate); set it before preparing, or before going
+   real-time. */
+int fm_engine_set_param(fm_engine* engine, fm_engine_param param, float value);
+float fm_engine_get_param(const fm_engine* engine, fm_engine_param param);
+
+/* Sample-accurate automation of MOD_DEPTH or LP_CUTOFF for the next
+   fm_engine_process call. The parameter ramps linearly from its previous
+   point (or its value at the start of the call) to value, arriving
+   sample_offset samples into the call (negative offsets count as 0), and
+   holds it after its last point. A point past the end of the call is reached
+   that many samples after its start, the ramp running on through the calls
+   that follow; points after it are dropped. Points may be added in any
+   order; between points nothing is smoothed, and segments without a ramp
+   cost no smoothing at all.
+   Returns 0, or -1 for another parameter or a full list (128 points per
+   parameter and call). */
+int fm_engine_automate(fm_engine* engine, fm_engine_param param, int sample_offset, float value);
+
+/* Samples by which the output trails the input with the current settings */
+int fm_engine_get_latency(const fm_engine* engine);
+
+/* Samples of preceding input after which the output with the current
+   settings no longer depends on anything earlier (to about -140 dB). To render
+   part of a long file on its own, reset, feed this much of the audio before it
+   and discard the corresponding output: the result matches a render of the
+   whole file. 0 before prepare. */
+int fm_engine_get_warmup(const fm_engine* engine);
+
+/* Nonzero: processing runs in a fixed floating-point environment (round to
+   nearest, denormals flushed) whatever the calling thread has set, so the
+   output depends on the parameters and the input only. Not on block sizes,
+   max_block_size or which thread runs it. Off by default. */
+void fm_engine_set_deterministic(fm_engine* engine, int enabled);
+
+/* Identifies the DSP revision and the build (compiler, target, float model).
+   Deterministic renders by engines with equal ids are bit-identical, which
+   makes it a key for caching them. */
+const char* fm_engine_build_id(void);
+
+/* Any input may be NULL (silence; a missing right channel follows the left).
+   The outputs may point at the inputs. */
+void fm_engine_process(fm_engine* engine,
+                       const float* in_l, const float* in_r,
+                       const float* sc_l, const float* sc_r,
+                       float* out_l, float* out_r,
+                       int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FM_ENGINE_H */
@@ -0,0 +1,123 @@
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+#include "BinaryState.h"
+#include "FiniteMath.h"
+#include "PresetBank.h"
+
+#include <cmath>
+
+namespace BinaryState
+{
+    ParameterList resolveParameters(juce::AudioProcessorValueTreeState& apvts)
+    {
+        ParameterList parameters {};
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            parameters[(size_t) i] = apvts.getParameter(parameterTable[i]);
+            jassert(parameters[(size_t) i] != nullptr); // table out of step with the layout
+        }
+
+        return parameters;
+    }
+
+    void write(const ParameterList& parameters, const PresetBank& bank, juce::MemoryBlock& destData)
+    {
+        destData.reset();
+        destData.ensureSize((size_t) (headerSize + numParameters * (int) sizeof(float) + 4
+                                      + PresetBank::numSlots * PresetBank::numValues * (int) sizeof(float)));
+
+        // MemoryOutputStream writes little-endian regardless of platform
+        juce::MemoryOutputStream out(destData, false);
+        out.writeInt((int) magic);
+        out.writeShort((short) currentVersion);
+        out.writeShort((short) numParameters);
+
+        for (auto* param : parameters)
+            out.writeFloat(param != nullptr ? param->convertFrom0to1(param->getValue()) : 0.0f);
+
+        out.writeShort((short) PresetBank::numSlots);
+        out.writeShort((short) PresetBank::numValues);
+
+        for (int slot = 0; slot < PresetBank::numSlots; ++slot)
+            for (int i = 0; i < PresetBank::numValues; ++i)
+                out.writeFloat(bank.getValue(slot, i));
+    }
+
+    bool isBinaryState(const void* data, int sizeInBytes) noexcept
+    {
+        return data != nullptr
+            && sizeInBytes >= headerSize
+            && juce::ByteOrder::littleEndianInt(data) == magic;
+    }
+
+    bool read(const ParameterList& parameters, PresetBank& bank, const void* data, int sizeInBytes)
+    {
+        if (!isBinaryState(data, sizeInBytes))
+            return false;
+
+        juce::MemoryInputStream in(data, (size_t) sizeInBytes, false);
+        in.readInt(); // magic, checked above
+        const int version = (juce::uint16) in.readShort();
+        const int numStored = (juce::uint16) in.readShort();
+
+        // Validate the whole chunk before touching anything
+        const int valuesEnd = headerSize + numStored * (int) sizeof(float);
+        if (version < 1 || sizeInBytes < valuesEnd)
+            return false;
+
+        int numSlots = 0, valuesPerSlot = 0;
+        if (version >= 2)
+        {
+            if (sizeInBytes < valuesEnd + 4)
+                return false;
+
+            const auto* bankHeader = static_cast<const char*>(data) + valuesEnd;
+            numSlots = juce::ByteOrder::littleEndianShort(bankHeader);
+            valuesPerSlot = juce::ByteOrder::littleEndianShort(bankHeader + 2);
+
+            // Untrusted counts: bounded before they are multiplied, and in 64 bits
+            if (numSlots > maxStoredSlots || valuesPerSlot > maxStoredValuesPerSlot)
+                return false;
+
+            const auto bankBytes = (juce::int64) numSlots * valuesPerSlot * (juce::int64) sizeof(float);
+            if ((juce::int64) sizeInBytes < valuesEnd + 4 + bankBytes)
+                return false;
+        }
+
+        // Newer versions only append, so their leading values still line up
+        for (int i = 0; i < juce::jmax(numParameters, numStored); ++i)
+        {
+            const float value = i < numStored ? in.readFloat() : 0.0f;
+
+            if (i >= numParameters || parameters[(size_t) i] == nullptr)
+                continue;
+
+            auto* param = parameters[(size_t) i];
+            const float normalised = (i < numStored && std::isfinite(value)) ? param->convertTo0to1(value)
+                                                                              : param->getDefaultValue();
+            param->setValueNotifyingHost(normalised);
+        }
+
+        // Morph bank (version 2+); older chunks get a default bank
+        bank.resetToDefaults(parameters);
+        if (version >= 2)
+            in.skipNextBytes(4); // slot count and values per slot, read above
+
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            for (int i = 0; i < valuesPerSlot; ++i)
+            {
+                const float value = in.readFloat();
+                if (slot < PresetBank::numSlots && i < PresetBank::numValues && std::isfinite(value))
+                    bank.setValue(slot, i, value);
+            }
+        }
+
+        return true;
+    }
+}
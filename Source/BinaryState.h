@@ -0,0 +1,89 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+#include <array>
+
+class PresetBank;
+
+/**
+ * Compact plugin state: an 8-byte header followed by one little-endian float
+ * per parameter, in the fixed order of parameterTable.
+ *
+ *   bytes 0-3   magic "FMEs"
+ *   bytes 4-5   format version
+ *   bytes 6-7   number of parameter values that follow
+ *   bytes 8-    plain (not normalised) parameter values
+ *
+ * From version 2 the values are followed by the morph preset bank:
+ *
+ *   uint16 slot count, uint16 values per slot, then slot-major plain values
+ *
+ * Values are stored in their plain range so a later change to a parameter's
+ * normalisation does not change what a saved project means. The table is
+ * append-only: new parameters go at the end and bump the version; a reader
+ * takes the values it knows and leaves the rest at their defaults.
+ *
+ * No XmlElement or ValueTree is built on either side. Anything that does not
+ * start with the magic is handed back to the caller to parse as legacy XML.
+ */
+namespace BinaryState
+{
+    constexpr juce::uint32 magic = 0x73454d46; // "FMEs" read as little-endian
+    constexpr juce::uint16 currentVersion = 4;
+    constexpr int headerSize = 8;
+
+    // Chunks claiming a bigger bank than this are rejected as malformed;
+    // far above anything a version of the plugin will write
+    constexpr int maxStoredSlots = 256;
+    constexpr int maxStoredValuesPerSlot = 256;
+
+    // Order is part of the format. Append only.
+    constexpr const char* parameterTable[] =
+    {
+        "MOD_DEPTH",
+        "MAX_DELAY_MS",
+        "ALGORITHM",
+        "LIMITER",
+        "SWAP",
+        "OVERSAMPLING",
+        "PREDELAY",
+        "LP_CUTOFF",
+        // version 2
+        "MORPH_ON",
+        "MORPH",
+        "MORPH_A",
+        "MORPH_B",
+        // version 3
+        "OFFLINE_HQ",
+        // version 4
+        "OPERATORS",
+    };
+
+    constexpr int numParameters = (int) (sizeof(parameterTable) / sizeof(parameterTable[0]));
+
+    // The version 1 entries: everything a preset snapshot captures
+    constexpr int numSnapshotParameters = 8;
+
+    using ParameterList = std::array<juce::RangedAudioParameter*, (size_t) numParameters>;
+
+    /** Looks up the table's parameters once, for write() and read(). */
+    ParameterList resolveParameters(juce::AudioProcessorValueTreeState& apvts);
+
+    /** Replaces destData with the binary state of the given parameters and bank. */
+    void write(const ParameterList& parameters, const PresetBank& bank, juce::MemoryBlock& destData);
+
+    /** True if data starts with the binary-state magic. */
+    bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+
+    /** Applies a binary state to the parameters and bank (reset to defaults if
+        the chunk predates it). Returns false (and changes nothing) if the data
+        is not a well-formed binary state. */
+    bool read(const ParameterList& parameters, PresetBank& bank, const void* data, int sizeInBytes);
+}
@@ -8,6 +8,8 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #endif
 
+#include "EditorResources.h"
+
 class CustomCutoffSlider : public juce::Slider
 {
 public:
@@ -63,10 +65,7 @@ public:
 
         // Draw "LPF" label centered on knob
         g.setColour(juce::Colour(170, 170, 170));
-        g.setFont(juce::Font(juce::FontOptions()
-            .withName("Arial")
-            .withHeight(13.0f)
-            .withStyle("Bold")));
+        g.setFont(resources->getSliderFont());
         g.drawText("LPF",
                    juce::Rectangle<int>((int)knobX, (int)knobY, (int)knobWidth, (int)knobHeight),
                    juce::Justification::centred, false);
@@ -136,6 +135,8 @@ public:
 
 private:
 
+    juce::SharedResourcePointer<EditorResources> resources;
+
     static constexpr double minCutoff = 20.0;
     static constexpr double maxCutoff = 20000.0;
     bool draggingKnob = false;
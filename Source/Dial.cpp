@@ -140,26 +140,30 @@ void Dial::draw(juce::Graphics &g, const juce::Point<float> &center, float radiu
     g.drawEllipse(center.x - radius, center.y - radius, 2.0f * radius,
                   2.0f * radius, 2.0f);
 
-    // Draw the pointer
+    // The pointer only depends on the radius; rebuild it pointing along +x
+    // when that changes and rotate it into place on every paint
+    if (radius != pointerPathRadius)
+    {
+        pointerPathRadius = radius;
+        pointerPath = makePointerPath(radius);
+    }
+
+    g.setColour(juce::Colour::fromRGB(160, 160, 160)); // "white"
+    g.fillPath(pointerPath, juce::AffineTransform::rotation(angle).translated(center));
+}
+
+juce::Path Dial::makePointerPath(float radius)
+{
+    // Triangle at angle 0 around the origin: tip on the pointer radius, base
+    // pulled back towards the centre
     float pointerLength = radius - 5.0f;
     float triangleSize = 20.0f;
-    juce::Point<float> tip =
-        center + juce::Point<float>(std::cos(angle) * pointerLength,
-                                    std::sin(angle) * pointerLength);
-    juce::Point<float> perpVec =
-        juce::Point<float>(-std::sin(angle), std::cos(angle)) *
-        (triangleSize / (2.0f * std::sqrt(3.0f))) * 2.0f;
-    juce::Point<float> direction = center - tip;
-    float length =
-        std::sqrt(direction.x * direction.x + direction.y * direction.y);
-    juce::Point<float> baseCenter =
-        tip + direction / length * (triangleSize / std::sqrt(3.0f));
-    juce::Point<float> base1 = baseCenter - perpVec * 0.5f;
-    juce::Point<float> base2 = baseCenter + perpVec * 0.5f;
+    float halfBase = triangleSize / (2.0f * std::sqrt(3.0f));
+    float baseX = pointerLength - triangleSize / std::sqrt(3.0f);
+
     juce::Path triangle;
-    triangle.addTriangle(tip, base1, base2);
-    g.setColour(juce::Colour::fromRGB(160, 160, 160)); // "white"
-    g.fillPath(triangle);
+    triangle.addTriangle({ pointerLength, 0.0f }, { baseX, -halfBase }, { baseX, halfBase });
+    return triangle;
 }
 
 // void Dial::draw(juce::Graphics &g, const juce::Point<float> &center, float radius)
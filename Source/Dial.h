@@ -85,4 +85,9 @@ private:
 
     int id;
     juce::String label;
+
+    // Pointer triangle cached at angle 0; see draw()
+    static juce::Path makePointerPath(float radius);
+    juce::Path pointerPath;
+    float pointerPathRadius = -1.0f;
 };
@@ -0,0 +1,70 @@
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "BinaryData.h"
+#endif
+
+#include "EditorResources.h"
+
+//==============================================================================
+class EditorResources::Loader : public juce::Thread
+{
+public:
+    explicit Loader(EditorResources& ownerIn) : juce::Thread("Editor resources"), owner(ownerIn) {}
+
+    void run() override { owner.load(); }
+
+private:
+    EditorResources& owner;
+};
+
+//==============================================================================
+EditorResources::EditorResources()
+    : loader(std::make_unique<Loader>(*this))
+{
+    loader->startThread(juce::Thread::Priority::low);
+}
+
+EditorResources::~EditorResources()
+{
+    // Decoding is short and not interruptible; just let it finish
+    loader->stopThread(5000);
+}
+
+bool EditorResources::waitUntilLoaded(int timeoutMs) const
+{
+    return loadedEvent.wait(static_cast<double>(timeoutMs));
+}
+
+void EditorResources::load()
+{
+    // Decoded straight into software images: no per-editor conversion, and
+    // other background threads (the knob filmstrip) can read the pixels
+    auto decode = [](const void* data, int size)
+    {
+        auto image = juce::ImageFileFormat::loadFrom(data, static_cast<size_t>(size));
+        if (image.isValid())
+            image = juce::SoftwareImageType().convert(image);
+        return image;
+    };
+
+    backgroundImage = decode(BinaryData::background_png, BinaryData::background_pngSize);
+    knobImage = decode(BinaryData::knob_png, BinaryData::knob_pngSize);
+
+    jassert(backgroundImage.isValid() && knobImage.isValid());
+
+    // Resolve the typefaces now so the first paint does not do the lookup.
+    // On fonts of the loader's own: the editor may be reading the
+    // placeholders meanwhile
+    auto fonts = std::make_unique<Fonts>();
+    for (auto* font : { &fonts->title, &fonts->label, &fonts->slider, &fonts->info })
+        font->getTypefacePtr();
+
+    loadedFonts = std::move(fonts);
+
+    loaded.store(true, std::memory_order_release);
+    loadedEvent.signal();
+    sendChangeMessage(); // async, delivered on the message thread
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "BinaryData.h"
+#endif
+
+/**
+ * Images and fonts the editor needs, decoded once per process.
+ *
+ * Hold it through juce::SharedResourcePointer<EditorResources>. The first
+ * holder starts a background thread that decodes the PNGs and resolves the
+ * typefaces; nothing blocks the message thread. The processor holds one from
+ * construction, so by the time an editor opens the work is normally done and
+ * the editor only takes references.
+ *
+ * Until isLoaded() returns true the image getters return invalid images and
+ * the editor draws placeholders; a change message goes out once loading
+ * finishes. Fonts are usable immediately: until then the getters hand out a
+ * set the loader never touches, and afterwards the set it resolved on its
+ * own thread, published with the loaded flag.
+ */
+class EditorResources : public juce::ChangeBroadcaster
+{
+public:
+    EditorResources();
+    ~EditorResources() override;
+
+    bool isLoaded() const noexcept { return loaded.load(std::memory_order_acquire); }
+
+    /** Blocks the calling thread until loading finishes. Not for the message thread. */
+    bool waitUntilLoaded(int timeoutMs) const;
+
+    // Software images, safe to read from any thread once loaded
+    juce::Image getBackgroundImage() const { return isLoaded() ? backgroundImage : juce::Image(); }
+    juce::Image getKnobImage() const      { return isLoaded() ? knobImage : juce::Image(); }
+
+    const juce::Font& getTitleFont() const noexcept  { return getFonts().title; }   // Arial 26 bold
+    const juce::Font& getLabelFont() const noexcept  { return getFonts().label; }   // Arial 14 bold
+    const juce::Font& getSliderFont() const noexcept { return getFonts().slider; }  // Arial 13 bold
+    const juce::Font& getInfoFont() const noexcept   { return getFonts().info; }    // DejaVu Sans Mono 16
+
+private:
+    class Loader;
+
+    // Font copies share their typeface cache, so each set is built from the
+    // options rather than copied from the other
+    struct Fonts
+    {
+        juce::Font title { juce::FontOptions("Arial", 26.0f, juce::Font::bold) };
+        juce::Font label { juce::FontOptions("Arial", 14.0f, juce::Font::bold) };
+        juce::Font slider { juce::FontOptions("Arial", 13.0f, juce::Font::bold) };
+        juce::Font info { juce::FontOptions("DejaVu Sans Mono", 16.0f, juce::Font::plain) };
+    };
+
+    void load();
+    const Fonts& getFonts() const noexcept { return isLoaded() ? *loadedFonts : placeholderFonts; }
+
+    juce::Image backgroundImage, knobImage;
+
+    Fonts placeholderFonts;               // message thread only
+    std::unique_ptr<Fonts> loadedFonts;   // written by the loader before loaded is set
+
+    std::atomic<bool> loaded { false };
+    juce::WaitableEvent loadedEvent { true };
+    std::unique_ptr<Loader> loader;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditorResources)
+};
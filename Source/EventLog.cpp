@@ -0,0 +1,188 @@
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+#include "EventLog.h"
+
+namespace
+{
+    std::atomic<int> nextInstanceId { 1 };
+
+    constexpr int drainIntervalMs = 250;
+    constexpr juce::int64 maxLogFileBytes = 1 << 20; // then rolled over to events.old.log
+}
+
+//==============================================================================
+EventLog::EventLog()
+    : instanceId(nextInstanceId.fetch_add(1))
+{
+    writer->add(*this);
+}
+
+EventLog::~EventLog()
+{
+    writer->remove(*this);
+}
+
+juce::String EventLog::describe(const Record& record)
+{
+    switch (record.event)
+    {
+        case Event::prepared:
+            return "prepared: " + juce::String(record.value, 0) + " Hz, " + juce::String(record.a)
+                 + " samples, oversampling " + juce::String(record.b) + "x";
+        case Event::released:
+            return "released";
+        case Event::renderModeChanged:
+            return juce::String("render mode: ") + (record.a != 0 ? "offline" : "realtime");
+        case Event::hostBlockSplit:
+            return "host block of " + juce::String(record.a) + " samples split into "
+                 + juce::String(record.b) + "-sample slices";
+        case Event::discreteSwitch:
+            return "switched to algorithm " + juce::String(record.a + 1) + ", range " + juce::String(record.b);
+        case Event::stateLoaded:
+            return juce::String("state loaded: ") + (record.a == binaryState ? "binary" : "legacy XML")
+                 + ", " + juce::String(record.b) + " bytes";
+        case Event::stateRejected:
+            return juce::String("state ignored: ") + (record.a == tagMismatch ? "XML tag does not match" : "neither binary nor XML")
+                 + ", " + juce::String(record.b) + " bytes";
+    }
+
+    return "unknown event " + juce::String((int) record.event);
+}
+
+//==============================================================================
+class EventLogWriter::Thread : public juce::Thread
+{
+public:
+    explicit Thread(EventLogWriter& ownerIn) : juce::Thread("Event log"), owner(ownerIn) {}
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait(drainIntervalMs);
+            owner.drainAll();
+        }
+    }
+
+private:
+    EventLogWriter& owner;
+};
+
+//==============================================================================
+EventLogWriter::EventLogWriter()
+    : startTicks(juce::Time::getHighResolutionTicks()),
+      startTime(juce::Time::getCurrentTime()),
+      thread(std::make_unique<Thread>(*this))
+{
+    fileEnabled = isFileEnabled();
+
+    thread->startThread(juce::Thread::Priority::background);
+}
+
+EventLogWriter::~EventLogWriter()
+{
+    thread->stopThread(2000);
+    drainAll();
+}
+
+juce::File EventLogWriter::getLogFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("FM_Engine")
+               .getChildFile("events.log");
+}
+
+bool EventLogWriter::isFileEnabled()
+{
+   #if FM_ENGINE_EVENT_LOG_FILE
+    return true;
+   #else
+    return juce::SystemStats::getEnvironmentVariable("FM_ENGINE_EVENT_LOG_FILE", {}) == "1";
+   #endif
+}
+
+void EventLogWriter::add(EventLog& log)
+{
+    const juce::ScopedLock sl(lock);
+    logs.addIfNotAlreadyThere(&log);
+}
+
+void EventLogWriter::remove(EventLog& log)
+{
+    const juce::ScopedLock sl(lock);
+    drain(log);
+    logs.removeFirstMatchingValue(&log);
+}
+
+void EventLogWriter::drainAll()
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto* log : logs)
+        drain(*log);
+
+    if (stream != nullptr)
+    {
+        stream->flush();
+
+        // Reopened (and rolled over) by the next write
+        if (stream->getPosition() > maxLogFileBytes)
+            stream.reset();
+    }
+}
+
+void EventLogWriter::drain(EventLog& log)
+{
+   #if ! JUCE_DEBUG
+    if (! fileEnabled)
+    {
+        // Nowhere to write: empty the rings without formatting anything
+        log.drain([](const EventLog::Record&) {});
+        log.dropped.store(0, std::memory_order_relaxed);
+        return;
+    }
+   #endif
+
+    log.drain([&](const EventLog::Record& record)
+    {
+        const auto elapsedMs = juce::Time::highResolutionTicksToSeconds(record.ticks - startTicks) * 1000.0;
+        const auto when = startTime + juce::RelativeTime::milliseconds((juce::int64) elapsedMs);
+
+        writeLine(when.formatted("%Y-%m-%d %H:%M:%S.") + juce::String(when.getMilliseconds()).paddedLeft('0', 3) + " ["+ juce::String(log.getInstanceId()) + "] "
+                  + EventLog::describe(record));
+    });
+
+    if (const int dropped = log.dropped.exchange(0, std::memory_order_relaxed); dropped > 0)
+        writeLine("[" + juce::String(log.getInstanceId()) + "] " + juce::String(dropped) + " event(s) dropped, log ring full");
+}
+
+void EventLogWriter::writeLine(const juce::String& line)
+{
+   #if JUCE_DEBUG
+    juce::Logger::outputDebugString(line);
+   #endif
+
+    if (stream == nullptr && fileEnabled)
+    {
+        auto file = getLogFile();
+        file.getParentDirectory().createDirectory();
+
+        // Keep one previous file around instead of growing without bound
+        if (file.getSize() > maxLogFileBytes)
+            file.moveFileTo(file.getSiblingFile("events.old.log"));
+
+        stream = std::make_unique<juce::FileOutputStream>(file);
+        if (stream->failedToOpen())
+        {
+            stream.reset();
+            fileEnabled = false; // read-only home, sandboxed host: debugger output only
+        }
+    }
+
+    if (stream != nullptr)
+        *stream << line << juce::newLine;
+}
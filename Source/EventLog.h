@@ -0,0 +1,188 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+#include <array>
+#include <atomic>
+
+// Set to 0 to compile every log call down to nothing
+#ifndef FM_ENGINE_EVENT_LOG
+ #define FM_ENGINE_EVENT_LOG 1
+#endif
+
+// Set to 1 to write events.log in every build. By default only debug builds
+// do; release builds need FM_ENGINE_EVENT_LOG_FILE=1 in the environment
+#ifndef FM_ENGINE_EVENT_LOG_FILE
+ #define FM_ENGINE_EVENT_LOG_FILE JUCE_DEBUG
+#endif
+
+class EventLogWriter;
+
+/**
+ * Per-instance diagnostic log that is safe to call from the audio thread.
+ *
+ * A call records a fixed-size Record (event id, two ints, a float and a
+ * timestamp) into a preallocated ring; nothing is formatted, allocated or
+ * locked. A shared background thread (EventLogWriter) drains every instance's
+ * rings a few times a second. In debug builds it formats the records to the
+ * debugger output, replacing the old DBG calls, and appends them to
+ * events.log in the user's application data folder. Release builds keep the
+ * file off, so shipping hosts do no disk I/O for it, unless the environment
+ * asks for it (see FM_ENGINE_EVENT_LOG_FILE); nothing coordinates several
+ * host processes writing that one file.
+ *
+ * Two rings, one per producer side, so each is single-producer:
+ *   logAudio()   - processBlock only
+ *   log()        - everything else (prepareToPlay, state loading, ...). These
+ *                  callers can be on different threads, so they share a spin
+ *                  lock that the audio thread never touches.
+ *
+ * When a ring is full the record is dropped and counted; the writer reports
+ * the count with the next line it writes.
+ */
+class EventLog
+{
+public:
+    enum class Event : juce::uint16
+    {
+        prepared,           // a: block size, b: oversampling factor, value: sample rate
+        released,
+        renderModeChanged,  // a: 1 = offline, 0 = realtime
+        hostBlockSplit,     // a: host block size, b: prepared size (first per prepare)
+        discreteSwitch,     // a: algorithm, b: range index
+        stateLoaded,        // a: StateFormat, b: size in bytes
+        stateRejected,      // a: StateRejection, b: size in bytes
+    };
+
+    enum StateFormat { binaryState = 0, xmlState = 1 };
+    enum StateRejection { tagMismatch = 0, unrecognised = 1 };
+
+    struct Record
+    {
+        juce::int64 ticks = 0; // juce::Time::getHighResolutionTicks()
+        Event event = Event::prepared;
+        int a = 0, b = 0;
+        float value = 0.0f;
+    };
+
+    static constexpr int ringSize = 256;
+
+    EventLog();
+    ~EventLog();
+
+    /** Audio thread only. */
+    void logAudio(Event event, int a = 0, int b = 0, float value = 0.0f) noexcept
+    {
+       #if FM_ENGINE_EVENT_LOG
+        push(audioRing, audioRecords, { juce::Time::getHighResolutionTicks(), event, a, b, value });
+       #else
+        juce::ignoreUnused(event, a, b, value);
+       #endif
+    }
+
+    /** Any thread except the audio thread. */
+    void log(Event event, int a = 0, int b = 0, float value = 0.0f) noexcept
+    {
+       #if FM_ENGINE_EVENT_LOG
+        const juce::SpinLock::ScopedLockType lock(controlLock);
+        push(controlRing, controlRecords, { juce::Time::getHighResolutionTicks(), event, a, b, value });
+       #else
+        juce::ignoreUnused(event, a, b, value);
+       #endif
+    }
+
+    /** Instance number shown in the log, in order of construction. */
+    int getInstanceId() const noexcept { return instanceId; }
+
+    static juce::String describe(const Record& record);
+
+private:
+    friend class EventLogWriter;
+
+    using Ring = std::array<Record, (size_t) ringSize>;
+
+    void push(juce::AbstractFifo& fifo, Ring& records, const Record& record) noexcept
+    {
+        if (fifo.getFreeSpace() < 1)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto scope = fifo.write(1);
+        scope.forEach([&](int index) { records[(size_t) index] = record; });
+    }
+
+    // Consumer side, EventLogWriter's thread only
+    template <typename Callback>
+    void drain(Callback&& callback)
+    {
+        auto drainRing = [&](juce::AbstractFifo& fifo, const Ring& records)
+        {
+            const auto scope = fifo.read(fifo.getNumReady());
+            scope.forEach([&](int index) { callback(records[(size_t) index]); });
+        };
+
+        drainRing(audioRing, audioRecords);
+        drainRing(controlRing, controlRecords);
+    }
+
+    juce::AbstractFifo audioRing { ringSize }, controlRing { ringSize };
+    Ring audioRecords {}, controlRecords {};
+
+    juce::SpinLock controlLock;
+    std::atomic<int> dropped { 0 };
+    const int instanceId;
+
+    juce::SharedResourcePointer<EventLogWriter> writer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLog)
+};
+
+//==============================================================================
+/**
+ * Process-wide background thread that drains every EventLog and writes the
+ * file. Held by each EventLog through a SharedResourcePointer, so it starts
+ * with the first plugin instance and stops with the last.
+ */
+class EventLogWriter
+{
+public:
+    EventLogWriter();
+    ~EventLogWriter();
+
+    void add(EventLog& log);
+    void remove(EventLog& log); // drains what the log still holds first
+
+    /** Where the log goes: <user app data>/FM_Engine/events.log */
+    static juce::File getLogFile();
+
+    /** True if this build, or the environment, turns the file on. */
+    static bool isFileEnabled();
+
+private:
+    class Thread;
+
+    void drainAll();
+    void drain(EventLog& log);
+    void writeLine(const juce::String& line);
+
+    juce::CriticalSection lock; // guards logs and the file; never taken by an audio thread
+    juce::Array<EventLog*> logs;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    bool fileEnabled = false; // cleared if the file cannot be opened
+
+    // Maps record ticks onto wall-clock time
+    const juce::int64 startTicks;
+    const juce::Time startTime;
+
+    std::unique_ptr<Thread> thread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLogWriter)
+};
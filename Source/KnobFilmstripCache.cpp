@@ -0,0 +1,200 @@
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#endif
+
+#include "KnobFilmstripCache.h"
+
+namespace
+{
+    // Strips for scales nobody has asked for recently are dropped past this
+    // many; one editor needs two (rotary + stepped) per display scale.
+    constexpr int maxCachedStrips = 4;
+}
+
+//==============================================================================
+struct KnobFilmstripCache::Strip
+{
+    StripSpec spec;
+    float scale = 1.0f;
+    juce::uint32 lastUsed = 0;
+
+    // Written by the render job, read on the message thread once ready is set
+    juce::Array<juce::Image> frames;
+    std::atomic<bool> ready { false };
+    std::atomic<bool> finished { false }; // the job is done with it, rendered or not
+
+    // Native-typed frames, converted lazily on the message thread so the
+    // blit does not go through a software image on every paint. Each one
+    // takes the place of its software frame, which is released, so a strip
+    // holds one copy of its pixels once it has been drawn
+    juce::Array<juce::Image> displayFrames;
+
+    bool matches(const StripSpec& other, float otherScale) const noexcept
+    {
+        return spec.numFrames == other.numFrames
+            && juce::approximatelyEqual(spec.startAngle, other.startAngle)
+            && juce::approximatelyEqual(spec.endAngle, other.endAngle)
+            && std::abs(scale - otherScale) < 0.01f;
+    }
+};
+
+//==============================================================================
+class KnobFilmstripCache::RenderJob : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(KnobFilmstripCache& ownerIn, Strip& stripIn)
+        : juce::ThreadPoolJob("Knob filmstrip"), owner(ownerIn), strip(stripIn)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        render();
+        strip.finished.store(true, std::memory_order_release);
+        return jobHasFinished;
+    }
+
+private:
+    void render()
+    {
+        // Editor opened before the shared resources finished decoding
+        while (!owner.resources->waitUntilLoaded(50))
+            if (shouldExit())
+                return;
+
+        const auto source = owner.resources->getKnobImage();
+        if (!source.isValid())
+            return;
+
+        const auto& spec = strip.spec;
+        const int width = juce::jmax(1, juce::roundToInt(source.getWidth() * strip.scale));
+        const int height = juce::jmax(1, juce::roundToInt(source.getHeight() * strip.scale));
+
+        juce::Array<juce::Image> frames;
+        frames.ensureStorageAllocated(spec.numFrames);
+
+        for (int i = 0; i < spec.numFrames; ++i)
+        {
+            if (shouldExit())
+                return;
+
+            const float proportion = static_cast<float>(i) / static_cast<float>(spec.numFrames - 1);
+            const float angle = spec.startAngle + proportion * (spec.endAngle - spec.startAngle);
+
+            juce::Image frame(juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+            {
+                juce::Graphics g(frame);
+                g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+                g.addTransform(juce::AffineTransform::scale(strip.scale));
+                g.drawImageTransformed(source,
+                                       juce::AffineTransform::rotation(angle,
+                                                                       source.getWidth() * 0.5f,
+                                                                       source.getHeight() * 0.5f),
+                                       false);
+            }
+
+            frames.add(frame);
+        }
+
+        strip.frames.swapWith(frames);
+        strip.ready.store(true, std::memory_order_release);
+        owner.sendChangeMessage(); // async, coalesced onto the message thread
+    }
+
+    KnobFilmstripCache& owner;
+    Strip& strip;
+};
+
+//==============================================================================
+KnobFilmstripCache::KnobFilmstripCache() = default;
+
+KnobFilmstripCache::~KnobFilmstripCache()
+{
+    // Jobs hold references into strips, so they must be gone first
+    renderPool.removeAllJobs(true, 5000);
+}
+
+juce::Image KnobFilmstripCache::getFrame(const StripSpec& spec, float scale, float proportion)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto& strip = findOrQueueStrip(spec, scale);
+    if (!strip.ready.load(std::memory_order_acquire) || strip.frames.isEmpty())
+        return {};
+
+    if (strip.displayFrames.size() != strip.frames.size())
+        strip.displayFrames.resize(strip.frames.size());
+
+    const int index = juce::jlimit(0, strip.frames.size() - 1,
+                                   juce::roundToInt(proportion * static_cast<float>(strip.frames.size() - 1)));
+
+    auto& frame = strip.displayFrames.getReference(index);
+    if (!frame.isValid())
+    {
+        auto& software = strip.frames.getReference(index);
+        frame = juce::NativeImageType().convert(software);
+        software = {};
+    }
+
+    return frame;
+}
+
+void KnobFilmstripCache::prewarm(const StripSpec& spec, float scale)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    findOrQueueStrip(spec, scale);
+}
+
+KnobFilmstripCache::Strip& KnobFilmstripCache::findOrQueueStrip(const StripSpec& requested, float scale)
+{
+    auto spec = requested;
+    spec.numFrames = juce::jmax(2, spec.numFrames);
+    scale = juce::jmax(0.1f, scale);
+    ++useCounter;
+
+    for (auto* strip : strips)
+    {
+        if (strip->matches(spec, scale))
+        {
+            strip->lastUsed = useCounter;
+            return *strip;
+        }
+    }
+
+    // Evict a strip whose render failed, or else the least recently used
+    // finished one. Strips still rendering are referenced by their job and
+    // stay until it completes, so the bound can be passed only while jobs run
+    if (strips.size() >= maxCachedStrips)
+    {
+        int victim = -1;
+        for (int i = 0; i < strips.size(); ++i)
+        {
+            if (!strips[i]->finished.load(std::memory_order_acquire))
+                continue;
+
+            if (!strips[i]->ready.load(std::memory_order_acquire))
+            {
+                victim = i;
+                break;
+            }
+
+            if (victim < 0 || strips[i]->lastUsed < strips[victim]->lastUsed)
+                victim = i;
+        }
+
+        if (victim >= 0)
+            strips.remove(victim);
+    }
+
+    auto* strip = strips.add(new Strip());
+    strip->spec = spec;
+    strip->scale = scale;
+    strip->lastUsed = useCounter;
+
+    renderPool.addJob(new RenderJob(*this, *strip), true);
+
+    return *strip;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#endif
+
+#include "EditorResources.h"
+
+/**
+ * Pre-rotated frames of the knob PNG, so drawing a knob is a single blit
+ * instead of a rotated resample on every repaint.
+ *
+ * Hold it through juce::SharedResourcePointer<KnobFilmstripCache>: every editor
+ * (and every look-and-feel inside it) then shares the same frames. A strip is
+ * identified by its angle span, frame count and the physical pixel scale it
+ * was rendered at; it is rendered once on a background thread the first time
+ * it is asked for, and a change message goes out when it is ready. The
+ * source knob comes from EditorResources; jobs queued before it is decoded
+ * wait for it on the render thread.
+ *
+ * All public methods are message-thread only.
+ */
+class KnobFilmstripCache : public juce::ChangeBroadcaster
+{
+public:
+    struct StripSpec
+    {
+        float startAngle = 0.0f;   // radians, frame 0
+        float endAngle = 0.0f;     // radians, last frame
+        int numFrames = 2;
+    };
+
+    KnobFilmstripCache();
+    ~KnobFilmstripCache() override;
+
+    /** The decoded source knob (invalid while still loading or if the PNG failed). */
+    juce::Image getKnobImage() const { return resources->getKnobImage(); }
+
+    /** Returns the frame nearest to proportion (0..1 across the span), or an
+        invalid image if that strip is still rendering - the caller should
+        fall back to drawing the knob transformed. Queues the strip if needed. */
+    juce::Image getFrame(const StripSpec& spec, float scale, float proportion);
+
+    /** Queues a strip without asking for a frame, e.g. when an editor opens. */
+    void prewarm(const StripSpec& spec, float scale);
+
+private:
+    struct Strip;
+    class RenderJob;
+
+    Strip& findOrQueueStrip(const StripSpec& spec, float scale);
+
+    juce::SharedResourcePointer<EditorResources> resources;
+    juce::OwnedArray<Strip> strips;
+    juce::uint32 useCounter = 0;
+    juce::ThreadPool renderPool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KnobFilmstripCache)
+};
@@ -3,27 +3,25 @@
 #else
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_basics/juce_gui_basics.h>
-#include "BinaryData.h"
 #endif
 
 #include "PluginEditor.h"
 #include "PluginProcessor.h"
+#include "KnobFilmstripCache.h"
 
 //==============================================================================
 // Custom LookAndFeel for rotating PNG knobs
 class RotaryKnobLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    RotaryKnobLookAndFeel()
-    {
-        // Load the single knob PNG from BinaryData
-        knobImage = juce::ImageCache::getFromMemory(BinaryData::knob_png, BinaryData::knob_pngSize);
-    }
+    // Frames across the 300 degree sweep: ~2.3 degrees apart, ~5 MB per strip at 1x
+    static constexpr int numFilmstripFrames = 128;
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                          float sliderPosProportional, float rotaryStartAngle,
                          float rotaryEndAngle, juce::Slider& /*slider*/) override
     {
+        const auto& knobImage = filmstrip->getKnobImage();
         if (!knobImage.isValid())
         {
             // Fallback: draw a simple circle if image fails to load
@@ -32,7 +30,17 @@ public:
             return;
         }
 
-        // Calculate rotation angle based on slider position
+        // Pre-rotated frame at this display's pixel scale: a plain blit
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        auto frame = filmstrip->getFrame({ rotaryStartAngle, rotaryEndAngle, numFilmstripFrames },
+                                         scale, sliderPosProportional);
+        if (frame.isValid())
+        {
+            g.drawImage(frame, juce::Rectangle<float>(x, y, knobImage.getWidth(), knobImage.getHeight()));
+            return;
+        }
+
+        // Strip still rendering: rotate the source directly for now
         float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
         
         // Create transform for rotation around center
@@ -47,7 +55,7 @@ public:
     }
 
 private:
-    juce::Image knobImage;
+    juce::SharedResourcePointer<KnobFilmstripCache> filmstrip;
 };
 
 //==============================================================================
@@ -55,15 +63,14 @@ private:
 class SteppedKnobLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    SteppedKnobLookAndFeel()
-    {
-        knobImage = juce::ImageCache::getFromMemory(BinaryData::knob_png, BinaryData::knob_pngSize);
-    }
+    // One frame per detent
+    static constexpr int numFilmstripFrames = 4;
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                          float sliderPosProportional, float rotaryStartAngle,
                          float rotaryEndAngle, juce::Slider&) override
     {
+        const auto& knobImage = filmstrip->getKnobImage();
         if (!knobImage.isValid())
         {
             g.setColour(juce::Colours::grey);
@@ -82,6 +89,15 @@ public:
         else
             snappedPos = 1.0f;           // Position 3 (500ms)
 
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        auto frame = filmstrip->getFrame({ rotaryStartAngle, rotaryEndAngle, numFilmstripFrames },
+                                         scale, snappedPos);
+        if (frame.isValid())
+        {
+            g.drawImage(frame, juce::Rectangle<float>(x, y, knobImage.getWidth(), knobImage.getHeight()));
+            return;
+        }
+
         // Calculate rotation angle for the snapped position
         float angle = rotaryStartAngle + snappedPos * (rotaryEndAngle - rotaryStartAngle);
 
@@ -94,7 +110,7 @@ public:
     }
 
 private:
-    juce::Image knobImage;
+    juce::SharedResourcePointer<KnobFilmstripCache> filmstrip;
 };
 
 
@@ -104,13 +120,9 @@ FmEngineAudioProcessorEditor::FmEngineAudioProcessorEditor(FmEngineAudioProcesso
 {
     setSize(337, 600);
 
-    // Load background image
-    backgroundImage = juce::ImageFileFormat::loadFrom(BinaryData::background_png, 
-                                                     BinaryData::background_pngSize);
-    if (backgroundImage.isValid())
-        backgroundImage = juce::SoftwareImageType().convert(backgroundImage);
-    else
-        DBG("Failed to load background image");
+    // Images are decoded once per process, normally already done by the
+    // time an editor opens; if not, paint placeholders and swap them in
+    resources->addChangeListener(this);
 
     // Set custom look and feel for knobs
     rotaryKnobLookAndFeel = std::make_unique<RotaryKnobLookAndFeel>();
@@ -219,25 +231,25 @@ FmEngineAudioProcessorEditor::FmEngineAudioProcessorEditor(FmEngineAudioProcesso
     // LABELS
     //==========================================================================
     swapLabel.setText("Swap", juce::dontSendNotification);
-    swapLabel.setFont(juce::Font(juce::FontOptions("Arial", 14.0f, juce::Font::bold)));
+    swapLabel.setFont(resources->getLabelFont());
     swapLabel.setColour(juce::Label::textColourId, juce::Colour(170, 170, 170));
     swapLabel.setJustificationType(juce::Justification::right);
     addAndMakeVisible(swapLabel);
 
     predelayLabel.setText("PDC", juce::dontSendNotification);
-    predelayLabel.setFont(juce::Font(juce::FontOptions("Arial", 14.0f, juce::Font::bold)));
+    predelayLabel.setFont(resources->getLabelFont());
     predelayLabel.setColour(juce::Label::textColourId, juce::Colour(170, 170, 170));
     predelayLabel.setJustificationType(juce::Justification::right);
     addAndMakeVisible(predelayLabel);
 
     limiterLabel.setText("Limit", juce::dontSendNotification);
-    limiterLabel.setFont(juce::Font(juce::FontOptions("Arial", 14.0f, juce::Font::bold)));
+    limiterLabel.setFont(resources->getLabelFont());
     limiterLabel.setColour(juce::Label::textColourId, juce::Colour(170, 170, 170));
     limiterLabel.setJustificationType(juce::Justification::left);
     addAndMakeVisible(limiterLabel);
 
     oversamplingLabel.setText("2X OS", juce::dontSendNotification);
-    oversamplingLabel.setFont(juce::Font(juce::FontOptions("Arial", 14.0f, juce::Font::bold)));
+    oversamplingLabel.setFont(resources->getLabelFont());
     oversamplingLabel.setColour(juce::Label::textColourId, juce::Colour(170, 170, 170));
     oversamplingLabel.setJustificationType(juce::Justification::left);
     addAndMakeVisible(oversamplingLabel);
@@ -272,61 +284,184 @@ FmEngineAudioProcessorEditor::FmEngineAudioProcessorEditor(FmEngineAudioProcesso
         &oversamplingLabel
     };
 
-    startTimerHz(30); // 30 Hz refresh for parameter display
+    //==========================================================================
+    // VALUE LABELS
+    //==========================================================================
+    // Repaint only the two label regions, and only when their parameters move.
+    // ParameterAttachment delivers the callbacks on the message thread.
+    modDepthLabelAttachment = std::make_unique<juce::ParameterAttachment>(
+        *processor.apvts.getParameter("MOD_DEPTH"), [this](float) { markLabelsDirty(); });
+    maxDelayLabelAttachment = std::make_unique<juce::ParameterAttachment>(
+        *processor.apvts.getParameter("MAX_DELAY_MS"), [this](float) { markLabelsDirty(); });
+
+    updateValueLabels();
+
+    //==========================================================================
+    // SCOPE / SPECTRUM (hidden control panel)
+    //==========================================================================
+    // Clicks pass through so the panel still closes wherever it is clicked
+    visualization.setInterceptsMouseClicks(false, false);
+    addChildComponent(visualization);
+
+    // Morph snapshots: click recalls a slot, shift-click stores the current settings in it
+    for (int slot = 0; slot < PresetBank::numSlots; ++slot)
+    {
+        auto& button = snapshotButtons[(size_t) slot];
+        button.setButtonText(juce::String(slot + 1));
+        button.setTooltip("Snapshot " + juce::String(slot + 1) + ": click to recall, shift-click to store");
+        button.onClick = [this, slot]
+        {
+            if (juce::ModifierKeys::currentModifiers.isShiftDown())
+                processor.storeSnapshot(slot);
+            else
+                processor.recallSnapshot(slot);
+        };
+        addChildComponent(button);
+    }
+
+    // The background covers the whole editor, so nothing behind it needs painting
+    setOpaque(true);
+
+    //==========================================================================
+    // KNOB FILMSTRIPS
+    //==========================================================================
+    // Start rendering the pre-rotated knob frames for the display we are most
+    // likely to open on; until they arrive the knobs draw transformed.
+    knobFilmstrip->addChangeListener(this);
+
+    float expectedScale = juce::Desktop::getInstance().getGlobalScaleFactor();
+    if (auto* display = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay())
+        expectedScale *= static_cast<float>(display->scale);
+
+    const auto modDepthRotary = modDepthSlider.getRotaryParameters();
+    knobFilmstrip->prewarm({ modDepthRotary.startAngleRadians, modDepthRotary.endAngleRadians,
+                             RotaryKnobLookAndFeel::numFilmstripFrames }, expectedScale);
+
+    const auto maxDelayRotary = maxDelaySlider.getRotaryParameters();
+    knobFilmstrip->prewarm({ maxDelayRotary.startAngleRadians, maxDelayRotary.endAngleRadians,
+                             SteppedKnobLookAndFeel::numFilmstripFrames }, expectedScale);
 }
 
 FmEngineAudioProcessorEditor::~FmEngineAudioProcessorEditor()
 {
+    knobFilmstrip->removeChangeListener(this);
+    resources->removeChangeListener(this);
+
     // Reset look and feel before components are destroyed
     modDepthSlider.setLookAndFeel(nullptr);
     maxDelaySlider.setLookAndFeel(nullptr);
 }
 
+// Only runs while label updates are pending: each tick flushes them, and the
+// first tick with nothing to do stops the timer again.
 void FmEngineAudioProcessorEditor::timerCallback()
 {
-    repaint();
+    if (!labelsDirty)
+    {
+        stopTimer();
+        return;
+    }
+
+    labelsDirty = false;
+    updateValueLabels();
+    repaint(modAmountLabelBounds);
+    repaint(maxDelayLabelBounds);
 }
 
-void FmEngineAudioProcessorEditor::paint(juce::Graphics& g)
+void FmEngineAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
-    // Use medium-quality resampling for better compatibility
-    g.setImageResamplingQuality(juce::Graphics::mediumResamplingQuality);
+    // Shared images finished decoding: rebuild the static layer with them
+    if (source == resources.get())
+    {
+        backgroundLayer = {};
+        repaint();
+        return;
+    }
+
+    // A filmstrip finished rendering: swap the knobs over from the transformed fallback
+    modDepthSlider.repaint();
+    maxDelaySlider.repaint();
+}
 
+void FmEngineAudioProcessorEditor::markLabelsDirty()
+{
+    labelsDirty = true;
+
+    if (!isTimerRunning())
+        startTimerHz(30); // coalesce automation bursts to at most 30 repaints/s
+}
+
+void FmEngineAudioProcessorEditor::updateValueLabels()
+{
+    auto* modDepthParam = processor.apvts.getParameter("MOD_DEPTH");
+    float maxDelayMs = processor.getMaxDelayMsFromChoice();
+    float modDepth = modDepthParam->convertFrom0to1(modDepthParam->getValue());
+    float modAmountMs = juce::jlimit(0.0f, maxDelayMs, maxDelayMs * modDepth);
+
+    modAmountText = juce::String(modAmountMs, 2) + " ms";
+    maxDelayText = juce::String(maxDelayMs, 0) + " ms";
+}
+
+void FmEngineAudioProcessorEditor::renderBackgroundLayer(float scale)
+{
+    const auto bounds = getLocalBounds();
+    const int width = juce::roundToInt(bounds.getWidth() * scale);
+    const int height = juce::roundToInt(bounds.getHeight() * scale);
+
+    backgroundLayerScale = scale;
+    if (width <= 0 || height <= 0)
+    {
+        backgroundLayer = {};
+        return;
+    }
+
+    backgroundLayer = juce::Image(juce::Image::RGB, width, height, true);
+    juce::Graphics g(backgroundLayer);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    // Resampled once here instead of on every repaint
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+
+    const auto backgroundImage = resources->getBackgroundImage();
     if (backgroundImage.isValid())
     {
         g.drawImage(backgroundImage,
-                   getLocalBounds().toFloat(),
+                   bounds.toFloat(),
                    juce::RectanglePlacement::stretchToFit,
                    false);
     }
+    else
+    {
+        // Still decoding (or failed): flat panel colour until it arrives
+        g.fillAll(juce::Colour::fromRGBA(42, 42, 42, 255));
+    }
 
     // Title
-    g.setFont(juce::Font(juce::FontOptions("Arial", 26.0f, juce::Font::bold)));
+    g.setFont(resources->getTitleFont());
     g.setColour(juce::Colour(170, 170, 170));
     g.drawText("FM Engine",
-              getLocalBounds().removeFromTop(55),
+              bounds.withHeight(55),
               juce::Justification::centred, true);
 
     // Draw tic marks for range dial
     drawDialTicMarks(g);
+}
 
-    // Display current delay times as knob labels
-    auto* modDepthParam = processor.apvts.getRawParameterValue("MOD_DEPTH");
-    float maxDelayMs = processor.getMaxDelayMsFromChoice();
-    float modDepth = modDepthParam ? modDepthParam->load() : 0.0f;
-    float modAmountMs = maxDelayMs * modDepth;
-    modAmountMs = juce::jlimit(0.0f, maxDelayMs, modAmountMs);
+void FmEngineAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Rebuild the static layer if the window moved to a display with a different scale
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!backgroundLayer.isValid() || scale != backgroundLayerScale)
+        renderBackgroundLayer(scale);
 
-    g.setFont(juce::Font(juce::FontOptions("Arial", 14.0f, juce::Font::bold)));
-    g.setColour(juce::Colour(170, 170, 170));
+    if (backgroundLayer.isValid())
+        g.drawImage(backgroundLayer, getLocalBounds().toFloat());
 
-    if (maxDelayMs && modDepthParam)
-    {
-        juce::String modAmountText = juce::String(modAmountMs, 2) + " ms";
-        juce::String maxDelayText = juce::String(maxDelayMs, 0) + " ms";
-        g.drawFittedText(modAmountText, 47, 166, 100, 20, juce::Justification::centred, 1);
-        g.drawFittedText(maxDelayText, 196, 165, 100, 20, juce::Justification::centred, 1);
-    }
+    // Display current delay times as knob labels
+    g.setFont(resources->getLabelFont());
+    g.setColour(juce::Colour(170, 170, 170));
+    g.drawFittedText(modAmountText, modAmountLabelBounds, juce::Justification::centred, 1);
+    g.drawFittedText(maxDelayText, maxDelayLabelBounds, juce::Justification::centred, 1);
 
     // Hidden control panel (info screen)
     if (controlPanelVisible)
@@ -334,81 +469,77 @@ void FmEngineAudioProcessorEditor::paint(juce::Graphics& g)
         g.setColour(juce::Colour::fromRGBA(42, 42, 42, 255));
         g.fillRect(getLocalBounds());
 
-        g.setFont(juce::Font(juce::FontOptions("DejaVu Sans Mono", 16.0f, juce::Font::plain)));
+        g.setFont(resources->getInfoFont());
         g.setColour(juce::Colour(204, 204, 204));
 
         juce::String infoText = 
             "      FM Engine - Ver. 071525      \n"
             "   (c)2014-2025 AmateurTools DSP   \n"
             "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"
-            "                                   \n"
             "Arbitrary-input frequency modulator\n"
             "with auxiliary sidechain input     \n"
             "with additional self-mod mono mode.\n"
             "(Expects Stereo and SC inputs, but \n"
             "works with just the main inputs.)  \n"
-            "                                   \n"
             "Upper Right dial sets delay time.  \n"
             "Upper Left dial attenuates that.   \n"
-            "                                   \n"
             "Alg 1: stereo in, L <- R           \n"
             "Alg 2: summed in <- summed SC      \n"
             "Alg 3: stereo in <- stereo SC      \n"
-            "                                   \n"
             "LIMIT  Adds limitations to i/o     \n"
-            "                                   \n"
             "SWAP   Swaps the Carrier/Modulator \n"
-            "                                   \n"
             "OS2X   2x Oversampling             \n"
-            "                                   \n"
             "PDC    Secures timing, but adds    \n"
             "       latency to the DAW.         \n"
-            "                                   \n"
             "LPF    (with SHIFT+DRAG preview)   \n"
-            "                                   \n"
             "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"
-            "                                   \n"
             "Thanks: JUCE, VST Steinberg GmBh,  \n"
             "  BedroomProducersBlog,            \n"
             "Concept inspired by: Autechre,     \n"
             "Beta Tester: Erik Lagerwall        \n";
 
+        // Spacer lines dropped to make room for the scope/spectrum below
         g.drawFittedText(infoText,
-                        getLocalBounds().reduced(20),
+                        infoTextBounds,
                         juce::Justification::centredLeft,
-                        35);
+                        24);
     }
 }
 
 void FmEngineAudioProcessorEditor::drawDialTicMarks(juce::Graphics& g)
 {
-    // Dial bounding box and center
-    const float bboxX = 195.0f, bboxY = 40.0f, bboxW = 100.0f, bboxH = 130.0f;
-    const float centerX = bboxX + bboxW * 0.5f;
-    const float centerY = bboxY + bboxH * 0.5f;
-
-    // Tic mark radii and angles
-    const float innerRadius = 52.0f;
-    const float outerRadius = 57.0f;
-    const float startAngleDeg = 210.0f;
-    const float endAngleDeg = 330.0f;
-    const int numTics = 4;
-
-
-    g.setColour(juce::Colour(125, 125, 125));
-
-    for (int i = 0; i < numTics; ++i)
+    // Geometry never changes, so the path is built once and reused
+    if (dialTicMarksPath.isEmpty())
     {
-        float alpha = juce::jmap<float>(i, 0, numTics - 1, startAngleDeg, endAngleDeg);
-        float angleRad = juce::degreesToRadians(alpha);
+        // Dial bounding box and center
+        const float bboxX = 195.0f, bboxY = 40.0f, bboxW = 100.0f, bboxH = 130.0f;
+        const float centerX = bboxX + bboxW * 0.5f;
+        const float centerY = bboxY + bboxH * 0.5f;
+
+        // Tic mark radii and angles
+        const float innerRadius = 52.0f;
+        const float outerRadius = 57.0f;
+        const float startAngleDeg = 210.0f;
+        const float endAngleDeg = 330.0f;
+        const int numTics = 4;
+
+        for (int i = 0; i < numTics; ++i)
+        {
+            float alpha = juce::jmap<float>(i, 0, numTics - 1, startAngleDeg, endAngleDeg);
+            float angleRad = juce::degreesToRadians(alpha);
 
-        float x1 = centerX + innerRadius * std::cos(angleRad);
-        float y1 = centerY + innerRadius * std::sin(angleRad);
-        float x2 = centerX + outerRadius * std::cos(angleRad);
-        float y2 = centerY + outerRadius * std::sin(angleRad);
+            float x1 = centerX + innerRadius * std::cos(angleRad);
+            float y1 = centerY + innerRadius * std::sin(angleRad);
+            float x2 = centerX + outerRadius * std::cos(angleRad);
+            float y2 = centerY + outerRadius * std::sin(angleRad);
 
-        g.drawLine(x1, y1, x2, y2, 2.0f);
+            // Same shape Graphics::drawLine(x1, y1, x2, y2, 2.0f) fills
+            dialTicMarksPath.addLineSegment({ x1, y1, x2, y2 }, 2.0f);
+        }
     }
+
+    g.setColour(juce::Colour(125, 125, 125));
+    g.fillPath(dialTicMarksPath);
 }
 
 void FmEngineAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
@@ -419,6 +550,9 @@ void FmEngineAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
 
         for (auto* comp : guiComponents)
             comp->setVisible(!controlPanelVisible);
+        visualization.setVisible(controlPanelVisible);
+        for (auto& button : snapshotButtons)
+            button.setVisible(controlPanelVisible);
 
         repaint();
         return;
@@ -429,6 +563,9 @@ void FmEngineAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
         controlPanelVisible = false;
         for (auto* comp : guiComponents)
             comp->setVisible(true);
+        visualization.setVisible(false);
+        for (auto& button : snapshotButtons)
+            button.setVisible(false);
         repaint();
         return;
     }
@@ -436,6 +573,8 @@ void FmEngineAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
 
 void FmEngineAudioProcessorEditor::resized()
 {
+    backgroundLayer = {}; // re-rendered at the new size on the next paint
+
     // Position knobs (100x100 each, centered in their areas)
     modDepthSlider.setBounds(45, 40, 100, 100);
     maxDelaySlider.setBounds(195, 40, 100, 100);
@@ -454,4 +593,11 @@ void FmEngineAudioProcessorEditor::resized()
 
     oversamplingToggle.setBounds(20, 459, 40, 20);
     oversamplingLabel.setBounds(65, 459, 145, 20);
+
+    visualization.setBounds(20, 408, 297, 146);
+
+    // Snapshot buttons in a row under the visualization
+    const int snapshotButtonWidth = 297 / PresetBank::numSlots;
+    for (int slot = 0; slot < PresetBank::numSlots; ++slot)
+        snapshotButtons[(size_t) slot].setBounds(20 + slot * snapshotButtonWidth, 558, snapshotButtonWidth - 2, 22);
 }
\ No newline at end of file
@@ -14,6 +14,9 @@
 #include "SlidingSwitch.h"
 #include "SidewaysToggleSwitch.h"
 #include "CustomCutoffSlider.h"
+#include "EditorResources.h"
+#include "KnobFilmstripCache.h"
+#include "VisualizationComponent.h"
 #include "PluginProcessor.h" // for the getMaxDelayMsFromChoice() function
 
 class RotaryKnobLookAndFeel;
@@ -21,7 +24,8 @@ class SteppedKnobLookAndFeel;
 
 class FmEngineAudioProcessor; // Forward declaration
 
-class FmEngineAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Timer
+class FmEngineAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Timer,
+                                      private juce::ChangeListener
 {
 public:
     FmEngineAudioProcessorEditor (FmEngineAudioProcessor&);
@@ -42,7 +46,9 @@ private:
 
     // InfoToggleButton InfoToggle; // tooltip toggle letter button
 
-    juce::Image backgroundImage;
+    // Decoded images and fonts, shared with every other editor and the processor
+    juce::SharedResourcePointer<EditorResources> resources;
+
     SlidingSwitch slideSwitch; //algorithm 3 positon selector switch
     SidewaysToggleSwitch swapToggle; // swap
     SidewaysToggleSwitch predelayToggle;
@@ -58,6 +64,9 @@ private:
     // Hidden Control Panel stuff =================================================================
 
     bool controlPanelVisible = false;
+    VisualizationComponent visualization { processor.visualizationTap }; // scope + spectrum, panel only
+    std::array<juce::TextButton, PresetBank::numSlots> snapshotButtons; // click recalls, shift-click stores
+    const juce::Rectangle<int> infoTextBounds { 20, 20, 297, 380 };
     juce::Rectangle<int> controlPanelBounds { 0, 201, 337, 200 };
     juce::Rectangle<int> sandwichIconBounds { 10, 10, 20, 20 }; // Top-left corner, adjust as needed
 
@@ -79,9 +88,33 @@ private:
     // new knobfix stuff -- wip
     std::unique_ptr<RotaryKnobLookAndFeel> rotaryKnobLookAndFeel;
     std::unique_ptr<SteppedKnobLookAndFeel> steppedKnobLookAndFeel;
+
+    // Pre-rotated knob frames shared by every open editor
+    juce::SharedResourcePointer<KnobFilmstripCache> knobFilmstrip;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     
     // Add this helper method declaration:
     void drawDialTicMarks(juce::Graphics& g);
+    juce::Path dialTicMarksPath;
+
+    // Static layer (stretched background, title, tic marks) pre-rendered at the
+    // display's physical scale; rebuilt only on resize or scale change
+    void renderBackgroundLayer(float scale);
+    juce::Image backgroundLayer;
+    float backgroundLayerScale = 0.0f;
+
+    // Knob value labels: formatted when a parameter changes, not on every paint
+    void updateValueLabels();
+    void markLabelsDirty();
+    juce::String modAmountText, maxDelayText;
+    bool labelsDirty = false;
+
+    const juce::Rectangle<int> modAmountLabelBounds { 47, 166, 100, 20 };
+    const juce::Rectangle<int> maxDelayLabelBounds { 196, 165, 100, 20 };
+
+    // Message-thread callbacks for the two parameters the labels display
+    std::unique_ptr<juce::ParameterAttachment> modDepthLabelAttachment;
+    std::unique_ptr<juce::ParameterAttachment> maxDelayLabelAttachment;
 
     // LABELS
 
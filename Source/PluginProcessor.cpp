@@ -70,6 +70,42 @@ juce::AudioProcessorValueTreeState::ParameterLayout FmEngineAudioProcessor::crea
         20000.0f // default value
     ));   
 
+    // Preset morphing: MORPH sweeps from snapshot MORPH_A to MORPH_B
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"MORPH_ON", 1}, "Morph Enable", false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"MORPH", 1}, "Morph",
+        juce::NormalisableRange<float>(0.0f, 1.0f),
+        0.0f
+    ));
+
+    auto snapshotName = [](int value, int) { return "Snapshot " + juce::String(value + 1); };
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{"MORPH_A", 1}, "Morph From",
+        0, PresetBank::numSlots - 1, 0, juce::String(), snapshotName
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{"MORPH_B", 1}, "Morph To",
+        0, PresetBank::numSlots - 1, 1, juce::String(), snapshotName
+    ));
+
+    // Render profile for offline bounces (see PluginProcessor.h)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"OFFLINE_HQ", 1}, "Offline HQ Render", true
+    ));
+
+    // Operator graph in place of the single delay pair (OperatorGraph.h).
+    // Host-automatable only for now; the editor has no control for it
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"OPERATORS", 1}, "Operators",
+        juce::StringArray({ "1 Operator", "Cascade", "Stack", "Parallel", "Feedback" }),
+        0
+    ));
+
     return { params.begin(), params.end() };
 }
 
@@ -105,9 +141,6 @@ juce::AudioProcessor::BusesProperties FmEngineAudioProcessor::makeBusesPropertie
 FmEngineAudioProcessor::FmEngineAudioProcessor()
     : AudioProcessor(makeBusesProperties()),
       apvts(*this, nullptr, "PARAMETERS", createParameterLayout()),
-      smoothedModDepth(0.0f),
-      lastBaseDelay(0.0f),
-      lpfSoloFade(0.0f),
       bypassOversampling(false)  // Or your default value
 {
     // Attach listeners to parameters
@@ -123,6 +156,17 @@ FmEngineAudioProcessor::FmEngineAudioProcessor()
 
     lpCutoffParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("LP_CUTOFF"));
 
+    morphOnParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("MORPH_ON"));
+    morphParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("MORPH"));
+    morphAParam = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("MORPH_A"));
+    morphBParam = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("MORPH_B"));
+    offlineHqParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("OFFLINE_HQ"));
+    operatorsParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("OPERATORS"));
+
+    // Fixed-order table for the binary state chunk
+    stateParameters = BinaryState::resolveParameters(apvts);
+    presetBank.resetToDefaults(stateParameters);
+
     jassert(modDepthParam);
     jassert(maxDelayMsParam);
     jassert(algorithmParam);
@@ -135,6 +179,13 @@ FmEngineAudioProcessor::FmEngineAudioProcessor()
 
     jassert(lpCutoffParam);
 
+    jassert(morphOnParam);
+    jassert(morphParam);
+    jassert(morphAParam);
+    jassert(morphBParam);
+    jassert(offlineHqParam);
+    jassert(operatorsParam);
+
     apvts.addParameterListener("MOD_DEPTH", this);
     apvts.addParameterListener("MAX_DELAY_MS", this);
     apvts.addParameterListener("ALGORITHM", this);
@@ -146,10 +197,16 @@ FmEngineAudioProcessor::FmEngineAudioProcessor()
     apvts.addParameterListener("PREDELAY", this);
 
     apvts.addParameterListener("LP_CUTOFF", this);
+
+    engine.setObserver(this);
+
+    startTimer(100); // picks up latency changes made on the audio thread, allocates the operator graph
 }
 
 FmEngineAudioProcessor::~FmEngineAudioProcessor()
 {
+    stopTimer();
+
     apvts.removeParameterListener("MOD_DEPTH", this);
     apvts.removeParameterListener("MAX_DELAY_MS", this);
     apvts.removeParameterListener("ALGORITHM", this);
@@ -165,180 +222,84 @@ FmEngineAudioProcessor::~FmEngineAudioProcessor()
 
 void FmEngineAudioProcessor::updateLatency()
 {
-    bool predelayEnabled = getPredelayEnabled();
-    float maxDelayMs = getMaxDelayMsFromChoice();
-    double sampleRate = getSampleRate();
-
-    if (sampleRate <= 0.0)
+    if (getSampleRate() <= 0.0)
         return; // Defensive: avoid division by zero or negative rates
 
-    if (predelayEnabled)
-    {
-        // Calculate latency in samples, using 0.5 factor if that's your design
-        int latencySamples = static_cast<int>(maxDelayMs * 0.001 * sampleRate * 0.5);
-        latencySamples = std::max(0, latencySamples); // Ensure non-negative
+    // The oversampling factor the engine is actually running, not the one asked for
+    setLatencySamples(engine.computeLatencySamples(getPredelayEnabled(), maxDelayMsParam->get(), limiterParam->get(),
+                                                   engine.getAppliedOversamplingFactor()));
+}
 
-        setLatencySamples(latencySamples);
-    }
-    else
-    {
-        setLatencySamples(0);
-    }
+void FmEngineAudioProcessor::timerCallback()
+{
+    if (latencyChangePending.exchange(false))
+        updateLatency();
+
+    // The operator graph is allocated here, off the audio thread, the first
+    // time OPERATORS asks for it; processBlock takes it at its next switch
+    if (operatorsParam->getIndex() != 0)
+        engine.prepareOperatorGraph();
 }
 
 
+// Can be called on the audio thread during automation: no getRawParameterValue("...")
+// lookups in here, they build juce::String keys
 void FmEngineAudioProcessor::parameterChanged(const juce::String& parameterID, float /*newValue*/)
 {
-    if (parameterID == "MOD_DEPTH")
+    if (parameterID == "MAX_DELAY_MS" || parameterID == "PREDELAY" || parameterID == "LIMITER")
     {
-        if (auto* p = apvts.getRawParameterValue("MOD_DEPTH"))
-        {
-            float currentModDepth = *p;
-            // currentModDepth probably relates to parameter smoothing
-        }
-    }
-    else if (parameterID == "MAX_DELAY_MS")
-    {
-        float currentMaxDelayMs = getMaxDelayMsFromChoice();
-        delayL.setMaxDelayMs(currentMaxDelayMs);
-        delayR.setMaxDelayMs(currentMaxDelayMs);
-        updateLatency();
-    }
-
-    else if (parameterID == "ALGORITHM")
-    {
-        if (auto* p = apvts.getRawParameterValue("ALGORITHM"))
-        {
-            int currentAlgorithmIndex = static_cast<int>(*p);
-        }
-    }
-    else if (parameterID == "SWAP")
-    {
-        if (auto* p = apvts.getRawParameterValue("SWAP"))
-        {
-            bool isSwaped = (*p > 0.5f);
-        }
-    }
-    else if (parameterID == "LIMITER")
-    {
-        if (auto* p = apvts.getRawParameterValue("LIMITER"))
-        {
-            bool currentLimiter = (*p > 0.5f);
-        }
-    }
-    else if (parameterID == "PREDELAY")
-    {
-        updateLatency();
+        // The delay lines pick the new range (and the limiter its lookahead) up
+        // in processBlock, behind a switch dip or crossfade. setLatencySamples()
+        // notifies the host under a lock, so it is left to the message thread
+        // (timerCallback) wherever this was called from
+        latencyChangePending.store(true);
     }
     else if (parameterID == "OVERSAMPLING") {
         shouldResetDelay = true; // Force delay re-prepare
     }    
-    else if (parameterID == "LP_CUTOFF")
-    {
-        if (auto* p = apvts.getRawParameterValue("LP_CUTOFF"))
-        {
-            float currentLPCutoff = *p;
-            // Usage of currentLPCutoff, e.g.:
-            // modulatorLowPassL.setCutoff(currentLPCutoff);
-            // modulatorLowPassR.setCutoff(currentLPCutoff);
-        }
-    }
 }
 
 //==============================================================================
 void FmEngineAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Pre-allocate buffers for max block size
-    routedBuffer.setSize(4, samplesPerBlock);
-    tempProcessingBuffer.setSize(3, samplesPerBlock);
-    normalizedModL.resize(samplesPerBlock, 0.0f);
-    normalizedModR.resize(samplesPerBlock, 0.0f);
-
-    oversampler.initProcessing(samplesPerBlock);
-    oversampler.reset();
-    
     // Store the max samples per block for assertions and buffer sizing
     currentMaxBlockSize = samplesPerBlock; 
-    // ADDED DBG LINE:
-    DBG("prepareToPlay: samplesPerBlock received = " << samplesPerBlock << ", currentMaxBlockSize set to = " << currentMaxBlockSize);
-
-    // Prepare DSP components - Use BASE sample rate for delay preparation
-    modulatorLowPassL.prepare(sampleRate, samplesPerBlock);
-    modulatorLowPassR.prepare(sampleRate, samplesPerBlock);
-
-    float safeMaxDelay = getMaxDelayMsFromChoice();
-    
-    // FIXED: Use oversampled sample rate for delay preparation when oversampling is enabled
-    double finalSampleRate = sampleRate;
-    if (*apvts.getRawParameterValue("OVERSAMPLING") > 0.5f)
-    {
-        finalSampleRate = sampleRate * oversampler.getOversamplingFactor();
-    }
-    
-    delayL.prepare(finalSampleRate, safeMaxDelay);
-    delayR.prepare(finalSampleRate, safeMaxDelay);
+    reportedBlockSplit = false;
 
-    // Initialize the silent sidechain buffer (conceptually a member variable)
-    // This assumes silentSidechainBuffer is a member of FmEngineAudioProcessor
-    silentSidechainBuffer.setSize(2, currentMaxBlockSize, false, true, true);
-    silentSidechainBuffer.clear(); // Fill with zeros
+    // The engine starts out on the current settings, no switch dip pending
+    engine.setSettings(getTargetSettings());
+    engine.prepare(sampleRate, samplesPerBlock);
 
-    modulatorLowPassL.setCutoff(lpCutoffParam->get()); // Using setCutoff
-    modulatorLowPassR.setCutoff(lpCutoffParam->get()); // Using setCutoff
+    updateInputLayout();
 
     // Reset components if flags are set (e.g., after loading preset or parameter change requiring full reset)
     if (shouldResetDelay)
     {
-        delayL.reset();
-        delayR.reset();
+        engine.resetDelays();
         shouldResetDelay = false;
     }
 
     if (shouldResetLowPass)
     {
-        modulatorLowPassL.reset();
-        modulatorLowPassR.reset();
+        engine.resetModulatorFilters();
         shouldResetLowPass = false;
     }
 
-    // Smoothing times in milliseconds (adjust to taste)
-    float modDepthSmoothingTimeMs = 10.0f;
-    float cutoffSmoothingTimeMs = 15.0f; // it sucks for audio rate modulation of this LPF but that's not supposed to be a feature
-
-    modDepthSmoothingCoeff = std::exp(-1.0f / (0.001f * modDepthSmoothingTimeMs * sampleRate));
-
-    // Initialize smoothed values to current parameter values
-    // I've tried the builtin juce method to smooth the param but the one pole way might work better.
-    smoothedModDepth = *apvts.getRawParameterValue("MOD_DEPTH");
-
-    // smooth out the LPF cutoff value for safety
-    smoothedCutoff.reset(sampleRate, cutoffSmoothingTimeMs * 0.001f); 
-    smoothedCutoff.setTargetValue (*apvts.getRawParameterValue ("LP_CUTOFF"));
-
-    // coeffs for HPF
-    highPassL.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 10.0f, 0.707f);
-    highPassR.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 10.0f, 0.707f);
-
-    limiterOutL.prepare(getSampleRate(), getBlockSize());
-    limiterOutL.setCeiling(-0.1f); // example: -0.1 dB ceiling
-    limiterOutR.prepare(getSampleRate(), getBlockSize());
-    limiterOutR.setCeiling(-0.1f); // example: -0.1 dB ceiling
+    visualizationTap.prepare(sampleRate);
 
     updateLatency(); 
+
+    eventLog.log(EventLog::Event::prepared, samplesPerBlock, engine.getAppliedOversamplingFactor(), (float) sampleRate);
 }
 
 void FmEngineAudioProcessor::releaseResources()
 {
-    // Only clear buffers that are actually used
-    silentSidechainBuffer.setSize(0, 0); // If you use this buffer
-
     // Reset your DSP components to clear their internal states/buffers
-    delayL.reset();
-    delayR.reset();
-    modulatorLowPassL.reset();
-    modulatorLowPassR.reset();
+    engine.resetDelays();
+    engine.resetModulatorFilters();
 
     // Add any other resource cleanup your plugin requires
+    eventLog.log(EventLog::Event::released);
 }
 
 bool FmEngineAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -366,373 +327,173 @@ bool FmEngineAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 
     return false;
 }
-//==============================================================================
-// 4. ENHANCED processBlock with better channel debugging
 
-void FmEngineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+bool FmEngineAudioProcessor::canAddBus(bool isInput) const
 {
-    juce::ScopedNoDenormals noDenormals;
+    return isInput && getBusCount(true) < 2;
+}
 
-    // === PREDELAY STUFF ===
-    bool predelayEnabled = apvts.getRawParameterValue("PREDELAY")->load() > 0.5f;
+bool FmEngineAudioProcessor::canRemoveBus(bool isInput) const
+{
+    return isInput && getBusCount(true) > 1;
+}
 
-    // if predelay is enabled, set the basedelay, otherwise basedelay is always set to 0.0f
-    float newBaseDelay = predelayEnabled ? (0.5f * delayL.getMaxDelayMs()) : 0.0f;
-    if (newBaseDelay != lastBaseDelay)
+bool FmEngineAudioProcessor::canApplyBusCountChange(bool isInput, bool isAdding, BusProperties& outNewBusProperties)
+{
+    if (!AudioProcessor::canApplyBusCountChange(isInput, isAdding, outNewBusProperties))
+        return false;
+
+    // The only bus that comes and goes is the sidechain
+    if (isAdding)
     {
-        delayL.setBaseDelayMs(newBaseDelay);
-        delayR.setBaseDelayMs(newBaseDelay);
-        lastBaseDelay = newBaseDelay;
+        outNewBusProperties.busName = "Sidechain";
+        outNewBusProperties.defaultLayout = juce::AudioChannelSet::stereo();
     }
 
-    // ===================
+    return true;
+}
 
-    const int numSamples = buffer.getNumSamples();  // this gets how many samples per block
-    const int numChannels = buffer.getNumChannels();
+void FmEngineAudioProcessor::processorLayoutsChanged()
+{
+    updateInputLayout();
+}
 
-    // --- Buffer and channel count checks ---
-    jassert(numSamples > 0);
-    jassert(numChannels > 0);
+void FmEngineAudioProcessor::updateInputLayout()
+{
+    if (getBusCount(true) < 2)
+        inputLayout = InputLayout::mainOnly;
+    else if (!getBus(true, 1)->isEnabled())
+        inputLayout = InputLayout::sidechainDisabled;
+    else
+        inputLayout = InputLayout::mainAndSidechain;
+}
 
-    if (numSamples <= 0)
-        return;
+//==============================================================================
+// The engine slices blocks longer than the prepared size itself, so whatever
+// the host hands over goes through in one call.
 
-    // Ensure buffers are large enough (only resize if needed)
-    if (numSamples > routedBuffer.getNumSamples())
-        routedBuffer.setSize(4, numSamples);
-    if (numSamples > tempProcessingBuffer.getNumSamples())
-        tempProcessingBuffer.setSize(3, numSamples);
-    if (numSamples > (int)normalizedModL.size()) {
-        normalizedModL.resize(numSamples, 0.0f);
-        normalizedModR.resize(numSamples, 0.0f);
-    }
-    
-    routedBuffer.clear();
-    tempProcessingBuffer.clear();
-    juce::FloatVectorOperations::clear(normalizedModL.data(), numSamples);
-    juce::FloatVectorOperations::clear(normalizedModR.data(), numSamples);
-    
-    auto mainInput = getBusBuffer(buffer, true, 0);
-    auto mainOutput = getBusBuffer(buffer, false, 0);
-    auto sidechainInput = getBusBuffer(buffer, true, 1);
-    
-    jassert(mainInput.getNumChannels() == 2);
-    jassert(mainOutput.getNumChannels() == 2);
-    jassert(sidechainInput.getNumChannels() == 2);
+void FmEngineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    juce::ScopedNoDenormals noDenormals;
 
-    const float* inL = mainInput.getReadPointer(0);
-    const float* inR = (mainInput.getNumChannels() > 1) ? mainInput.getReadPointer(1) : nullptr;
-    const float* scL = (sidechainInput.getNumChannels() > 0) ? sidechainInput.getReadPointer(0) : nullptr;
-    const float* scR = (sidechainInput.getNumChannels() > 1) ? sidechainInput.getReadPointer(1) : nullptr;
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples <= 0 || currentMaxBlockSize <= 0)
+        return; // not prepared yet: leave the input untouched
 
     // Report mode changes (realtime/offline) only when they occur
-    bool currentNonRealtime = isNonRealtime();
-
-    static bool lastReportedNonRealtime = false;
+    const bool currentNonRealtime = isNonRealtime();
     if (currentNonRealtime != lastReportedNonRealtime)
     {
-        DBG("=== PROCESSING MODE CHANGE ===");
-        DBG("Now running in: " << (currentNonRealtime ? "OFFLINE RENDER" : "REALTIME"));
+        eventLog.logAudio(EventLog::Event::renderModeChanged, currentNonRealtime ? 1 : 0);
         lastReportedNonRealtime = currentNonRealtime;
     }
-    // #endif
-
-    int algorithm = algorithmParam->getIndex();
-
-    float modDepth = *apvts.getRawParameterValue("MOD_DEPTH");
-    jassert(std::isfinite(modDepth));
-
-    // Get pointers to routed buffer channels
-    auto* routedCarrierL = routedBuffer.getWritePointer(0);
-    auto* routedCarrierR = routedBuffer.getWritePointer(1);
-    auto* routedModL     = routedBuffer.getWritePointer(2);
-    auto* routedModR     = routedBuffer.getWritePointer(3);
-
-    jassert(routedCarrierL != nullptr);
-    jassert(routedCarrierR != nullptr);
-    jassert(routedModL != nullptr);
-    jassert(routedModR != nullptr);
-
-    bool swap = (*apvts.getRawParameterValue("SWAP") > 0.5f);
-
-    bool oversamplingEnabled = (*apvts.getRawParameterValue("OVERSAMPLING") > 0.5f);
-
-    // for fading in and out of low pass solo mode
-    const float fadeTimeSamples = lpfSoloFadeTimeMs * 0.001f * getSampleRate();
-    const float fadeStep = (fadeTimeSamples > 0.0f) ? (1.0f / fadeTimeSamples) : 1.0f;
 
-    // one liner to wash audio floats so they don't go to nans
-    auto sanitize = [](float x) -> float { return std::isfinite(x) ? x : 0.0f; };
-
-    // --- FIXED: Safe routing with null pointer protection ---
-    for (int i = 0; i < numSamples; ++i)
+    if (numSamples > currentMaxBlockSize && !reportedBlockSplit)
     {
-        jassert(i < numSamples);
-        float carrierL = inL ? sanitize(inL[i]) : 0.0f;
-        float carrierR = inR ? sanitize(inR[i]): carrierL;
-        float modL = scL ? sanitize(scL[i]) : 0.0f;
-        float modR = scR ? sanitize(scR[i]) : modL;
-
-        RoutingOutputs rout = routeSample(carrierL, carrierR, modL, modR, algorithm, swap);
-        routedCarrierL[i] = rout.carrier.left;
-        routedCarrierR[i] = rout.carrier.right;
-        routedModL[i]     = rout.modulator.left;
-        routedModR[i]     = rout.modulator.right;
-
-        jassert(std::isfinite(routedCarrierL[i]));
-        jassert(std::isfinite(routedCarrierR[i]));
-        jassert(std::isfinite(routedModL[i]));
-        jassert(std::isfinite(routedModR[i]));
+        eventLog.logAudio(EventLog::Event::hostBlockSplit, numSamples, currentMaxBlockSize);
+        reportedBlockSplit = true;
     }
 
-    // --- PRE-PROCESS MODULATOR: Smoothing, Clipping, Lowpass ---
-
-    auto* smoothedModDepthBuffer = tempProcessingBuffer.getWritePointer(0);
-
-    auto* processedModL = tempProcessingBuffer.getWritePointer(1);
-    auto* processedModR = tempProcessingBuffer.getWritePointer(2);
+    auto mainInput = getBusBuffer(buffer, true, 0);
+    auto mainOutput = getBusBuffer(buffer, false, 0);
 
-    jassert(smoothedModDepthBuffer != nullptr);
-    jassert(processedModL != nullptr);
-    jassert(processedModR != nullptr);
+    // Every supported layout has stereo main in and out
+    jassert(mainInput.getNumChannels() == 2);
+    jassert(mainOutput.getNumChannels() == 2);
 
-    float smoothedModDepthLocal = smoothedModDepth;
+    if (mainInput.getNumChannels() < 2 || mainOutput.getNumChannels() < 2)
+        return;
 
-    smoothedCutoff.setTargetValue(*apvts.getRawParameterValue("LP_CUTOFF"));
+    const float* inL = mainInput.getReadPointer(0);
+    const float* inR = mainInput.getReadPointer(1);
 
-    // stuff for deciding to clip the output and clip type
-    auto* limitRaw = apvts.getRawParameterValue("LIMITER");
-    bool currentLimiter = (limitRaw && *limitRaw > 0.5f);
+    // Without a sidechain the engine gets none, rather than a buffer of zeros
+    const float* scL = nullptr;
+    const float* scR = nullptr;
 
-    for (int i = 0; i < numSamples; ++i)
+    if (inputLayout == InputLayout::mainAndSidechain)
     {
-        // Buffer bounds checks (for all arrays and pointers sized to numSamples)
-        jassert(i >= 0 && i < numSamples);
-        jassert(i < routedBuffer.getNumSamples()); // For routedBuffer
-    
-        // Parameter smoothing
-        smoothedModDepthLocal = (1.0f - modDepthSmoothingCoeff) * modDepth
-                              + modDepthSmoothingCoeff * smoothedModDepthLocal;
-        smoothedModDepthBuffer[i] = smoothedModDepthLocal;
-
-        jassert(std::isfinite(smoothedModDepthLocal));
-    
-        // Sanitize and process modulator
-        float safeModL = sanitize(routedModL[i]);
-        float safeModR = sanitize(routedModR[i]);
-
-        jassert(std::isfinite(safeModL));
-        jassert(std::isfinite(safeModR));
-    
-        float smoothedCutoffValue = smoothedCutoff.getNextValue();
-        jassert(std::isfinite(smoothedCutoffValue));
-
-        modulatorLowPassL.setCutoff(smoothedCutoffValue);
-        modulatorLowPassR.setCutoff(smoothedCutoffValue);
-    
-        // Filter first
-        float filteredL = modulatorLowPassL.processSample(safeModL);
-        float filteredR = modulatorLowPassR.processSample(safeModR);
-
-        jassert(std::isfinite(filteredL));
-        jassert(std::isfinite(filteredR));
-    
-        // === APPLY MOD DEPTH while signal is still bipolar ===
-
-        float depthModL = filteredL * smoothedModDepthLocal;
-        float depthModR = filteredR * smoothedModDepthLocal;
-
-        jassert(std::isfinite(depthModL));
-        jassert(std::isfinite(depthModR));
-    
-        // Sanitize after depth (optional, for safety)
-        processedModL[i] = sanitize(depthModL);
-        processedModR[i] = sanitize(depthModR);
-
-        jassert(std::isfinite(processedModL[i]));
-        jassert(std::isfinite(processedModR[i]));
-        
-        // normalize modulator from bipolar to unipolar
-        normalizedModL[i] = (processedModL[i] + 1.0f) * 0.5f;
-        normalizedModR[i] = (processedModR[i] + 1.0f) * 0.5f;
-
-        jassert(std::isfinite(normalizedModL[i]));
-        jassert(std::isfinite(normalizedModR[i]));
-
-        jassert(normalizedModL[i] >= 0.0f && normalizedModL[i] <= 1.0f);
-        jassert(normalizedModR[i] >= 0.0f && normalizedModR[i] <= 1.0f);
-        
-        // (Optional) Store in routed buffer if needed for oversampling
-        jassert(routedBuffer.getNumChannels() > 2);
-        jassert(routedBuffer.getNumChannels() > 3);
-        routedBuffer.setSample(2, i, processedModL[i]);
-        routedBuffer.setSample(3, i, processedModR[i]);
-    }
-
-    // Save smoothed state for next block
-    // this is part of the "better" working one pole param smoothing method
-    smoothedModDepth = smoothedModDepthLocal;
-
-    //=================
+        auto sidechainInput = getBusBuffer(buffer, true, 1);
+        jassert(sidechainInput.getNumChannels() == 2);
 
-    // auto clipper = [](float x, float threshold) -> float {
-    //         if (threshold == 0.0f) return 0.0f; // Avoid division by zero
-    //         // x = std::clamp(x, -threshold, threshold); // Normalize input
-    //         x = std::sin((x / threshold) * (M_PI / 2)) * threshold;
-    //         return x;
-    // };
-
-    auto clipper = [](float x) -> float {
-            x = std::sin((x) * (M_PI / 2)); 
-            x = x * 0.6310f; // 0.6310f corresponds to a gain reduction of -4db that this clipper seems to add
-            return x;
-    };
+        scL = sidechainInput.getReadPointer(0);
+        scR = sidechainInput.getReadPointer(1);
+    }
 
-    if (oversamplingEnabled)
-    {
-        // --- OVERSAMPLING UP ---
-        juce::dsp::AudioBlock<float> routedBlock(routedBuffer);
-        auto oversampledBlock = oversampler.processSamplesUp(routedBlock);
-    
-        // --- DELAY PROCESSING (INSIDE OVERSAMPLED BLOCK) ---
-        const int osFactor  = oversampler.getOversamplingFactor();
-        const int osSamples = numSamples * osFactor;
-    
-        jassert(osSamples <= oversampledBlock.getNumSamples());
-        jassert(oversampledBlock.getNumChannels() >= 4);
-    
-        auto* osCarrierL = oversampledBlock.getChannelPointer(0);
-        auto* osCarrierR = oversampledBlock.getChannelPointer(1);
-        auto* osModL     = oversampledBlock.getChannelPointer(2);
-        auto* osModR     = oversampledBlock.getChannelPointer(3);
-    
-        for (int i = 0; i < osSamples; ++i)
-        {
-            float pos = static_cast<float>(i) / osFactor;
-            int idx0 = static_cast<int>(pos);
-            int idx1 = juce::jmin(idx0 + 1, numSamples - 1);
-            float frac = pos - idx0;
-
-            // this appears to be interpolation for the oversampling process
-            float modLraw = normalizedModL[idx0] + frac * (normalizedModL[idx1] - normalizedModL[idx0]);
-            float modRraw = normalizedModR[idx0] + frac * (normalizedModR[idx1] - normalizedModR[idx0]);
-
-            if (currentLimiter) {
-                modLraw = clipper(modLraw);  // tried limiting. trying sine clip again.
-                modRraw = clipper(modRraw);  // sine clip adds ringing. limiter creates latency issue.
-            }
+    // Host automation reaches us as one value per block, with no position
+    // (JUCE's wrappers keep only the last point of each parameter queue), so
+    // the engine's smoothing takes depth and cutoff changes from the start of
+    // the block. Sample-accurate points are for the core and the C API.
+    //
+    // Main in and out share the host's channels; the engine reads a slice
+    // completely before writing it
+    engine.setSettings(getTargetSettings());
+    engine.process(inL, inR, scL, scR, mainOutput.getWritePointer(0), mainOutput.getWritePointer(1), numSamples);
+}
 
-            // float modL = juce::jlimit(-1.0f, 1.0f, modLraw); // hard clipping for modulator in safety
-            // float modR = juce::jlimit(-1.0f, 1.0f, modRraw); // the delay itself is limited but might as well
+void FmEngineAudioProcessor::subBlockProcessed(float delayMinMs, float delayMaxMs, const float* modL, const float* modR,
+                                               int numSamples, float gainReductionDb) noexcept
+{
+    visualizationTap.pushBlock(delayMinMs, delayMaxMs, modL, modR, numSamples, gainReductionDb);
+}
 
-            float outL = delayL.process(osCarrierL[i], modLraw);
-            float outR = delayR.process(osCarrierR[i], modRraw);
+void FmEngineAudioProcessor::discreteSettingsApplied(const FmEngineCore::Settings& applied) noexcept
+{
+    // Reported from the message thread (timerCallback); a no-op there unless
+    // the oversampling moved
+    latencyChangePending.store(true);
 
-            // if (currentLimiter) {
-            //     outL = clipper(outL);  // let's just use one clipper for final output
-            //     outR = clipper(outR);  // they add harmonics but may be a preference
-            // }
+    eventLog.logAudio(EventLog::Event::discreteSwitch, applied.algorithm, applied.range);
+}
 
-            osCarrierL[i] = std::isfinite(outL) ? outL : 0.0f;
-            osCarrierR[i] = std::isfinite(outR) ? outR : 0.0f;
-        }
-    
-        // --- OVERSAMPLING DOWN ---
-        oversampler.processSamplesDown(routedBlock);
-    }
-    else
-    {
-        // No oversampling: process directly on routedBuffer
-        jassert(routedBuffer.getNumChannels() >= 2);
-        jassert(routedBuffer.getNumSamples() >= numSamples);
+//==============================================================================
+// Preset morphing. Continuous parameters are interpolated (the cutoff in its
+// normalised, i.e. logarithmic, space) and go through the usual smoothing.
+// Discrete ones take snapshot A below the halfway point and B above it.
+// OVERSAMPLING and PREDELAY are never morphed: one needs a re-prepare and the
+// other changes the reported latency, neither of which the audio thread can do.
+// For the same reason the range only follows the morph while PREDELAY is off.
+
+FmEngineCore::Settings FmEngineAudioProcessor::getTargetSettings() const noexcept
+{
+    FmEngineCore::Settings settings;
+    settings.modDepth = modDepthParam->get();
+    settings.lpCutoff = lpCutoffParam->get();
+    settings.algorithm = algorithmParam->getIndex();
+    settings.range = maxDelayMsParam->get();
+    settings.limiter = limiterParam->get();
+    settings.swap = swapParam->get();
+    settings.predelay = predelayParam->get();
+    settings.modulatorSolo = bypassOversampling.load();
+    settings.operatorAlgorithm = operatorsParam->getIndex();
 
-        auto* carrierL = routedBuffer.getWritePointer(0);
-        auto* carrierR = routedBuffer.getWritePointer(1);
+    settings.renderQuality = isNonRealtime() && offlineHqParam->get();
+    settings.oversamplingFactor = settings.renderQuality ? 4 : (oversamplingParam->get() ? 2 : 1);
 
-        for (int i = 0; i < numSamples; ++i)
-        {
-            jassert(i < normalizedModL.size());
-            jassert(i < normalizedModR.size());
+    if (!morphOnParam->get())
+        return settings;
 
-            float modLraw = normalizedModL[i];
-            float modRraw = normalizedModR[i];
+    const int slotA = morphAParam->get();
+    const int slotB = morphBParam->get();
+    const float t = morphParam->get();
+    const int discreteSlot = t < 0.5f ? slotA : slotB;
 
-            // float modL = juce::jlimit(-1.0f, 1.0f, modLraw); // hard clipping for modulator in safety
-            // float modR = juce::jlimit(-1.0f, 1.0f, modRraw); // the delay itself is limited but might as well
+    auto value = [this](int slot, int index) { return presetBank.getValue(slot, index); };
 
-            if (currentLimiter) {
-                modLraw = clipper(modLraw);  // let's just use one clipper for final output
-                modRraw = clipper(modRraw);  // they add harmonics but may be a preference
-            }
+    settings.modDepth = juce::jmap(t, value(slotA, PresetBank::modDepthIndex), value(slotB, PresetBank::modDepthIndex));
 
-            float outL = delayL.process(carrierL[i], modLraw);
-            float outR = delayR.process(carrierR[i], modRraw);
+    const float cutoffA = lpCutoffParam->convertTo0to1(value(slotA, PresetBank::lpCutoffIndex));
+    const float cutoffB = lpCutoffParam->convertTo0to1(value(slotB, PresetBank::lpCutoffIndex));
+    settings.lpCutoff = lpCutoffParam->convertFrom0to1(juce::jmap(t, cutoffA, cutoffB));
 
-            // if (currentLimiter) {
-            //     outL = clipper(outL);  // let's just use one clipper for final output
-            //     outR = clipper(outR);  // they add harmonics but may be a preference
-            // }
+    settings.algorithm = juce::jlimit(0, 2, juce::roundToInt(value(discreteSlot, PresetBank::algorithmIndex)));
+    settings.limiter = value(discreteSlot, PresetBank::limiterIndex) > 0.5f;
+    settings.swap = value(discreteSlot, PresetBank::swapIndex) > 0.5f;
 
-            jassert(std::isfinite(outL));
-            jassert(std::isfinite(outR));
+    if (!predelayParam->get())
+        settings.range = juce::jlimit(0, 3, juce::roundToInt(value(discreteSlot, PresetBank::maxDelayIndex)));
 
-            carrierL[i] = std::isfinite(outL) ? outL : 0.0f;
-            carrierR[i] = std::isfinite(outR) ? outR : 0.0f;
-        }
-    }
-    
-    // stuff that has to do with smoothly crossfading the LPF solo function
-    // in oversampled mode the clipper is in there so i wonder if there is a risk from spikes here.
-    const float targetFade = bypassOversampling ? 1.0f : 0.0f;
-    if (lpfSoloFade < targetFade)
-        lpfSoloFade = std::min(targetFade, lpfSoloFade + fadeStep * numSamples);
-    else if (lpfSoloFade > targetFade)
-        lpfSoloFade = std::max(targetFade, lpfSoloFade - fadeStep * numSamples);
-
-    lpfSoloFade = juce::jlimit(0.0f, 1.0f, lpfSoloFade);
-    
-    float fadeMix = 0.5f * (1.0f - std::cos(lpfSoloFade * juce::MathConstants<float>::pi));
-
-    // ============= FIXED OUTPUT SECTION - NO MORE VECTOR BOUNDS VIOLATIONS =============
-    for (int i = 0; i < numSamples; ++i)
-    {
-        jassert(i < routedBuffer.getNumSamples());
-        jassert(i < numSamples); // for processedModL and processedModR if they are float*
-
-        // Normal output (what you would normally send to buffer)
-        float normalL = routedBuffer.getSample(0, i);
-        float normalR = routedBuffer.getSample(1, i);
-
-        jassert(std::isfinite(normalL));
-        jassert(std::isfinite(normalR));
-
-        // LPF solo output (the filtered modulator) - NOW SAFE!
-        float lpfL = processedModL[i];
-        float lpfR = processedModR[i];
-
-        jassert(std::isfinite(lpfL));
-        jassert(std::isfinite(lpfR));
-
-        // Crossfade
-        float outL = (1.0f - fadeMix) * normalL + fadeMix * lpfL;
-        float outR = (1.0f - fadeMix) * normalR + fadeMix * lpfR;
-
-        // Safe output - ensure we have enough channels
-        // High-pass filter after delay (and after any other processing)
-        float hpL = highPassL.processSample(outL);
-        float hpR = highPassR.processSample(outR);
-
-        // try lookahead limiter instead of sine clipper for final output
-        if (currentLimiter) {
-        hpL = limiterOutL.processSample(hpL);
-        hpR = limiterOutR.processSample(hpR);
-        }     
-
-        if (buffer.getNumChannels() > 0)
-            buffer.setSample(0, i, hpL);
-        if (buffer.getNumChannels() > 1)
-            buffer.setSample(1, i, hpR);
-    }
+    return settings;
 }
 
 //==============================================================================
@@ -749,46 +510,47 @@ juce::AudioProcessorEditor* FmEngineAudioProcessor::createEditor()
 
 //==============================================================================
 // Save plugin state (all parameters, including PREDELAY)
+// Compact binary chunk, see BinaryState.h; no XML is built
 void FmEngineAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    DBG("[FmEngine] getStateInformation called");
-    auto state = apvts.copyState();
-    if (auto xml = state.createXml())
-    {
-        DBG("[FmEngine] Saving state. PREDELAY value: " << *apvts.getRawParameterValue("PREDELAY"));
-        copyXmlToBinary(*xml, destData);
-    }
-    else
-    {
-        DBG("[FmEngine] Error: Could not create XML from state!");
-    }
+    BinaryState::write(stateParameters, presetBank, destData);
 }
 
 //==============================================================================
 // Restore plugin state (all parameters, including PREDELAY)
 void FmEngineAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    DBG("[FmEngine] setStateInformation called");
-    if (auto xmlState = getXmlFromBinary(data, sizeInBytes))
+    if (BinaryState::read(stateParameters, presetBank, data, sizeInBytes))
     {
-        DBG("[FmEngine] Loaded state XML:\n" << xmlState->toString());
+        eventLog.log(EventLog::Event::stateLoaded, EventLog::binaryState, sizeInBytes);
+        shouldResetDelay = true;
+        shouldResetLowPass = true;
+        return;
+    }
 
+    // Fallback: XML state saved by earlier versions
+    if (auto xmlState = getXmlFromBinary(data, sizeInBytes))
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
         {
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+            // XML sessions predate the bank: start from defaults rather than
+            // keeping whatever snapshots the last loaded state had
+            presetBank.resetToDefaults(stateParameters);
+
+            eventLog.log(EventLog::Event::stateLoaded, EventLog::xmlState, sizeInBytes);
             shouldResetDelay = true;
             shouldResetLowPass = true;
-
-            DBG("[FmEngine] State loaded. PREDELAY value after load: " << *apvts.getRawParameterValue("PREDELAY"));
         }
         else
         {
-            DBG("[FmEngine] Error: XML tag name does not match state type!");
+            eventLog.log(EventLog::Event::stateRejected, EventLog::tagMismatch, sizeInBytes);
         }
     }
     else
     {
-        DBG("[FmEngine] Error: Could not parse XML from binary data!");
+        eventLog.log(EventLog::Event::stateRejected, EventLog::unrecognised, sizeInBytes);
     }
 }
 
@@ -819,9 +581,11 @@ bool FmEngineAudioProcessor::isMidiEffect() const
     return false;
 }
 
+// No programs. The snapshots are recalled from the editor only: hosts call
+// setCurrentProgram(0) on load, which must not overwrite the restored state
 int FmEngineAudioProcessor::getNumPrograms()
 {
-    return 1; // No programs
+    return 1;
 }
 
 int FmEngineAudioProcessor::getCurrentProgram()
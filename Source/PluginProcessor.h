@@ -15,13 +15,13 @@
 #include <vector>
 #include <memory>
 
-// Include your DSP component headers
-#include "InterpolatedDelay.h"
-
-#include "BrickWallLimiter.h"
-
-#include "LowPass.h"
-#include "Routing.h" // Assuming Routing.h defines RoutingOutputs struct
+// The DSP itself lives in the JUCE-free core library (Core/)
+#include "FmEngineCore.h"
+#include "EditorResources.h"
+#include "VisualizationTap.h"
+#include "BinaryState.h"
+#include "PresetBank.h"
+#include "EventLog.h"
 
 // Add this to PluginProcessor.h after includes
 namespace ParameterIDs
@@ -34,13 +34,21 @@ namespace ParameterIDs
     constexpr const char* OVERSAMPLING = "OVERSAMPLING";
     constexpr const char* PREDELAY = "PREDELAY";
     constexpr const char* LP_CUTOFF = "LP_CUTOFF";
+    constexpr const char* MORPH_ON = "MORPH_ON";
+    constexpr const char* MORPH = "MORPH";
+    constexpr const char* MORPH_A = "MORPH_A";
+    constexpr const char* MORPH_B = "MORPH_B";
+    constexpr const char* OFFLINE_HQ = "OFFLINE_HQ";
+    constexpr const char* OPERATORS = "OPERATORS";
 }
 
 using namespace ParameterIDs;
 
 //==============================================================================
 class FmEngineAudioProcessor  : public juce::AudioProcessor,
-                              public juce::AudioProcessorValueTreeState::Listener // Make sure this is present
+                              public juce::AudioProcessorValueTreeState::Listener, // Make sure this is present
+                              private juce::Timer,
+                              private FmEngineCore::Observer
 {
 public:
     //==============================================================================
@@ -55,6 +63,12 @@ public:
    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
    #endif
 
+    // The sidechain bus may be removed (main-only) and put back
+    bool canAddBus(bool isInput) const override;
+    bool canRemoveBus(bool isInput) const override;
+    bool canApplyBusCountChange(bool isInput, bool isAdding, BusProperties& outNewBusProperties) override;
+    void processorLayoutsChanged() override;
+
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
@@ -90,51 +104,69 @@ public:
     void parameterChanged(const juce::String& parameterID, float newValue) override;
 
     // ================= Max Delay Ms from Choice converter ==========================
+    // Uses the cached parameter pointer, so it is safe to call from the audio thread
     float getMaxDelayMsFromChoice() const
     {
-        static constexpr float delayChoices[] = { 1.0f, 10.0f, 100.0f, 500.0f };
-        if (auto* maxDelayMsParam = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("MAX_DELAY_MS")))
-        {
-            int idx = maxDelayMsParam->get();  // Use get() instead of getIndex()
-            return delayChoices[juce::jlimit(0, 3, idx)];
-        }
+        if (maxDelayMsParam != nullptr)
+            return rangeToMs(maxDelayMsParam->get());  // Use get() instead of getIndex()
         return 10.0f; // Fallback
     }
 
+    static float rangeToMs(int rangeIndex) noexcept { return FmEngineCore::rangeToMs(rangeIndex); }
+
+    //================== Preset morphing ==========================================
+    // Snapshots of the sound parameters; MORPH interpolates between MORPH_A and
+    // MORPH_B on the audio thread while MORPH_ON is set. Message thread only.
+    void storeSnapshot(int slot) { presetBank.store(slot, stateParameters); }
+    void recallSnapshot(int slot)
+    {
+        if (!juce::isPositiveAndBelow(slot, PresetBank::numSlots))
+            return;
+        presetBank.recall(slot, stateParameters);
+    }
+
+    PresetBank presetBank;
+
 
     //================== Low Pass Filter Solo the modulator ====================================
     std::atomic<bool> bypassOversampling { false }; // atomic bool for the LPF solo in processblock
 
     bool getPredelayEnabled() const
     {
-        if (auto* p = apvts.getRawParameterValue("PREDELAY"))
-            return (*p > 0.5f);
-        return false;
+        return predelayParam != nullptr && predelayParam->get();
     }
 
     //================== are we in realtime or offline mode (rendering?) ==============
+    // While the host renders offline (isNonRealtime()) and OFFLINE_HQ is on, the
+    // engine runs its render profile: 4x oversampling, 6-point Lagrange delay
+    // interpolation and a true-peak output limiter. Hosts normally flag the
+    // render before prepareToPlay, so the profile starts there with the right
+    // latency; a flip mid-stream goes through the discrete switch dip.
 
-    // void setNonRealtime(bool isNonRealtime) noexcept override;
-
-    BrickWallLimiter limiterModL, limiterModR, limiterOutL, limiterOutR;
+    // Audio thread -> editor scope/spectrum. The summary is written every
+    // block, editor or not; the spectrum feed only while the editor reads it
+    VisualizationTap visualizationTap;
 
 private:
 
     static juce::AudioProcessor::BusesProperties makeBusesProperties();
 
-    //================== important buffers for processlbock ============================
-    juce::AudioBuffer<float> routedBuffer;
-    juce::AudioBuffer<float> tempProcessingBuffer;
-    std::vector<float> normalizedModL;
-    std::vector<float> normalizedModR;
+    // Host parameters, or the A/B snapshot morph while MORPH_ON is set
+    FmEngineCore::Settings getTargetSettings() const noexcept;
+
+    // FmEngineCore::Observer, called from inside engine.process()
+    void subBlockProcessed(float delayMinMs, float delayMaxMs, const float* modL, const float* modR,
+                           int numSamples, float gainReductionDb) noexcept override;
+    void discreteSettingsApplied(const FmEngineCore::Settings& applied) noexcept override;
 
-    //================== Low Pass Solo Crossfade =======================================
-    // Crossfade state for LPF solo
-    float lpfSoloFade = 0.0f; // 0 = normal, 1 = fully LPF solo
-    static constexpr float lpfSoloFadeTimeMs = 20.0f; // Fade time in ms (adjust as needed)
+    // Latency changes found on the audio thread are handed to the message
+    // thread here; setLatencySamples() notifies listeners under a lock
+    void timerCallback() override;
+    std::atomic<bool> latencyChangePending { false };
 
-    //================== HPF to account for the insane low freq introduced =============
-    juce::dsp::IIR::Filter<float> highPassL, highPassR;
+    // Routing, filters, delay lines, oversampling, limiters: everything that
+    // touches the audio. The processor only feeds it settings and buffers.
+    FmEngineCore engine;
 
     // Pointers to your parameters
     juce::AudioParameterFloat* modDepthParam = nullptr;
@@ -145,49 +177,40 @@ private:
     juce::AudioParameterBool* oversamplingParam = nullptr;
     juce::AudioParameterBool* predelayParam = nullptr;
     juce::AudioParameterFloat* lpCutoffParam = nullptr;
-  
-    // Your DSP components (now two mono Delay instances)
-    InterpolatedDelay delayL, delayR; // One per carrier channel
-
-    float newBaseDelay = 0.0f;  // relevant to PREDELAY coordinating
-    float lastBaseDelay = 0.0f; // relevant to PREDELAY coordinating
-    
-    LowPass modulatorLowPassL;
-    LowPass modulatorLowPassR;
-
+    juce::AudioParameterBool* morphOnParam = nullptr;
+    juce::AudioParameterFloat* morphParam = nullptr;
+    juce::AudioParameterInt* morphAParam = nullptr;
+    juce::AudioParameterInt* morphBParam = nullptr;
+    juce::AudioParameterBool* offlineHqParam = nullptr;
+    juce::AudioParameterChoice* operatorsParam = nullptr;
 
-
-    // juce::SpinLock delayStateLock; // Thread Safety
+    // Same parameters in BinaryState::parameterTable order, for get/setStateInformation
+    BinaryState::ParameterList stateParameters {};
 
     // Flags to indicate when DSP objects need to be reset/re-prepared
     bool shouldResetDelay = true; // Ensure these are still present as in your original file
     bool shouldResetLowPass = true;
     int currentMaxBlockSize = 0;
-    juce::AudioBuffer<float> silentSidechainBuffer; // Used for silent sidechain input if bus is inactive
-
-    // Oversampler for 4 channels (quad)
-    juce::dsp::Oversampling<float> oversampler {
-        4, // number of channels
-        1, // number of oversampling stages (2x)
-        juce::dsp::Oversampling<float>::FilterType::filterHalfBandFIREquiripple,
-        true // process tail (anti-aliasing)
-    };
-
-    // for smoothing the modulation amount dial
-    float smoothedModDepth = 0.0f;
-    float modDepthSmoothingCoeff = 0.0f;
 
-    // smoothing the LPF slider
-    juce::SmoothedValue<float> smoothedCutoff;
-    float cutoffSmoothingCoeff = 0.0f;
+    // The input layouts isBusesLayoutSupported() accepts. Picked in
+    // prepareToPlay and on layout changes, never per block: only
+    // mainAndSidechain reads a sidechain; the others hand the engine none, and
+    // its routing runs the kernel without one
+    enum class InputLayout { mainOnly, sidechainDisabled, mainAndSidechain };
+    InputLayout inputLayout = InputLayout::mainAndSidechain;
+    void updateInputLayout();
 
-    // PREDELAY RELATED
+    bool lastReportedNonRealtime = false; // per instance, only touched by processBlock
+    bool reportedBlockSplit = false;      // once per prepare, only touched by processBlock
 
-    bool isOfflineMode = false;
+    // Diagnostics; logAudio() from processBlock, log() from everywhere else
+    EventLog eventLog;
 
     void updateLatency();
 
-    int lastReportedLatency = 0;
+    // Held from plugin load so the editor's images and fonts are decoded in the
+    // background before anyone opens it. Never touched by the audio thread.
+    juce::SharedResourcePointer<EditorResources> editorResources;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FmEngineAudioProcessor)
 };
\ No newline at end of file
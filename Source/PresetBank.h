@@ -0,0 +1,88 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+#include <array>
+#include <atomic>
+
+#include "BinaryState.h"
+
+/**
+ * Fixed bank of parameter snapshots for morphing.
+ *
+ * Each slot holds the plain values of the sound parameters (the first
+ * numValues entries of BinaryState::parameterTable; the morph controls
+ * themselves are not part of a snapshot). Storage is preallocated and every
+ * value is an atomic float, so the audio thread can read slots while the
+ * message thread stores into them. A slot being overwritten mid-block can be
+ * read half old, half new for one block; the morph smoothing hides that.
+ */
+class PresetBank
+{
+public:
+    static constexpr int numSlots = 8;
+    static constexpr int numValues = BinaryState::numSnapshotParameters;
+
+    // Positions in BinaryState::parameterTable
+    enum Index
+    {
+        modDepthIndex = 0,
+        maxDelayIndex,
+        algorithmIndex,
+        limiterIndex,
+        swapIndex,
+        oversamplingIndex,
+        predelayIndex,
+        lpCutoffIndex
+    };
+
+    /** Fills every slot with the parameters' defaults. Message thread. */
+    void resetToDefaults(const BinaryState::ParameterList& parameters)
+    {
+        for (int slot = 0; slot < numSlots; ++slot)
+            for (int i = 0; i < numValues; ++i)
+                if (auto* param = parameters[(size_t) i])
+                    setValue(slot, i, param->convertFrom0to1(param->getDefaultValue()));
+    }
+
+    /** Captures the current parameter values into a slot. Message thread. */
+    void store(int slot, const BinaryState::ParameterList& parameters)
+    {
+        if (!juce::isPositiveAndBelow(slot, numSlots))
+            return;
+
+        for (int i = 0; i < numValues; ++i)
+            if (auto* param = parameters[(size_t) i])
+                setValue(slot, i, param->convertFrom0to1(param->getValue()));
+    }
+
+    /** Pushes a slot's values to the parameters, notifying the host. Message thread. */
+    void recall(int slot, const BinaryState::ParameterList& parameters) const
+    {
+        if (!juce::isPositiveAndBelow(slot, numSlots))
+            return;
+
+        for (int i = 0; i < numValues; ++i)
+            if (auto* param = parameters[(size_t) i])
+                param->setValueNotifyingHost(param->convertTo0to1(getValue(slot, i)));
+    }
+
+    float getValue(int slot, int index) const noexcept
+    {
+        return values[(size_t) slot][(size_t) index].load(std::memory_order_relaxed);
+    }
+
+    void setValue(int slot, int index, float plainValue) noexcept
+    {
+        values[(size_t) slot][(size_t) index].store(plainValue, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::array<std::atomic<float>, (size_t) numValues>, (size_t) numSlots> values {};
+};
@@ -0,0 +1,267 @@
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "VisualizationComponent.h"
+
+namespace
+{
+    const juce::Colour panelText { 204, 204, 204 };
+    const juce::Colour gridColour { 70, 70, 70 };
+    const juce::Colour traceColour { 170, 170, 170 };
+    const juce::Colour gainReductionColour { 200, 120, 60 };
+
+    constexpr float spectrumFloorDb = -100.0f;
+}
+
+//==============================================================================
+// Reads the modulator FIFO, runs a Hann-windowed FFT every half frame and
+// publishes smoothed magnitudes in dB. All buffers are allocated up front.
+class VisualizationComponent::SpectrumAnalyser : public juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2 + 1;
+
+    explicit SpectrumAnalyser(VisualizationTap& tapToRead)
+        : juce::Thread("Modulator spectrum"), tap(tapToRead)
+    {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), fftSize,
+                                                                 juce::dsp::WindowingFunction<float>::hann, false);
+        smoothedDb.fill(spectrumFloorDb);
+        published.fill(spectrumFloorDb);
+    }
+
+    void run() override
+    {
+        // Whatever queued up while the panel was closed is stale
+        tap.setSpectrumAttached(true);
+        tap.discardPendingModulator();
+        samplesSinceLastFrame = 0;
+
+        while (!threadShouldExit())
+        {
+            const int numRead = tap.readModulator(readBuffer.data(), (int) readBuffer.size());
+            if (numRead == 0)
+            {
+                wait(10);
+                continue;
+            }
+
+            for (int i = 0; i < numRead; ++i)
+            {
+                history[(size_t) historyPos] = readBuffer[(size_t) i];
+                historyPos = (historyPos + 1) % fftSize;
+
+                if (++samplesSinceLastFrame >= fftSize / 2)
+                {
+                    samplesSinceLastFrame = 0;
+                    analyseFrame();
+                }
+            }
+        }
+
+        tap.setSpectrumAttached(false);
+    }
+
+    void copySpectrum(std::vector<float>& dest, double& rate)
+    {
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        dest.assign(published.begin(), published.end());
+        rate = tap.getModulatorRate();
+    }
+
+private:
+    void analyseFrame()
+    {
+        // Oldest sample first, windowed, into the real half of the FFT buffer
+        for (int i = 0; i < fftSize; ++i)
+            fftData[(size_t) i] = history[(size_t) ((historyPos + i) % fftSize)] * window[(size_t) i];
+
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+        fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+        // Hann coherent gain is 0.5, so a full-scale sine reads ~0 dB
+        const float normalisation = 4.0f / (float) fftSize;
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            const float db = juce::Decibels::gainToDecibels(fftData[(size_t) bin] * normalisation, spectrumFloorDb);
+            smoothedDb[(size_t) bin] = juce::jmax(db, 0.8f * smoothedDb[(size_t) bin] + 0.2f * db);
+        }
+
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        published = smoothedDb;
+    }
+
+    VisualizationTap& tap;
+    juce::dsp::FFT fft { fftOrder };
+
+    std::array<float, 4096> readBuffer {};
+    std::array<float, fftSize> history {};
+    std::array<float, fftSize> window {};
+    std::array<float, fftSize * 2> fftData {};
+    std::array<float, numBins> smoothedDb {};
+    int historyPos = 0;
+    int samplesSinceLastFrame = 0;
+
+    juce::SpinLock publishLock;
+    std::array<float, numBins> published {};
+};
+
+//==============================================================================
+VisualizationComponent::VisualizationComponent(VisualizationTap& tapToRead)
+    : tap(tapToRead),
+      analyser(std::make_unique<SpectrumAnalyser>(tapToRead)),
+      history((size_t) historyLength),
+      readScratch((size_t) VisualizationTap::summaryFifoSize),
+      displaySpectrum((size_t) SpectrumAnalyser::numBins, spectrumFloorDb)
+{
+    setOpaque(false);
+}
+
+VisualizationComponent::~VisualizationComponent()
+{
+    stopTimer();
+    analyser->stopThread(1000);
+}
+
+void VisualizationComponent::visibilityChanged()
+{
+    if (isVisible())
+    {
+        tap.discardPendingSummaries();
+        std::fill(history.begin(), history.end(), VisualizationTap::Summary {});
+        analyser->startThread(juce::Thread::Priority::low);
+        startTimerHz(30);
+    }
+    else
+    {
+        stopTimer();
+        analyser->stopThread(1000);
+    }
+}
+
+void VisualizationComponent::timerCallback()
+{
+    const int numRead = tap.readSummaries(readScratch.data(), (int) readScratch.size());
+    for (int i = 0; i < numRead; ++i)
+    {
+        history[(size_t) historyWritePos] = readScratch[(size_t) i];
+        historyWritePos = (historyWritePos + 1) % historyLength;
+    }
+
+    analyser->copySpectrum(displaySpectrum, displaySpectrumRate);
+    repaint();
+}
+
+//==============================================================================
+void VisualizationComponent::paint(juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+    auto scopeArea = area.removeFromTop(area.getHeight() * 0.5f).reduced(0.0f, 2.0f);
+    auto spectrumArea = area.reduced(0.0f, 2.0f);
+
+    paintScope(g, scopeArea);
+    paintSpectrum(g, spectrumArea);
+}
+
+void VisualizationComponent::paintScope(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    g.setColour(gridColour);
+    g.drawRect(area, 1.0f);
+
+    // Autoscale to the largest delay in view (at least 1 ms)
+    float rangeMs = 1.0f;
+    for (const auto& s : history)
+        rangeMs = juce::jmax(rangeMs, s.delayMaxMs);
+
+    const float columnWidth = area.getWidth() / (float) historyLength;
+    auto toY = [&](float ms) { return area.getBottom() - area.getHeight() * juce::jlimit(0.0f, 1.0f, ms / rangeMs); };
+
+    // Delay-time band: one min..max column per summary, oldest on the left
+    g.setColour(traceColour);
+    for (int i = 0; i < historyLength; ++i)
+    {
+        const auto& s = history[(size_t) ((historyWritePos + i) % historyLength)];
+        const float x = area.getX() + (float) i * columnWidth;
+        const float top = toY(s.delayMaxMs);
+        const float bottom = juce::jmax(toY(s.delayMinMs), top + 1.0f);
+        g.fillRect(x, top, juce::jmax(1.0f, columnWidth), bottom - top);
+    }
+
+    // Limiter gain reduction hangs from the top edge, 0..-12 dB
+    g.setColour(gainReductionColour.withAlpha(0.6f));
+    for (int i = 0; i < historyLength; ++i)
+    {
+        const auto& s = history[(size_t) ((historyWritePos + i) % historyLength)];
+        if (s.gainReductionDb < -0.05f)
+        {
+            const float x = area.getX() + (float) i * columnWidth;
+            g.fillRect(x, area.getY(), juce::jmax(1.0f, columnWidth),
+                       area.getHeight() * juce::jlimit(0.0f, 1.0f, -s.gainReductionDb / 12.0f));
+        }
+    }
+
+    const auto& latest = history[(size_t) ((historyWritePos + historyLength - 1) % historyLength)];
+    g.setColour(panelText);
+    g.setFont(resources->getInfoFont().withHeight(12.0f));
+    g.drawText("delay " + juce::String(latest.delayMinMs, 2) + "-" + juce::String(latest.delayMaxMs, 2)
+                   + " ms   mod rms " + juce::String(juce::Decibels::gainToDecibels(latest.modulatorRms), 1) + " dB",
+               area.reduced(4.0f, 2.0f), juce::Justification::topLeft, true);
+}
+
+void VisualizationComponent::paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    g.setColour(gridColour);
+    g.drawRect(area, 1.0f);
+
+    // Log frequency axis, 20 Hz to Nyquist; 0 to spectrumFloorDb vertically
+    const float nyquist = (float) displaySpectrumRate * 0.5f;
+    const float minHz = 20.0f;
+    const float logRange = std::log(nyquist / minHz);
+    const int numBins = (int) displaySpectrum.size();
+
+    for (float hz : { 100.0f, 1000.0f, 10000.0f })
+    {
+        if (hz >= nyquist)
+            continue;
+        const float x = area.getX() + area.getWidth() * std::log(hz / minHz) / logRange;
+        g.drawVerticalLine(juce::roundToInt(x), area.getY(), area.getBottom());
+    }
+
+    juce::Path spectrum;
+    bool started = false;
+
+    for (int bin = 1; bin < numBins; ++bin)
+    {
+        const float hz = nyquist * (float) bin / (float) (numBins - 1);
+        if (hz < minHz)
+            continue;
+
+        const float x = area.getX() + area.getWidth() * std::log(hz / minHz) / logRange;
+        const float y = juce::jmap(displaySpectrum[(size_t) bin], spectrumFloorDb, 0.0f, area.getBottom(), area.getY());
+
+        if (!started)
+        {
+            spectrum.startNewSubPath(x, y);
+            started = true;
+        }
+        else
+        {
+            spectrum.lineTo(x, y);
+        }
+    }
+
+    g.setColour(traceColour);
+    g.strokePath(spectrum, juce::PathStrokeType(1.0f));
+
+    g.setColour(panelText);
+    g.setFont(resources->getInfoFont().withHeight(12.0f));
+    g.drawText("modulator spectrum", area.reduced(4.0f, 2.0f), juce::Justification::topLeft, true);
+}
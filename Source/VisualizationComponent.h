@@ -0,0 +1,55 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "VisualizationTap.h"
+#include "EditorResources.h"
+
+/**
+ * Scrolling delay-time scope (top) and modulator spectrum (bottom), fed by the
+ * processor's VisualizationTap. Lives in the hidden control panel.
+ *
+ * Only does work while visible: the timer pulls summaries on the message
+ * thread, and a background thread reads the modulator FIFO and runs the FFT.
+ * Nothing here ever touches the audio thread.
+ */
+class VisualizationComponent : public juce::Component, private juce::Timer
+{
+public:
+    explicit VisualizationComponent(VisualizationTap& tapToRead);
+    ~VisualizationComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+
+private:
+    class SpectrumAnalyser;
+
+    void timerCallback() override;
+    void paintScope(juce::Graphics& g, juce::Rectangle<float> area);
+    void paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area);
+
+    VisualizationTap& tap;
+    std::unique_ptr<SpectrumAnalyser> analyser;
+    juce::SharedResourcePointer<EditorResources> resources;
+
+    // Scope history: one column per summary, oldest at historyWritePos
+    static constexpr int historyLength = 400; // ~2 s at 200 summaries/s
+    std::vector<VisualizationTap::Summary> history;
+    std::vector<VisualizationTap::Summary> readScratch;
+    int historyWritePos = 0;
+
+    // Latest analyser output in dB, copied out on the message thread
+    std::vector<float> displaySpectrum;
+    double displaySpectrumRate = 48000.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VisualizationComponent)
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+// Projucer build
+#include "JuceHeader.h"
+#else
+// CMake build: include only the modules you need
+#include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+/**
+ * One-way channel from the audio thread to the editor's scope and spectrum.
+ *
+ * The audio thread calls pushBlock() once per processed block, whether or not
+ * an editor is open. It folds the block into a running summary (delay-time
+ * range, modulator RMS, limiter gain reduction) that is emitted every
+ * ~summaryIntervalMs. While a spectrum consumer is attached it also writes a
+ * decimated mono copy of the filtered modulator, low-passed first so the
+ * spectrum shows no aliases; with none, that per-sample path is skipped.
+ * Both go into fixed-size AbstractFifos; when nobody is reading they fill up
+ * and further writes are dropped, so the audio-side cost is a short loop over
+ * the block and never waits.
+ *
+ * Single producer (audio thread), one consumer per FIFO: the editor's timer
+ * reads summaries, its analysis thread reads modulator samples.
+ */
+class VisualizationTap
+{
+public:
+    struct Summary
+    {
+        float delayMinMs = 0.0f;
+        float delayMaxMs = 0.0f;
+        float modulatorRms = 0.0f;
+        float gainReductionDb = 0.0f; // <= 0
+    };
+
+    static constexpr int summaryFifoSize = 1024;
+    static constexpr int modulatorFifoSize = 16384;
+    static constexpr double summaryIntervalMs = 5.0;
+    static constexpr double maxModulatorRate = 48000.0; // higher rates are decimated down to this
+
+    //==============================================================================
+    // Audio thread
+
+    /** Called from prepareToPlay. Only resets the producer's own state. */
+    void prepare(double sampleRate)
+    {
+        summaryInterval = juce::jmax(1, juce::roundToInt(sampleRate * summaryIntervalMs * 0.001));
+        decimation = juce::jmax(1, juce::roundToInt(sampleRate / maxModulatorRate));
+        decimationPhase = 0;
+        resetAccumulator();
+
+        // 8th-order Butterworth at 0.4 of the decimated rate: whatever would
+        // fold back below that is down by 30 dB or more
+        static constexpr double butterworthQ[numAntiAliasStages] = { 0.5098, 0.6013, 0.9000, 2.5629 };
+        const double cutoff = 0.4 * sampleRate / decimation;
+
+        for (int stage = 0; stage < numAntiAliasStages; ++stage)
+        {
+            antiAlias[(size_t) stage].setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, cutoff, butterworthQ[stage]));
+            antiAlias[(size_t) stage].reset();
+        }
+
+        summaryRate.store(sampleRate / summaryInterval);
+        modulatorRate.store(sampleRate / decimation);
+    }
+
+    /** delayMinMs/delayMaxMs: range of the instantaneous delay over the block.
+        modL/modR: the filtered, depth-scaled modulator fed to the delay lines. */
+    void pushBlock(float delayMinMs, float delayMaxMs, const float* modL, const float* modR,
+                   int numSamples, float gainReductionDb) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        accumulator.delayMinMs = juce::jmin(accumulator.delayMinMs, delayMinMs);
+        accumulator.delayMaxMs = juce::jmax(accumulator.delayMaxMs, delayMaxMs);
+        accumulator.gainReductionDb = juce::jmin(accumulator.gainReductionDb, gainReductionDb);
+
+        const bool spectrum = spectrumAttached.load(std::memory_order_relaxed);
+
+        // Picked up again after a pause: the filters hold long-gone samples
+        if (spectrum && ! spectrumWasAttached)
+        {
+            for (auto& stage : antiAlias)
+                stage.reset();
+
+            decimationPhase = 0;
+        }
+
+        spectrumWasAttached = spectrum;
+
+        // Mono mid of the modulator: squared for the RMS, decimated for the spectrum
+        std::array<float, 256> decimated;
+        int numDecimated = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float mid = 0.5f * (modL[i] + modR[i]);
+            sumOfSquares += mid * mid;
+
+            if (! spectrum)
+                continue;
+
+            if (decimation > 1)
+                for (auto& stage : antiAlias)
+                    mid = stage.processSingleSampleRaw(mid);
+
+            if (++decimationPhase >= decimation)
+            {
+                decimationPhase = 0;
+                decimated[(size_t) numDecimated++] = mid;
+
+                if (numDecimated == (int) decimated.size())
+                {
+                    write(modulatorFifo, modulatorSamples.data(), decimated.data(), numDecimated);
+                    numDecimated = 0;
+                }
+            }
+        }
+
+        write(modulatorFifo, modulatorSamples.data(), decimated.data(), numDecimated);
+
+        accumulatedSamples += numSamples;
+        if (accumulatedSamples >= summaryInterval)
+        {
+            accumulator.modulatorRms = std::sqrt(sumOfSquares / (float) accumulatedSamples);
+            write(summaryFifo, summaries.data(), &accumulator, 1);
+            resetAccumulator();
+        }
+    }
+
+    //==============================================================================
+    // Consumers
+
+    int readSummaries(Summary* dest, int maxToRead) noexcept
+    {
+        return read(summaryFifo, summaries.data(), dest, maxToRead);
+    }
+
+    int readModulator(float* dest, int maxToRead) noexcept
+    {
+        return read(modulatorFifo, modulatorSamples.data(), dest, maxToRead);
+    }
+
+    /** Set by the spectrum's reader while it runs; the modulator FIFO is only
+        fed (and its anti-alias filters only run) in between. */
+    void setSpectrumAttached(bool attached) noexcept { spectrumAttached.store(attached); }
+
+    /** Throws away whatever piled up while nobody was reading. */
+    void discardPendingSummaries() noexcept  { summaryFifo.finishedRead(summaryFifo.getNumReady()); }
+    void discardPendingModulator() noexcept  { modulatorFifo.finishedRead(modulatorFifo.getNumReady()); }
+
+    double getSummaryRate() const noexcept   { return summaryRate.load(); }
+    double getModulatorRate() const noexcept { return modulatorRate.load(); }
+
+private:
+    void resetAccumulator() noexcept
+    {
+        accumulator = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f, 0.0f };
+        sumOfSquares = 0.0f;
+        accumulatedSamples = 0;
+    }
+
+    template <typename Type>
+    static void write(juce::AbstractFifo& fifo, Type* storage, const Type* source, int numItems) noexcept
+    {
+        if (numItems <= 0)
+            return;
+
+        // Drops the whole write if it does not fit: no consumer, or it fell behind
+        if (fifo.getFreeSpace() < numItems)
+            return;
+
+        const auto scope = fifo.write(numItems);
+        std::copy(source, source + scope.blockSize1, storage + scope.startIndex1);
+        std::copy(source + scope.blockSize1, source + numItems, storage + scope.startIndex2);
+    }
+
+    template <typename Type>
+    static int read(juce::AbstractFifo& fifo, const Type* storage, Type* dest, int maxToRead) noexcept
+    {
+        const auto scope = fifo.read(juce::jmin(maxToRead, fifo.getNumReady()));
+        std::copy(storage + scope.startIndex1, storage + scope.startIndex1 + scope.blockSize1, dest);
+        std::copy(storage + scope.startIndex2, storage + scope.startIndex2 + scope.blockSize2, dest + scope.blockSize1);
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    // Producer state (audio thread only)
+    Summary accumulator;
+    float sumOfSquares = 0.0f;
+    int accumulatedSamples = 0;
+    int summaryInterval = 240;
+    int decimation = 1;
+    int decimationPhase = 0;
+
+    static constexpr int numAntiAliasStages = 4;
+    std::array<juce::IIRFilter, numAntiAliasStages> antiAlias;
+    bool spectrumWasAttached = false;
+
+    std::atomic<bool> spectrumAttached { false };
+
+    std::atomic<double> summaryRate { 200.0 };
+    std::atomic<double> modulatorRate { 48000.0 };
+
+    juce::AbstractFifo summaryFifo { summaryFifoSize };
+    juce::AbstractFifo modulatorFifo { modulatorFifoSize };
+    std::array<Summary, summaryFifoSize> summaries {};
+    std::array<float, modulatorFifoSize> modulatorSamples {};
+};
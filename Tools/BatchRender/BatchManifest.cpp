@@ -0,0 +1,96 @@
+#include "BatchManifest.h"
+
+namespace BatchManifest
+{
+    namespace
+    {
+        bool parseParameter(const juce::String& token, std::array<float, (size_t) FM_ENGINE_NUM_PARAMS>& parameters)
+        {
+            const auto name = token.upToFirstOccurrenceOf("=", false, false).trim();
+            const auto value = token.fromFirstOccurrenceOf("=", false, false).trim();
+            const auto param = fm_engine_param_from_name(name.toRawUTF8());
+
+            if (param == FM_ENGINE_NUM_PARAMS || value.isEmpty() || !token.containsChar('='))
+                return false;
+
+            parameters[(size_t) param] = value.getFloatValue();
+            return true;
+        }
+    }
+
+    bool parse(const juce::File& manifestFile, std::vector<BatchJob>& jobs, juce::String& error)
+    {
+        if (!manifestFile.existsAsFile())
+        {
+            error = "manifest not found: " + manifestFile.getFullPathName();
+            return false;
+        }
+
+        const auto baseFolder = manifestFile.getParentDirectory();
+
+        std::array<float, (size_t) FM_ENGINE_NUM_PARAMS> defaults {};
+        for (int i = 0; i < FM_ENGINE_NUM_PARAMS; ++i)
+            defaults[(size_t) i] = fm_engine_param_default((fm_engine_param) i);
+        defaults[FM_ENGINE_PARAM_RENDER_QUALITY] = 1.0f;
+
+        juce::StringArray lines;
+        manifestFile.readLines(lines);
+
+        for (int lineIndex = 0; lineIndex < lines.size(); ++lineIndex)
+        {
+            const auto line = lines[lineIndex].upToFirstOccurrenceOf("#", false, false).trim();
+            if (line.isEmpty())
+                continue;
+
+            juce::StringArray tokens;
+            tokens.addTokens(line, " \t", "\"");
+            tokens.removeEmptyStrings();
+
+            const auto where = manifestFile.getFileName() + ":" + juce::String(lineIndex + 1) + ": ";
+
+            if (tokens[0] == "defaults")
+            {
+                for (int t = 1; t < tokens.size(); ++t)
+                {
+                    if (!parseParameter(tokens[t], defaults))
+                    {
+                        error = where + "not a parameter: " + tokens[t];
+                        return false;
+                    }
+                }
+                continue;
+            }
+
+            if (tokens.size() < 3)
+            {
+                error = where + "expected carrier, modulator and output";
+                return false;
+            }
+
+            auto resolve = [&baseFolder](const juce::String& path)
+            {
+                return baseFolder.getChildFile(path.unquoted());
+            };
+
+            BatchJob job;
+            job.carrier = resolve(tokens[0]);
+            job.modulator = tokens[1] == "-" ? juce::File() : resolve(tokens[1]);
+            job.output = resolve(tokens[2]);
+            job.parameters = defaults;
+            job.lineNumber = lineIndex + 1;
+
+            for (int t = 3; t < tokens.size(); ++t)
+            {
+                if (!parseParameter(tokens[t], job.parameters))
+                {
+                    error = where + "not a parameter: " + tokens[t];
+                    return false;
+                }
+            }
+
+            jobs.push_back(job);
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_formats/juce_audio_formats.h>
+#endif
+
+#include "fm_engine.h"
+
+#include <array>
+#include <vector>
+
+/**
+ * One render: carrier through the engine, modulated by the modulator file
+ * (the sidechain), written to output.
+ */
+struct BatchJob
+{
+    juce::File carrier;
+    juce::File modulator; // juce::File() for none (silent sidechain); ALGORITHM=0 takes its modulator from the carrier's right channel anyway
+    juce::File output;
+
+    // Every engine parameter, so a reused engine carries nothing over
+    std::array<float, (size_t) FM_ENGINE_NUM_PARAMS> parameters {};
+
+    int lineNumber = 0;
+};
+
+/**
+ * Manifest: one job per line, whitespace separated, "quotes" around paths
+ * with spaces. Relative paths are taken from the manifest's folder.
+ *
+ *   # carrier            modulator        output               parameters
+ *   drums/loop01.wav     mods/saw.wav     out/loop01_fm.wav    MOD_DEPTH=0.4 ALGORITHM=2
+ *   vox/take3.wav        -                out/take3_self.wav   LP_CUTOFF=800
+ *
+ *   defaults LIMITER=1 MAX_DELAY_MS=2
+ *
+ * "-" means no modulator. Parameter names are the plugin's IDs (see
+ * fm_engine_param_from_name). A "defaults" line sets the starting values
+ * for the jobs after it. Before any, every parameter has the engine's
+ * default, except that the offline render profile (RENDER_QUALITY) is on,
+ * as it is for a bounce in the plugin.
+ */
+namespace BatchManifest
+{
+    /** Parses the manifest, or returns false with a message naming the line. */
+    bool parse(const juce::File& manifestFile, std::vector<BatchJob>& jobs, juce::String& error);
+}
@@ -0,0 +1,369 @@
+// Offline batch renderer: runs the engine core over a manifest of
+// carrier/modulator file pairs on every core.
+//
+// Each worker thread owns one engine (prepared once per sample rate, reset
+// between files) and its own readers and buffers, so workers share nothing
+// but the job list and the thread their encoders run on. Jobs are whole
+// files, spread over the workers by a work-stealing pool so a few long files
+// do not leave most cores idle at the end of the run. Output is a stereo
+// WAV per job, aligned to the carrier (the engine's latency is trimmed) and
+// the same length.
+//
+// With --chunk-seconds, files longer than that are cut into chunks that
+// render in parallel as well. Each chunk starts with a pre-roll of the audio
+// before it (fm_engine_get_warmup: the longest delay plus filter settling),
+// so the engine is in the state an uninterrupted render would have reached,
+// and the chunks are stitched back in order with a short crossfade. The
+// stitched file is not bit-identical to a serial render: the float filters
+// at low cutoffs never forget their rounding history completely.
+// --verify-seams measures by how much, by rendering every chunked file
+// serially as well and comparing.
+//
+// With --cache=<dir>, finished renders are kept in a content-addressed cache
+// (RenderCache.h): a job whose input files, parameters, bit depth and engine
+// build match an earlier one is copied from there instead of rendered. The
+// cache is trimmed to --cache-size-mb (least recently used first) at the end
+// of the run. A cache implies --deterministic: the engines run in their
+// deterministic mode and every file renders whole, so what is stored is
+// exactly what a render on any thread, with any block size, would write.
+//
+// The manifest format is described in BatchManifest.h.
+//
+// Usage:
+//   FM_Engine_batch <manifest> [--threads=N] [--block-size=1024]
+//                   [--bit-depth=16|24|32] [--verbose]
+//                   [--chunk-seconds=S] [--verify-seams] [--seam-tolerance-db=dB]
+//                   [--deterministic] [--cache=<dir>] [--cache-size-mb=4096]
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_formats/juce_audio_formats.h>
+#endif
+
+#include "BatchManifest.h"
+#include "ChunkedOutput.h"
+#include "JobRenderer.h"
+#include "RenderCache.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // A whole job, or one chunk of a long one
+    struct WorkItem
+    {
+        int job = 0;
+        int chunk = -1;
+    };
+
+    constexpr double seamCrossfadeMs = 10.0;
+    constexpr int defaultCacheSizeMb = 4096;
+
+    juce::String toDb(double gain)
+    {
+        return juce::String(gain > 0.0 ? 20.0 * std::log10(gain) : -200.0, 1);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args[0].isOption())
+    {
+        std::cerr << "Usage: FM_Engine_batch <manifest> [--threads=N] [--block-size=1024] "
+                     "[--bit-depth=16|24|32] [--verbose] [--chunk-seconds=S] [--verify-seams] "
+                     "[--seam-tolerance-db=dB] [--deterministic] [--cache=<dir>] [--cache-size-mb=4096]" << std::endl;
+        return 2;
+    }
+
+    const auto manifestFile = args[0].resolveAsFile();
+
+    std::vector<BatchJob> jobs;
+    juce::String error;
+    if (! BatchManifest::parse(manifestFile, jobs, error))
+    {
+        std::cerr << error << std::endl;
+        return 2;
+    }
+
+    int blockSize = args.getValueForOption("--block-size").getIntValue();
+    if (blockSize <= 0)
+        blockSize = 1024;
+
+    std::unique_ptr<RenderCache> cache;
+    if (args.getValueForOption("--cache").isNotEmpty())
+    {
+        const auto cacheSizeOption = args.getValueForOption("--cache-size-mb");
+        const auto cacheSizeMb = cacheSizeOption.isNotEmpty() ? juce::jmax(0, cacheSizeOption.getIntValue()) : defaultCacheSizeMb;
+        cache = std::make_unique<RenderCache>(juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--cache")),
+                                              (juce::int64) cacheSizeMb * 1024 * 1024);
+    }
+
+    // Chunk seams are not bit-exact, so deterministic renders are whole files
+    const bool deterministic = cache != nullptr || args.containsOption("--deterministic");
+    double chunkSeconds = juce::jmax(0.0, args.getValueForOption("--chunk-seconds").getDoubleValue());
+
+    if (deterministic && chunkSeconds > 0.0)
+    {
+        std::cerr << "--chunk-seconds ignored: deterministic renders are not split" << std::endl;
+        chunkSeconds = 0.0;
+    }
+
+    const bool verifySeams = chunkSeconds > 0.0 && args.containsOption("--verify-seams");
+    const bool hasSeamTolerance = args.getValueForOption("--seam-tolerance-db").isNotEmpty();
+    const double seamToleranceDb = args.getValueForOption("--seam-tolerance-db").getDoubleValue();
+
+    // Verification compares floats; quantised output would hide the seams
+    int bitDepth = args.getValueForOption("--bit-depth").getIntValue();
+    if (verifySeams)
+        bitDepth = 32;
+    else if (bitDepth != 16 && bitDepth != 32)
+        bitDepth = 24;
+
+    const bool verbose = args.containsOption("--verbose");
+
+    // Plan: a file longer than a chunk gets its writer up front and one item per chunk
+    std::vector<WorkItem> items;
+    std::vector<std::unique_ptr<ChunkedOutput>> chunkedOutputs(jobs.size());
+    std::vector<juce::String> jobErrors(jobs.size());
+    int numChunked = 0, numChunks = 0;
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    for (int j = 0; j < (int) jobs.size(); ++j)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        if (chunkSeconds > 0.0)
+            reader.reset(formatManager.createReaderFor(jobs[(size_t) j].carrier));
+
+        const auto chunkFrames = reader != nullptr ? (juce::int64) (chunkSeconds * reader->sampleRate) : 0;
+
+        if (reader == nullptr || reader->lengthInSamples <= chunkFrames)
+        {
+            items.push_back({ j, -1 }); // whole; a file that cannot be read fails in there
+            continue;
+        }
+
+        auto writer = JobRenderer::createWriter(jobs[(size_t) j].output, reader->sampleRate, bitDepth, error);
+        if (writer == nullptr)
+        {
+            jobErrors[(size_t) j] = "line " + juce::String(jobs[(size_t) j].lineNumber) + ": " + error;
+            continue;
+        }
+
+        const int overlapFrames = (int) std::lround(seamCrossfadeMs * 0.001 * reader->sampleRate);
+        auto& output = chunkedOutputs[(size_t) j];
+        output = std::make_unique<ChunkedOutput>(std::move(writer), reader->lengthInSamples, chunkFrames, overlapFrames);
+
+        for (int c = 0; c < output->getNumChunks(); ++c)
+            items.push_back({ j, c });
+
+        ++numChunked;
+        numChunks += output->getNumChunks();
+    }
+
+    // Besides the engines there is one writer thread, shared, and a decoder
+    // per worker that wakes to convert a block ahead. One core is left for
+    // those, so the engines are not preempted by their own I/O
+    int numThreads = args.getValueForOption("--threads").getIntValue();
+    if (numThreads <= 0)
+        numThreads = juce::jmax(1, WorkStealingPool::defaultNumWorkers() - 1);
+    numThreads = juce::jmin(numThreads, juce::jmax(1, (int) items.size()));
+
+    // Declared before the renderers, so it outlives their encoders
+    juce::TimeSliceThread writerThread { "FM_Engine_batch writer" };
+    writerThread.startThread();
+
+    std::vector<std::unique_ptr<JobRenderer>> renderers;
+    for (int i = 0; i < numThreads; ++i)
+        renderers.push_back(std::make_unique<JobRenderer>(blockSize, bitDepth, deterministic, writerThread));
+
+    std::vector<JobRenderer::Result> results(items.size());
+    std::mutex printLock;
+
+    auto report = [&printLock](bool ok, const juce::String& message)
+    {
+        const std::lock_guard<std::mutex> guard(printLock);
+        (ok ? std::cout : std::cerr) << message << std::endl;
+    };
+
+    WorkStealingPool pool(numThreads);
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    // Chunks are dealt out in order, so they finish roughly in order and few
+    // wait in memory for an earlier one
+    const auto dealing = numChunked > 0 ? WorkStealingPool::Dealing::interleaved
+                                        : WorkStealingPool::Dealing::contiguous;
+
+    const auto workerStats = pool.run((int) items.size(), [&](int worker, int itemIndex)
+    {
+        const auto& item = items[(size_t) itemIndex];
+        const auto& job = jobs[(size_t) item.job];
+        auto& renderer = *renderers[(size_t) worker];
+        auto& result = results[(size_t) itemIndex];
+
+        if (item.chunk < 0)
+        {
+            const auto startTime = juce::Time::getMillisecondCounterHiRes();
+            const auto key = cache != nullptr ? cache->computeKey(job, bitDepth) : juce::String();
+
+            if (key.isNotEmpty() && cache->fetch(key, job.output))
+            {
+                result.ok = result.cached = true;
+                result.seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+            }
+            else
+            {
+                result = renderer.render(job);
+
+                if (result.ok && key.isNotEmpty() && ! cache->store(key, job.output))
+                    report(false, "line " + juce::String(job.lineNumber) + ": cannot add to the cache in "
+                                  + cache->getDirectory().getFullPathName());
+            }
+        }
+        else
+        {
+            auto& output = *chunkedOutputs[(size_t) item.job];
+            juce::AudioBuffer<float> chunk;
+
+            result = renderer.renderChunk(job, output.getChunkStart(item.chunk),
+                                          output.getChunkRenderLength(item.chunk), chunk);
+            result.frames = output.getChunkLength(item.chunk);
+
+            if (result.ok && ! output.submit(item.chunk, std::move(chunk)))
+            {
+                result.ok = false;
+                result.error = "line " + juce::String(job.lineNumber) + ": write failed: " + job.output.getFullPathName();
+            }
+        }
+
+        if (! result.ok)
+            report(false, result.error);
+        else if (verbose)
+            report(true, job.output.getFileName() + (item.chunk >= 0 ? " chunk " + juce::String(item.chunk) : juce::String())
+                         + ": " + juce::String(result.seconds, 2) + " s on worker " + juce::String(worker)
+                         + (result.cached ? " (cached)" : ""));
+    }, dealing);
+
+    // Close the stitched files; a job fails if any of its items did
+    for (size_t i = 0; i < items.size(); ++i)
+        if (! results[i].ok && jobErrors[(size_t) items[i].job].isEmpty())
+            jobErrors[(size_t) items[i].job] = results[i].error;
+
+    for (size_t j = 0; j < jobs.size(); ++j)
+        if (chunkedOutputs[j] != nullptr && ! chunkedOutputs[j]->finish() && jobErrors[j].isEmpty())
+            jobErrors[j] = "line " + juce::String(jobs[j].lineNumber) + ": incomplete " + jobs[j].output.getFullPathName();
+
+    const double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    // Seam verification: every chunked file against a serial render
+    if (verifySeams)
+    {
+        std::vector<int> toVerify;
+        for (int j = 0; j < (int) jobs.size(); ++j)
+            if (chunkedOutputs[(size_t) j] != nullptr && jobErrors[(size_t) j].isEmpty())
+                toVerify.push_back(j);
+
+        const auto chunkFramesFor = [&](int j)
+        {
+            return chunkedOutputs[(size_t) j]->getChunkLength(0);
+        };
+
+        pool.run((int) toVerify.size(), [&](int worker, int item)
+        {
+            const int j = toVerify[(size_t) item];
+            const auto& job = jobs[(size_t) j];
+            const auto comparison = renderers[(size_t) worker]->compareWithOutput(job);
+
+            if (! comparison.ok)
+            {
+                jobErrors[(size_t) j] = comparison.error;
+                report(false, comparison.error);
+                return;
+            }
+
+            const double maxErrorDb = comparison.maxError > 0.0f ? 20.0 * std::log10(comparison.maxError) : -200.0;
+            const bool withinTolerance = ! hasSeamTolerance || maxErrorDb <= seamToleranceDb;
+
+            const auto message = job.output.getFileName() + ": " + juce::String(chunkedOutputs[(size_t) j]->getNumChunks())
+                               + " chunks, max error " + toDb(comparison.maxError) + " dBFS at frame "
+                               + juce::String(comparison.maxErrorFrame) + " ("
+                               + juce::String(comparison.maxErrorFrame % chunkFramesFor(j)) + " into its chunk), error "
+                               + toDb(std::sqrt(comparison.errorSquares / juce::jmax(1.0e-30, comparison.signalSquares)))
+                               + " dB relative to the signal";
+
+            if (! withinTolerance)
+                jobErrors[(size_t) j] = message + ", over the " + juce::String(seamToleranceDb, 1) + " dBFS tolerance";
+
+            report(withinTolerance, withinTolerance ? message : jobErrors[(size_t) j]);
+        });
+    }
+
+    // Report
+    int failed = 0;
+    for (const auto& jobError : jobErrors)
+        failed += jobError.isNotEmpty() ? 1 : 0;
+
+    double audioSeconds = 0.0;
+    juce::int64 frames = 0;
+
+    for (const auto& result : results)
+    {
+        if (! result.ok || result.cached)
+            continue;
+
+        frames += result.frames;
+        audioSeconds += (double) result.frames / result.sampleRate;
+    }
+
+    int minItems = std::numeric_limits<int>::max(), maxItems = 0, steals = 0, prepares = 0;
+    double busySeconds = 0.0;
+
+    for (size_t w = 0; w < workerStats.size(); ++w)
+    {
+        minItems = juce::jmin(minItems, workerStats[w].itemsRun);
+        maxItems = juce::jmax(maxItems, workerStats[w].itemsRun);
+        steals += workerStats[w].itemsStolen;
+        busySeconds += workerStats[w].busySeconds;
+        prepares += renderers[w]->getNumPrepares();
+    }
+
+    std::cout << "jobs:      " << ((int) jobs.size() - failed) << " ok, " << failed << " failed";
+    if (numChunked > 0)
+        std::cout << " (" << numChunked << " split into " << numChunks << " chunks)";
+
+    std::cout << "\n"
+              << "workers:   " << numThreads << " (" << minItems << "-" << maxItems << " items each, "
+              << steals << " stolen, " << prepares << " engine prepares)\n"
+              << "audio:     " << juce::String(audioSeconds / 3600.0, 3) << " h in "
+              << juce::String(wallSeconds, 2) << " s = "
+              << juce::String(wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0, 1) << "x realtime, "
+              << juce::String(wallSeconds > 0.0 ? frames / wallSeconds * 1.0e-6 : 0.0, 2) << " M frames/s\n"
+              << "busy:      " << juce::String(wallSeconds > 0.0 ? 100.0 * busySeconds / (wallSeconds * numThreads) : 0.0, 1)
+              << " % of worker time" << std::endl;
+
+    if (cache != nullptr)
+    {
+        const auto trimmed = cache->trim();
+        std::cout << "cache:     " << cache->getNumHits() << " hits, " << cache->getNumMisses() << " misses; "
+                  << trimmed.entries << " entries, " << juce::String(trimmed.bytes / (1024.0 * 1024.0), 1) << " MB";
+
+        if (trimmed.evicted > 0)
+            std::cout << " after evicting " << trimmed.evicted << " (" << juce::String(trimmed.evictedBytes / (1024.0 * 1024.0), 1) << " MB)";
+
+        std::cout << std::endl;
+    }
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "BlockDecoder.h"
+
+BlockDecoder::BlockDecoder(int blockSizeIn, int numSlots)
+    : blockSize(blockSizeIn), fifo(numSlots)
+{
+    // AbstractFifo keeps one slot free to tell full from empty, so this is
+    // numSlots - 1 blocks of read-ahead
+    slots.resize((size_t) numSlots);
+    for (auto& slot : slots)
+        slot.setSize(4, blockSize);
+}
+
+BlockDecoder::~BlockDecoder()
+{
+    stop();
+}
+
+void BlockDecoder::start(juce::AudioFormatReader& carrier, juce::AudioFormatReader* modulator,
+                         juce::int64 firstFrame, juce::int64 numBlocks)
+{
+    stop();
+
+    fifo.reset();
+    stopping = finished = false;
+    error.clear();
+    thread = std::thread([this, &carrier, modulator, firstFrame, numBlocks]
+                         { decode(carrier, modulator, firstFrame, numBlocks); });
+}
+
+void BlockDecoder::stop()
+{
+    {
+        const std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+
+    moved.notify_all();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+juce::String BlockDecoder::getError() const
+{
+    const std::lock_guard<std::mutex> guard(lock);
+    return error;
+}
+
+void BlockDecoder::decode(juce::AudioFormatReader& carrier, juce::AudioFormatReader* modulator,
+                          juce::int64 position, juce::int64 numBlocks)
+{
+    for (juce::int64 block = 0; block < numBlocks; ++block)
+    {
+        int start1, size1, start2, size2;
+
+        {
+            // Full: the engine is behind, which is where it should be
+            std::unique_lock<std::mutex> guard(lock);
+            moved.wait(guard, [this] { return stopping || fifo.getFreeSpace() > 0; });
+
+            if (stopping)
+                return;
+
+            fifo.prepareToWrite(1, start1, size1, start2, size2);
+        }
+
+        // Stereo views, so a mono file is read into both channels
+        auto* const* channels = slots[(size_t) start1].getArrayOfWritePointers();
+        juce::AudioBuffer<float> carrierChannels(channels, 2, blockSize);
+        juce::AudioBuffer<float> modulatorChannels(channels + 2, 2, blockSize);
+
+        // Memory-mapped readers convert straight from the mapping; the others
+        // do their file reads here, off the engine's thread
+        const bool ok = carrier.read(&carrierChannels, 0, blockSize, position, true, true)
+                        && (modulator == nullptr || modulator->read(&modulatorChannels, 0, blockSize, position, true, true));
+
+        {
+            const std::lock_guard<std::mutex> guard(lock);
+
+            if (! ok)
+            {
+                error = "read failed at frame " + juce::String(position);
+                finished = true;
+            }
+            else
+            {
+                fifo.finishedWrite(1);
+            }
+        }
+
+        moved.notify_all();
+
+        if (! ok)
+            return;
+
+        position += blockSize;
+    }
+
+    {
+        const std::lock_guard<std::mutex> guard(lock);
+        finished = true;
+    }
+
+    moved.notify_all();
+}
+
+const juce::AudioBuffer<float>* BlockDecoder::waitForBlock()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    moved.wait(guard, [this] { return fifo.getNumReady() > 0 || finished || stopping; });
+
+    // Blocks written before a failure are still good
+    if (fifo.getNumReady() == 0)
+    {
+        if (error.isEmpty())
+            error = stopping ? "decoder stopped" : "read past the end of the decoded range";
+
+        return nullptr;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    return &slots[(size_t) start1];
+}
+
+void BlockDecoder::releaseBlock()
+{
+    {
+        const std::lock_guard<std::mutex> guard(lock);
+        fifo.finishedRead(1);
+    }
+
+    moved.notify_all();
+}
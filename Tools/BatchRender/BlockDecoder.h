@@ -0,0 +1,69 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_formats/juce_audio_formats.h>
+#endif
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * The decode stage of a render: a thread that reads carrier and modulator
+ * blocks ahead of the engine and converts them to float, into a ring of
+ * preallocated slots.
+ *
+ * One producer (the decode thread), one consumer (the worker running the
+ * engine), linked by an AbstractFifo over the slot indices. A side that finds
+ * the ring full or empty sleeps on a condition variable until the other side
+ * moves; the ring is deep enough that in steady state that is the decoder,
+ * waiting for the engine.
+ *
+ * Each slot holds four channels: carrier L/R, then modulator L/R. Past the
+ * end of the files the readers fill with silence, so a render can ask for
+ * more blocks than the files hold to flush the engine's latency out.
+ */
+class BlockDecoder
+{
+public:
+    explicit BlockDecoder(int blockSize, int numSlots = 16);
+    ~BlockDecoder();
+
+    /** Starts decoding numBlocks blocks from firstFrame. The readers must
+        outlive stop(). */
+    void start(juce::AudioFormatReader& carrier, juce::AudioFormatReader* modulator,
+               juce::int64 firstFrame, juce::int64 numBlocks);
+
+    /** Consumer: the next block, waiting for it if need be. Stays valid until
+        releaseBlock(). Null once a read has failed, or past the numBlocks
+        asked for; getError() says which. */
+    const juce::AudioBuffer<float>* waitForBlock();
+    void releaseBlock();
+
+    juce::String getError() const;
+
+    /** Ends the decode thread; blocks not consumed are dropped. */
+    void stop();
+
+private:
+    void decode(juce::AudioFormatReader& carrier, juce::AudioFormatReader* modulator,
+                juce::int64 position, juce::int64 numBlocks);
+
+    const int blockSize;
+    std::vector<juce::AudioBuffer<float>> slots;
+    juce::AbstractFifo fifo;
+
+    std::thread thread;
+
+    // Guards the three below, and the fifo's positions against lost wake-ups
+    mutable std::mutex lock;
+    std::condition_variable moved;
+    bool stopping = false;
+    bool finished = false; // the decoder wrote its last block, or failed
+    juce::String error;
+
+    JUCE_DECLARE_NON_COPYABLE(BlockDecoder)
+};
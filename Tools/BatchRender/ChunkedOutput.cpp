@@ -0,0 +1,83 @@
+#include "ChunkedOutput.h"
+
+ChunkedOutput::ChunkedOutput(std::unique_ptr<juce::AudioFormatWriter> writerIn, juce::int64 lengthInFrames,
+                             juce::int64 chunkFramesIn, int overlapFramesIn)
+    : writer(std::move(writerIn)),
+      length(lengthInFrames),
+      chunkFrames(juce::jmax((juce::int64) 1, chunkFramesIn)),
+      overlapFrames((int) juce::jmin((juce::int64) overlapFramesIn, chunkFrames)),
+      numChunks((int) juce::jmax((juce::int64) 1, (length + chunkFrames - 1) / chunkFrames))
+{
+    tail.setSize(2, juce::jmax(1, overlapFrames));
+}
+
+juce::int64 ChunkedOutput::getChunkRenderLength(int index) const noexcept
+{
+    const juce::int64 start = getChunkStart(index);
+    return juce::jmin(start + chunkFrames + overlapFrames, length) - start;
+}
+
+bool ChunkedOutput::submit(int index, juce::AudioBuffer<float>&& rendered)
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    if (failed)
+        return false;
+
+    pending[index] = std::move(rendered);
+
+    for (auto next = pending.find(nextToWrite); next != pending.end(); next = pending.find(nextToWrite))
+    {
+        if (!writeChunk(next->second, nextToWrite == numChunks - 1))
+        {
+            failed = true;
+            pending.clear();
+            return false;
+        }
+
+        pending.erase(next);
+        ++nextToWrite;
+    }
+
+    return true;
+}
+
+bool ChunkedOutput::writeChunk(juce::AudioBuffer<float>& chunk, bool isLast)
+{
+    // Equal-gain raised cosine: the two renders are the same signal to within
+    // a small error, so their sum must not dip
+    if (nextToWrite > 0)
+    {
+        const int fadeFrames = juce::jmin(tailFrames, chunk.getNumSamples());
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto* data = chunk.getWritePointer(ch);
+            const auto* previous = tail.getReadPointer(ch);
+
+            for (int i = 0; i < fadeFrames; ++i)
+            {
+                const float fadeIn = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::pi * ((float) i + 0.5f) / (float) fadeFrames));
+                data[i] = previous[i] + fadeIn * (data[i] - previous[i]);
+            }
+        }
+    }
+
+    // The overlap can be cut short by the end of the file
+    const int bodyFrames = isLast ? chunk.getNumSamples() : (int) juce::jmin(chunkFrames, (juce::int64) chunk.getNumSamples());
+    tailFrames = chunk.getNumSamples() - bodyFrames;
+
+    for (int ch = 0; ch < 2; ++ch)
+        tail.copyFrom(ch, 0, chunk, ch, bodyFrames, tailFrames);
+
+    return writer->writeFromAudioSampleBuffer(chunk, 0, bodyFrames);
+}
+
+bool ChunkedOutput::finish()
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    const bool complete = !failed && nextToWrite == numChunks;
+    writer.reset();
+    return complete;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_formats/juce_audio_formats.h>
+#endif
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+/**
+ * Stitches the chunks of one long render back into its output file.
+ *
+ * Chunk k covers output frames [k * chunkFrames, (k + 1) * chunkFrames) plus
+ * overlapFrames past its end (none for the last). Chunks arrive from any
+ * worker in any order; each is held until everything before it is written.
+ * The first overlapFrames of every chunk after the first are crossfaded with
+ * the previous chunk's overlap, so any difference the pre-roll did not
+ * settle out is blended over instead of landing as a step.
+ */
+class ChunkedOutput
+{
+public:
+    ChunkedOutput(std::unique_ptr<juce::AudioFormatWriter> writer, juce::int64 lengthInFrames,
+                  juce::int64 chunkFrames, int overlapFrames);
+
+    int getNumChunks() const noexcept { return numChunks; }
+
+    /** Frames chunk index has to render: its start, and its length with the overlap. */
+    juce::int64 getChunkStart(int index) const noexcept { return index * chunkFrames; }
+    juce::int64 getChunkRenderLength(int index) const noexcept;
+
+    /** What chunk index contributes to the file. */
+    juce::int64 getChunkLength(int index) const noexcept { return juce::jmin(chunkFrames, length - getChunkStart(index)); }
+
+    /** Hands over a rendered chunk; whatever is now contiguous gets written.
+        Safe from any thread. Returns false once a write has failed. */
+    bool submit(int index, juce::AudioBuffer<float>&& rendered);
+
+    /** True if every chunk arrived and was written; closes the file. */
+    bool finish();
+
+private:
+    bool writeChunk(juce::AudioBuffer<float>& chunk, bool isLast);
+
+    std::mutex lock;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    const juce::int64 length, chunkFrames;
+    const int overlapFrames;
+    const int numChunks;
+
+    std::map<int, juce::AudioBuffer<float>> pending;
+    int nextToWrite = 0;
+    bool failed = false;
+
+    // The previous chunk's rendered overlap, to crossfade into the next
+    juce::AudioBuffer<float> tail;
+    int tailFrames = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(ChunkedOutput)
+};
@@ -0,0 +1,309 @@
+#include "JobRenderer.h"
+
+JobRenderer::JobRenderer(int blockSizeIn, int bitDepthIn, bool deterministic, juce::TimeSliceThread& writerThreadIn)
+    : blockSize(blockSizeIn), bitDepth(bitDepthIn), engine(fm_engine_create(), &fm_engine_destroy),
+      decoder(blockSizeIn), writerThread(writerThreadIn)
+{
+    fm_engine_set_deterministic(engine.get(), deterministic ? 1 : 0);
+    formatManager.registerBasicFormats();
+    outputBuffer.setSize(2, blockSize);
+}
+
+JobRenderer::~JobRenderer()
+{
+    decoder.stop();
+}
+
+std::unique_ptr<juce::AudioFormatWriter> JobRenderer::createWriter(const juce::File& output, double sampleRate,
+                                                                   int bitDepth, juce::String& error)
+{
+    if (!output.getParentDirectory().createDirectory())
+    {
+        error = "cannot create " + output.getParentDirectory().getFullPathName();
+        return nullptr;
+    }
+
+    output.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(output);
+    if (!stream->openedOk())
+    {
+        error = "cannot write " + output.getFullPathName();
+        return nullptr;
+    }
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, bitDepth, {}, 0));
+    if (writer == nullptr)
+    {
+        error = "cannot write a " + juce::String(bitDepth) + "-bit WAV at " + juce::String(sampleRate) + " Hz";
+        return nullptr;
+    }
+
+    stream.release(); // the writer owns it now
+    return writer;
+}
+
+std::unique_ptr<juce::AudioFormatReader> JobRenderer::openReader(const juce::File& file)
+{
+    // Mapped where the format allows (WAV, AIFF); anything else streams
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped;
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+}
+
+juce::String JobRenderer::openInputs(const BatchJob& job)
+{
+    decoder.stop(); // it may still hold the last job's readers
+    carrier = openReader(job.carrier);
+    modulator.reset();
+
+    if (carrier == nullptr)
+        return "cannot read " + job.carrier.getFullPathName();
+
+    if (job.modulator != juce::File())
+    {
+        modulator = openReader(job.modulator);
+        if (modulator == nullptr)
+            return "cannot read " + job.modulator.getFullPathName();
+
+        // No resampling here: the engine runs at one rate
+        if (modulator->sampleRate != carrier->sampleRate)
+            return "modulator is " + juce::String(modulator->sampleRate) + " Hz, carrier is "
+                   + juce::String(carrier->sampleRate) + " Hz";
+    }
+
+    return {};
+}
+
+juce::String JobRenderer::prepareFor(const BatchJob& job)
+{
+    if (engine == nullptr)
+        return "out of memory";
+
+    for (int i = 0; i < FM_ENGINE_NUM_PARAMS; ++i)
+        fm_engine_set_param(engine.get(), (fm_engine_param) i, job.parameters[(size_t) i]);
+
+    const double sampleRate = carrier->sampleRate;
+    if (sampleRate != preparedRate)
+    {
+        if (fm_engine_prepare(engine.get(), sampleRate, blockSize) != 0)
+            return "cannot prepare the engine at " + juce::String(sampleRate) + " Hz";
+
+        preparedRate = sampleRate;
+        ++numPrepares;
+    }
+
+    // On the job's parameters with no fades, and nothing left of the last file
+    fm_engine_reset(engine.get());
+    return {};
+}
+
+juce::String JobRenderer::renderRange(juce::int64 firstInput, juce::int64 skip, juce::int64 count, const Sink& sink)
+{
+    // Past the end of the files the decoder reads silence, which is what
+    // flushes the engine's latency out
+    decoder.start(*carrier, modulator.get(), firstInput, (skip + count + blockSize - 1) / blockSize);
+
+    while (count > 0)
+    {
+        const auto* block = decoder.waitForBlock();
+        if (block == nullptr)
+        {
+            decoder.stop();
+            return "decode failed: " + decoder.getError();
+        }
+
+        fm_engine_process(engine.get(),
+                          block->getReadPointer(0), block->getReadPointer(1),
+                          modulator != nullptr ? block->getReadPointer(2) : nullptr,
+                          modulator != nullptr ? block->getReadPointer(3) : nullptr,
+                          outputBuffer.getWritePointer(0), outputBuffer.getWritePointer(1),
+                          blockSize);
+
+        decoder.releaseBlock();
+
+        const int dropped = (int) juce::jmin(skip, (juce::int64) blockSize);
+        skip -= dropped;
+
+        const int kept = (int) juce::jmin((juce::int64) (blockSize - dropped), count);
+        if (kept > 0)
+        {
+            if (!sink(outputBuffer, dropped, kept))
+            {
+                decoder.stop();
+                return "output failed";
+            }
+
+            count -= kept;
+        }
+    }
+
+    decoder.stop();
+    return {};
+}
+
+JobRenderer::Result JobRenderer::render(const BatchJob& job)
+{
+    Result result;
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto fail = [&result, &job](const juce::String& message)
+    {
+        result.error = "line " + juce::String(job.lineNumber) + ": " + message;
+        return result;
+    };
+
+    auto error = openInputs(job);
+    if (error.isEmpty())
+        error = prepareFor(job);
+    if (error.isNotEmpty())
+        return fail(error);
+
+    auto writer = createWriter(job.output, carrier->sampleRate, bitDepth, error);
+    if (writer == nullptr)
+        return fail(error);
+
+    // The encode stage. It takes the writer; its FIFO is the bounded queue
+    // between the engine and the disk
+    const auto expectedBytes = writer->getBitsPerSample() / 8 * 2 * carrier->lengthInSamples;
+    auto threadedWriter = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer.release(), writerThread,
+                                                                                     writerFifoBlocks * blockSize);
+
+    // Latency samples are dropped from the front so the output lines up with the carrier
+    const juce::int64 length = carrier->lengthInSamples;
+    error = renderRange(0, fm_engine_get_latency(engine.get()), length,
+                        [&threadedWriter](const juce::AudioBuffer<float>& block, int start, int numFrames)
+                        {
+                            const float* const channels[] = { block.getReadPointer(0, start), block.getReadPointer(1, start) };
+
+                            // Full: wait for the writer thread to catch up
+                            while (!threadedWriter->write(channels, numFrames))
+                                juce::Thread::sleep(1);
+
+                            return true;
+                        });
+
+    threadedWriter.reset(); // flushes and closes the file
+
+    if (error.isNotEmpty())
+        return fail(error);
+
+    // ThreadedWriter drops write errors, so check what reached the disk
+    if (job.output.getSize() < expectedBytes)
+        return fail("write failed: " + job.output.getFullPathName());
+
+    result.ok = true;
+    result.frames = length;
+    result.sampleRate = carrier->sampleRate;
+    result.seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    return result;
+}
+
+JobRenderer::Result JobRenderer::renderChunk(const BatchJob& job, juce::int64 start, juce::int64 length,
+                                             juce::AudioBuffer<float>& destination)
+{
+    Result result;
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto error = openInputs(job);
+    if (error.isEmpty())
+        error = prepareFor(job);
+    if (error.isNotEmpty())
+    {
+        result.error = "line " + juce::String(job.lineNumber) + ": " + error;
+        return result;
+    }
+
+    // The pre-roll: enough of the carrier before start for every stage of
+    // the engine to reach the state a whole-file render would be in
+    const juce::int64 firstInput = juce::jmax((juce::int64) 0, start - fm_engine_get_warmup(engine.get()));
+    const juce::int64 skip = (start - firstInput) + fm_engine_get_latency(engine.get());
+
+    destination.setSize(2, (int) length, false, false, true);
+    int filled = 0;
+
+    error = renderRange(firstInput, skip, length, [&destination, &filled](const juce::AudioBuffer<float>& block, int from, int numFrames)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            destination.copyFrom(ch, filled, block, ch, from, numFrames);
+
+        filled += numFrames;
+        return true;
+    });
+
+    if (error.isNotEmpty())
+    {
+        result.error = "line " + juce::String(job.lineNumber) + ": " + error;
+        return result;
+    }
+
+    result.ok = true;
+    result.frames = length;
+    result.sampleRate = carrier->sampleRate;
+    result.seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    return result;
+}
+
+JobRenderer::Comparison JobRenderer::compareWithOutput(const BatchJob& job)
+{
+    Comparison comparison;
+
+    auto error = openInputs(job);
+    if (error.isEmpty())
+        error = prepareFor(job);
+    if (error.isNotEmpty())
+    {
+        comparison.error = "line " + juce::String(job.lineNumber) + ": " + error;
+        return comparison;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> rendered(formatManager.createReaderFor(job.output));
+    if (rendered == nullptr || rendered->lengthInSamples != carrier->lengthInSamples)
+    {
+        comparison.error = "line " + juce::String(job.lineNumber) + ": cannot read back " + job.output.getFullPathName();
+        return comparison;
+    }
+
+    juce::AudioBuffer<float> renderedBlock(2, blockSize);
+    juce::int64 frame = 0;
+
+    error = renderRange(0, fm_engine_get_latency(engine.get()), carrier->lengthInSamples,
+                        [&](const juce::AudioBuffer<float>& block, int start, int numFrames)
+                        {
+                            rendered->read(&renderedBlock, 0, numFrames, frame, true, true);
+
+                            for (int i = 0; i < numFrames; ++i, ++frame)
+                            {
+                                for (int ch = 0; ch < 2; ++ch)
+                                {
+                                    const float expected = block.getSample(ch, start + i);
+                                    const float difference = std::abs(renderedBlock.getSample(ch, i) - expected);
+
+                                    comparison.errorSquares += (double) difference * difference;
+                                    comparison.signalSquares += (double) expected * expected;
+
+                                    if (difference > comparison.maxError)
+                                    {
+                                        comparison.maxError = difference;
+                                        comparison.maxErrorFrame = frame;
+                                    }
+                                }
+                            }
+
+                            return true;
+                        });
+
+    if (error.isNotEmpty())
+    {
+        comparison.error = "line " + juce::String(job.lineNumber) + ": " + error;
+        return comparison;
+    }
+
+    comparison.ok = true;
+    return comparison;
+}
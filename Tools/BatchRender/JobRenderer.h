@@ -0,0 +1,102 @@
+#pragma once
+
+#include "BatchManifest.h"
+#include "BlockDecoder.h"
+
+#include <functional>
+#include <memory>
+
+/**
+ * Everything one batch worker owns: format readers, an engine and the block
+ * buffers. The engine is prepared once per sample rate and reset between
+ * files, so a worker working through a directory of 48 kHz files allocates
+ * only for the file I/O.
+ *
+ * A render is a three-stage pipeline, so the engine's thread does nothing
+ * but run the engine: a BlockDecoder thread reads and converts ahead of it,
+ * and a ThreadedWriter encodes behind it, on a writer thread all the workers
+ * share.
+ * WAV and AIFF inputs are memory-mapped, so decoding is a conversion from
+ * the page cache rather than a read() per block.
+ */
+class JobRenderer
+{
+public:
+    struct Result
+    {
+        bool ok = false;
+        juce::String error;
+        juce::int64 frames = 0;
+        double sampleRate = 0.0;
+        double seconds = 0.0; // wall time for the job, I/O included
+        bool cached = false;  // copied from the render cache; nothing rendered
+    };
+
+    // A render compared against the file it should match
+    struct Comparison
+    {
+        bool ok = false;
+        juce::String error;
+        float maxError = 0.0f;
+        juce::int64 maxErrorFrame = 0;
+        double errorSquares = 0.0, signalSquares = 0.0;
+    };
+
+    /** deterministic: the engine runs in its deterministic mode (see
+        fm_engine_set_deterministic), as renders for the cache must.
+        writerThread: runs the encoders; it must outlive this. */
+    JobRenderer(int blockSize, int bitDepth, bool deterministic, juce::TimeSliceThread& writerThread);
+    ~JobRenderer();
+
+    /** The whole job, straight to its output file. */
+    Result render(const BatchJob& job);
+
+    /** Output frames [start, start + length) of the job into destination
+        (resized to fit), without writing anything. The engine is reset and
+        pre-rolled with the warm-up's worth of carrier before start, so the
+        result matches that stretch of a whole-file render to within the
+        engine's settling error. */
+    Result renderChunk(const BatchJob& job, juce::int64 start, juce::int64 length, juce::AudioBuffer<float>& destination);
+
+    /** Renders the whole job serially and compares it with what is in its
+        output file now. */
+    Comparison compareWithOutput(const BatchJob& job);
+
+    int getNumPrepares() const noexcept { return numPrepares; }
+
+    /** A WAV writer for output, or null with a message. */
+    static std::unique_ptr<juce::AudioFormatWriter> createWriter(const juce::File& output, double sampleRate,
+                                                                 int bitDepth, juce::String& error);
+
+private:
+    using Sink = std::function<bool(const juce::AudioBuffer<float>& block, int start, int numFrames)>;
+
+    std::unique_ptr<juce::AudioFormatReader> openReader(const juce::File& file);
+    juce::String openInputs(const BatchJob& job);
+    juce::String prepareFor(const BatchJob& job);
+
+    // Feeds the carrier from firstInput, drops skip output frames and hands
+    // the next count frames to sink, block by block. An error message if the
+    // decoder or the sink failed
+    juce::String renderRange(juce::int64 firstInput, juce::int64 skip, juce::int64 count, const Sink& sink);
+
+    const int blockSize;
+    const int bitDepth;
+
+    // Blocks of encode-side buffering per render
+    static constexpr int writerFifoBlocks = 32;
+
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<fm_engine, decltype(&fm_engine_destroy)> engine;
+
+    double preparedRate = 0.0;
+    int numPrepares = 0;
+
+    std::unique_ptr<juce::AudioFormatReader> carrier, modulator;
+    BlockDecoder decoder;
+    juce::AudioBuffer<float> outputBuffer;
+
+    juce::TimeSliceThread& writerThread;
+
+    JUCE_DECLARE_NON_COPYABLE(JobRenderer)
+};
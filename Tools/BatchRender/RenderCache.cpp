@@ -0,0 +1,134 @@
+#include "RenderCache.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    // Bump when the tool changes what it writes for the same engine output
+    // (trimming, format, dither...)
+    constexpr const char* outputFormatTag = "FM_Engine_batch wav 1";
+}
+
+RenderCache::RenderCache(const juce::File& directoryIn, juce::int64 maxBytesIn)
+    : directory(directoryIn), maxBytes(maxBytesIn)
+{
+}
+
+juce::File RenderCache::getEntry(const juce::String& key) const
+{
+    return directory.getChildFile(key.substring(0, 2)).getChildFile(key + ".wav");
+}
+
+juce::String RenderCache::hashFile(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return {};
+
+    const auto id = file.getFullPathName() + "|" + juce::String(file.getSize()) + "|"
+                  + juce::String(file.getLastModificationTime().toMilliseconds());
+
+    {
+        const std::lock_guard<std::mutex> guard(fileHashLock);
+        const auto found = fileHashes.find(id);
+        if (found != fileHashes.end())
+            return found->second;
+    }
+
+    // Outside the lock: two workers may hash the same file, but neither waits for the other's
+    const auto hash = juce::SHA256(file).toHexString();
+
+    const std::lock_guard<std::mutex> guard(fileHashLock);
+    fileHashes[id] = hash;
+    return hash;
+}
+
+juce::String RenderCache::computeKey(const BatchJob& job, int bitDepth)
+{
+    const auto carrierHash = hashFile(job.carrier);
+    if (carrierHash.isEmpty())
+        return {};
+
+    juce::String modulatorHash = "-";
+    if (job.modulator != juce::File())
+    {
+        modulatorHash = hashFile(job.modulator);
+        if (modulatorHash.isEmpty())
+            return {};
+    }
+
+    juce::MemoryOutputStream description;
+    description.writeString(outputFormatTag);
+    description.writeString(fm_engine_build_id());
+    description.writeString(carrierHash);
+    description.writeString(modulatorHash);
+    description.writeInt(bitDepth);
+
+    for (const float value : job.parameters)
+        description.writeFloat(value);
+
+    return juce::SHA256(description.getData(), description.getDataSize()).toHexString();
+}
+
+bool RenderCache::fetch(const juce::String& key, const juce::File& output)
+{
+    const auto entry = getEntry(key);
+
+    if (entry.existsAsFile() && output.getParentDirectory().createDirectory() && entry.copyFileTo(output))
+    {
+        entry.setLastModificationTime(juce::Time::getCurrentTime());
+        ++hits;
+        return true;
+    }
+
+    ++misses;
+    return false;
+}
+
+bool RenderCache::store(const juce::String& key, const juce::File& rendered)
+{
+    const auto entry = getEntry(key);
+    if (!entry.getParentDirectory().createDirectory())
+        return false;
+
+    // Renamed over the entry when complete; deleted if anything fails first
+    juce::TemporaryFile temporary(entry, juce::TemporaryFile::useHiddenFile);
+    return rendered.copyFileTo(temporary.getFile()) && temporary.overwriteTargetFileWithTemporary();
+}
+
+RenderCache::TrimResult RenderCache::trim()
+{
+    struct Entry
+    {
+        juce::File file;
+        juce::Time lastUsed;
+        juce::int64 size;
+    };
+
+    std::vector<Entry> entries;
+    TrimResult result;
+
+    for (const auto& file : directory.findChildFiles(juce::File::findFiles | juce::File::ignoreHiddenFiles, true, "*.wav"))
+    {
+        entries.push_back({ file, file.getLastModificationTime(), file.getSize() });
+        result.bytes += entries.back().size;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+
+    for (const auto& entry : entries)
+    {
+        if (result.bytes <= maxBytes)
+            break;
+
+        if (entry.file.deleteFile())
+        {
+            result.bytes -= entry.size;
+            result.evictedBytes += entry.size;
+            ++result.evicted;
+        }
+    }
+
+    result.entries = (int) entries.size() - result.evicted;
+    return result;
+}
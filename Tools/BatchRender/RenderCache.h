@@ -0,0 +1,80 @@
+#pragma once
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_cryptography/juce_cryptography.h>
+#endif
+
+#include "BatchManifest.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+/**
+ * An on-disk store of finished renders, addressed by content. A job's key is
+ * a SHA-256 over everything its output depends on: the bytes of the carrier
+ * and modulator files, every parameter (the render profile included), the
+ * output bit depth and the engine's build id, which carries its DSP revision.
+ * Re-rendering an unchanged clip is then a file copy, however the manifest
+ * or the project around it changed.
+ *
+ * A hit has to be the file a render would produce, so only deterministic
+ * renders go in: whole files, the engine in its deterministic mode. Chunked
+ * renders are not bit-exact and are never cached.
+ *
+ * Entries are <directory>/<first two hex digits>/<key>.wav. Each entry's
+ * modification time is its last use: a hit touches it, and trim() deletes
+ * the least recently used until the total fits the size limit. Entries are
+ * written under a temporary name and renamed into place, so workers, or
+ * several batch runs sharing one cache, never see half a file.
+ */
+class RenderCache
+{
+public:
+    RenderCache(const juce::File& directory, juce::int64 maxBytes);
+
+    /** The job's key, or an empty string if an input cannot be read. Hashes
+        the input files, so this costs a read of each; files shared between
+        jobs are hashed once. */
+    juce::String computeKey(const BatchJob& job, int bitDepth);
+
+    /** On a hit, copies the entry to output, marks it used and returns true. */
+    bool fetch(const juce::String& key, const juce::File& output);
+
+    /** Adds a finished render. False if it could not be stored, which costs
+        nothing but the next render. */
+    bool store(const juce::String& key, const juce::File& rendered);
+
+    struct TrimResult
+    {
+        int entries = 0, evicted = 0;
+        juce::int64 bytes = 0, evictedBytes = 0;
+    };
+
+    /** Evicts least recently used entries down to the size limit. Not while
+        this process is still fetching or storing. */
+    TrimResult trim();
+
+    int getNumHits() const noexcept { return hits; }
+    int getNumMisses() const noexcept { return misses; }
+
+    const juce::File& getDirectory() const noexcept { return directory; }
+
+private:
+    juce::File getEntry(const juce::String& key) const;
+    juce::String hashFile(const juce::File& file);
+
+    const juce::File directory;
+    const juce::int64 maxBytes;
+
+    // path, size and modification time -> SHA-256 of the contents
+    std::mutex fileHashLock;
+    std::map<juce::String, juce::String> fileHashes;
+
+    std::atomic<int> hits { 0 }, misses { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(RenderCache)
+};
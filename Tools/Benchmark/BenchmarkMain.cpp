@@ -0,0 +1,361 @@
+// Headless throughput benchmark for FmEngineAudioProcessor.
+//
+// Instantiates the processor directly (no host, no editor), drives it with
+// synthetic carrier/modulator sines and reports ns/sample, times-realtime and
+// audio-thread allocation counts for every configuration in the matrix
+// algorithm x oversampling x limiter x range x block size x sample rate.
+// The counts cover operator new only; direct malloc/realloc calls from
+// third-party code are not seen (see AllocationCounter.h).
+//
+// With --state it instead times getStateInformation/setStateInformation for
+// the binary state chunk and for loading a legacy XML state, in microseconds.
+//
+// Usage:
+//   FM_Engine_benchmark [--format=csv|json] [--out=<file>] [--seconds=<s>]
+//                       [--block-sizes=16,64,...] [--sample-rates=44100,...]
+//                       [--quick] [--state]
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#endif
+
+#include "PluginProcessor.h"
+#include "AllocationCounter.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    struct BenchmarkConfig
+    {
+        int algorithm = 0;
+        bool oversampling = false;
+        bool limiter = false;
+        int range = 1;
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+    };
+
+    struct BenchmarkResult
+    {
+        BenchmarkConfig config;
+        double nsPerSample = 0.0;
+        double timesRealtime = 0.0;
+        juce::int64 allocations = 0;
+        double allocationsPerBlock = 0.0;
+    };
+
+    void setParameter(FmEngineAudioProcessor& processor, const char* parameterID, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(parameterID))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    // Fills main L/R with two carrier sines and the sidechain with two slow
+    // modulator sines. Phases are carried across blocks so the signal is
+    // continuous regardless of block size.
+    class SignalGenerator
+    {
+    public:
+        explicit SignalGenerator(double sampleRate) : sampleRate(sampleRate) {}
+
+        void fill(juce::AudioBuffer<float>& buffer)
+        {
+            static constexpr double frequencies[] = { 220.0, 330.0, 110.0, 165.0 };
+            const int numChannels = juce::jmin(4, buffer.getNumChannels());
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                const double increment = juce::MathConstants<double>::twoPi * frequencies[ch] / sampleRate;
+                double phase = phases[ch];
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    data[i] = 0.5f * static_cast<float>(std::sin(phase));
+                    phase += increment;
+                }
+
+                phases[ch] = std::fmod(phase, juce::MathConstants<double>::twoPi);
+            }
+        }
+
+    private:
+        double sampleRate;
+        double phases[4] = {};
+    };
+
+    BenchmarkResult runConfiguration(const BenchmarkConfig& config, double secondsToProcess)
+    {
+        FmEngineAudioProcessor processor;
+
+        setParameter(processor, ParameterIDs::ALGORITHM, static_cast<float>(config.algorithm));
+        setParameter(processor, ParameterIDs::OVERSAMPLING, config.oversampling ? 1.0f : 0.0f);
+        setParameter(processor, ParameterIDs::LIMITER, config.limiter ? 1.0f : 0.0f);
+        setParameter(processor, ParameterIDs::MAX_DELAY_MS, static_cast<float>(config.range));
+        setParameter(processor, ParameterIDs::MOD_DEPTH, 0.5f);
+
+        processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        const int numChannels = juce::jmax(processor.getTotalNumInputChannels(),
+                                           processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        SignalGenerator generator(config.sampleRate);
+
+        // Warm-up: fill delay lines, settle smoothers, fault in pages
+        const int warmUpBlocks = juce::jmax(1, static_cast<int>(0.25 * config.sampleRate) / config.blockSize);
+        for (int b = 0; b < warmUpBlocks; ++b)
+        {
+            generator.fill(buffer);
+            processor.processBlock(buffer, midi);
+        }
+
+        const int numBlocks = juce::jmax(1, static_cast<int>(secondsToProcess * config.sampleRate) / config.blockSize);
+        juce::int64 processTicks = 0;
+
+        AllocationCounter::reset();
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            generator.fill(buffer);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            {
+                AllocationCounter::ScopedAllocationCount counting;
+                processor.processBlock(buffer, midi);
+            }
+            processTicks += juce::Time::getHighResolutionTicks() - start;
+        }
+
+        processor.releaseResources();
+
+        const double processSeconds = juce::Time::highResolutionTicksToSeconds(processTicks);
+        const double totalSamples = static_cast<double>(numBlocks) * config.blockSize;
+
+        BenchmarkResult result;
+        result.config = config;
+        result.nsPerSample = processSeconds * 1.0e9 / totalSamples;
+        result.timesRealtime = processSeconds > 0.0 ? (totalSamples / config.sampleRate) / processSeconds : 0.0;
+        result.allocations = AllocationCounter::getCount();
+        result.allocationsPerBlock = static_cast<double>(result.allocations) / numBlocks;
+        return result;
+    }
+
+    //==============================================================================
+    struct StateResult
+    {
+        juce::String operation;
+        juce::String format;
+        size_t bytes = 0;
+        double microsecondsPerCall = 0.0;
+    };
+
+    template <typename Body>
+    double timeMicroseconds(int iterations, Body&& body)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < iterations; ++i)
+            body();
+        const auto ticks = juce::Time::getHighResolutionTicks() - start;
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6 / iterations;
+    }
+
+    juce::Array<StateResult> runStateBenchmark(int iterations)
+    {
+        FmEngineAudioProcessor processor;
+        setParameter(processor, ParameterIDs::ALGORITHM, 2.0f);
+        setParameter(processor, ParameterIDs::MOD_DEPTH, 0.37f);
+        setParameter(processor, ParameterIDs::LP_CUTOFF, 1234.0f);
+
+        juce::MemoryBlock binaryState;
+        processor.getStateInformation(binaryState);
+
+        // What earlier versions saved, for the fallback path
+        juce::MemoryBlock xmlState;
+        if (auto xml = processor.apvts.copyState().createXml())
+            juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+
+        juce::Array<StateResult> results;
+        juce::MemoryBlock scratch;
+
+        results.add({ "save", "binary", binaryState.getSize(),
+                      timeMicroseconds(iterations, [&] { processor.getStateInformation(scratch); }) });
+        results.add({ "load", "binary", binaryState.getSize(),
+                      timeMicroseconds(iterations, [&] { processor.setStateInformation(binaryState.getData(), (int) binaryState.getSize()); }) });
+        results.add({ "save", "xml", xmlState.getSize(),
+                      timeMicroseconds(iterations, [&]
+                      {
+                          if (auto xml = processor.apvts.copyState().createXml())
+                              juce::AudioProcessor::copyXmlToBinary(*xml, scratch);
+                      }) });
+        results.add({ "load", "xml", xmlState.getSize(),
+                      timeMicroseconds(iterations, [&] { processor.setStateInformation(xmlState.getData(), (int) xmlState.getSize()); }) });
+
+        return results;
+    }
+
+    juce::String toCsv(const juce::Array<StateResult>& results)
+    {
+        juce::String csv = "operation,format,bytes,us_per_call\n";
+
+        for (const auto& r : results)
+            csv << r.operation << ',' << r.format << ',' << (int) r.bytes << ','
+                << juce::String(r.microsecondsPerCall, 3) << '\n';
+
+        return csv;
+    }
+
+    juce::String toJson(const juce::Array<StateResult>& results)
+    {
+        juce::Array<juce::var> rows;
+
+        for (const auto& r : results)
+        {
+            auto* row = new juce::DynamicObject();
+            row->setProperty("operation", r.operation);
+            row->setProperty("format", r.format);
+            row->setProperty("bytes", (int) r.bytes);
+            row->setProperty("us_per_call", r.microsecondsPerCall);
+            rows.add(juce::var(row));
+        }
+
+        return juce::JSON::toString(juce::var(rows));
+    }
+
+    //==============================================================================
+    juce::String toCsv(const juce::Array<BenchmarkResult>& results)
+    {
+        juce::String csv = "algorithm,oversampling,limiter,range,block_size,sample_rate,"
+                           "ns_per_sample,x_realtime,allocations,allocations_per_block\n";
+
+        for (const auto& r : results)
+        {
+            csv << r.config.algorithm << ','
+                << (r.config.oversampling ? 1 : 0) << ','
+                << (r.config.limiter ? 1 : 0) << ','
+                << r.config.range << ','
+                << r.config.blockSize << ','
+                << static_cast<int>(r.config.sampleRate) << ','
+                << juce::String(r.nsPerSample, 3) << ','
+                << juce::String(r.timesRealtime, 2) << ','
+                << r.allocations << ','
+                << juce::String(r.allocationsPerBlock, 3) << '\n';
+        }
+
+        return csv;
+    }
+
+    juce::String toJson(const juce::Array<BenchmarkResult>& results)
+    {
+        juce::Array<juce::var> rows;
+
+        for (const auto& r : results)
+        {
+            auto* row = new juce::DynamicObject();
+            row->setProperty("algorithm", r.config.algorithm);
+            row->setProperty("oversampling", r.config.oversampling);
+            row->setProperty("limiter", r.config.limiter);
+            row->setProperty("range", r.config.range);
+            row->setProperty("block_size", r.config.blockSize);
+            row->setProperty("sample_rate", r.config.sampleRate);
+            row->setProperty("ns_per_sample", r.nsPerSample);
+            row->setProperty("x_realtime", r.timesRealtime);
+            row->setProperty("allocations", r.allocations);
+            row->setProperty("allocations_per_block", r.allocationsPerBlock);
+            rows.add(juce::var(row));
+        }
+
+        return juce::JSON::toString(juce::var(rows));
+    }
+
+    juce::Array<int> parseIntList(const juce::String& text, juce::Array<int> fallback)
+    {
+        if (text.isEmpty())
+            return fallback;
+
+        juce::Array<int> values;
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", ""))
+            if (token.trim().getIntValue() > 0)
+                values.add(token.trim().getIntValue());
+
+        return values.isEmpty() ? fallback : values;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    const bool quick = args.containsOption("--quick");
+    const bool json = args.getValueForOption("--format").equalsIgnoreCase("json");
+
+    auto writeReport = [&args](const juce::String& report)
+    {
+        const auto outPath = args.getValueForOption("--out");
+
+        if (outPath.isEmpty())
+        {
+            std::cout << report;
+            return true;
+        }
+
+        const auto outFile = juce::File::getCurrentWorkingDirectory().getChildFile(outPath);
+        if (! outFile.replaceWithText(report))
+        {
+            std::cerr << "Could not write " << outFile.getFullPathName() << std::endl;
+            return false;
+        }
+
+        return true;
+    };
+
+    if (args.containsOption("--state"))
+    {
+        const auto stateResults = runStateBenchmark(quick ? 1000 : 20000);
+        return writeReport(json ? toJson(stateResults) : toCsv(stateResults)) ? 0 : 1;
+    }
+
+    double seconds = args.getValueForOption("--seconds").getDoubleValue();
+    if (seconds <= 0.0)
+        seconds = quick ? 0.5 : 2.0;
+
+    const auto blockSizes = parseIntList(args.getValueForOption("--block-sizes"),
+                                         quick ? juce::Array<int> { 64, 512, 4096 }
+                                               : juce::Array<int> { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 });
+    const auto sampleRates = parseIntList(args.getValueForOption("--sample-rates"),
+                                          quick ? juce::Array<int> { 48000 }
+                                                : juce::Array<int> { 44100, 48000, 96000, 192000 });
+
+    juce::Array<BenchmarkResult> results;
+
+    for (int sampleRate : sampleRates)
+        for (int blockSize : blockSizes)
+            for (int algorithm = 0; algorithm < 3; ++algorithm)
+                for (int oversampling = 0; oversampling < 2; ++oversampling)
+                    for (int limiter = 0; limiter < 2; ++limiter)
+                        for (int range = 0; range < 4; ++range)
+                        {
+                            BenchmarkConfig config;
+                            config.algorithm = algorithm;
+                            config.oversampling = oversampling != 0;
+                            config.limiter = limiter != 0;
+                            config.range = range;
+                            config.blockSize = blockSize;
+                            config.sampleRate = static_cast<double>(sampleRate);
+
+                            results.add(runConfiguration(config, seconds));
+                            std::cerr << '.' << std::flush;
+                        }
+
+    std::cerr << std::endl;
+
+    return writeReport(json ? toJson(results) : toCsv(results)) ? 0 : 1;
+}
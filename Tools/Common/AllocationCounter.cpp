@@ -0,0 +1,96 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace
+{
+    thread_local bool countingEnabled = false;
+    thread_local std::int64_t allocationCount = 0;
+
+    inline void noteAllocation() noexcept
+    {
+        if (countingEnabled)
+            ++allocationCount;
+    }
+
+    void* allocate(std::size_t size)
+    {
+        noteAllocation();
+
+        if (void* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        noteAllocation();
+
+        const auto align = static_cast<std::size_t>(alignment);
+        size = size == 0 ? align : size;
+
+       #if defined(_MSC_VER)
+        if (void* p = _aligned_malloc(size, align))
+            return p;
+       #else
+        void* p = nullptr;
+        if (posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size) == 0)
+            return p;
+       #endif
+
+        throw std::bad_alloc();
+    }
+
+    void freeAligned(void* p) noexcept
+    {
+       #if defined(_MSC_VER)
+        _aligned_free(p);
+       #else
+        std::free(p);
+       #endif
+    }
+}
+
+namespace AllocationCounter
+{
+    std::int64_t getCount() noexcept { return allocationCount; }
+    void reset() noexcept            { allocationCount = 0; }
+
+    ScopedAllocationCount::ScopedAllocationCount() noexcept
+        : wasCounting(countingEnabled)
+    {
+        countingEnabled = true;
+    }
+
+    ScopedAllocationCount::~ScopedAllocationCount() noexcept
+    {
+        countingEnabled = wasCounting;
+    }
+}
+
+//==============================================================================
+// Global replacements. Every form forwards to the two helpers above so the
+// count is the same whichever overload the compiler picks.
+void* operator new  (std::size_t size)                                  { return allocate(size); }
+void* operator new[](std::size_t size)                                  { return allocate(size); }
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept  { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept  { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new  (std::size_t size, std::align_val_t a)              { return allocateAligned(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a)              { return allocateAligned(size, a); }
+
+void operator delete  (void* p) noexcept                                { std::free(p); }
+void operator delete[](void* p) noexcept                                { std::free(p); }
+void operator delete  (void* p, std::size_t) noexcept                   { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { std::free(p); }
+void operator delete  (void* p, const std::nothrow_t&) noexcept         { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept         { std::free(p); }
+void operator delete  (void* p, std::align_val_t) noexcept              { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { freeAligned(p); }
+void operator delete  (void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
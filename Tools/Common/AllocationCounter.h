@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations made through operator new on the calling thread.
+// The replacement operators live in AllocationCounter.cpp, so any tool that
+// links that file gets counting for the whole executable. Counting is off
+// until a ScopedAllocationCount is alive on the thread.
+//
+// Only operator new is replaced: malloc, calloc and realloc called directly
+// (by C libraries, system frameworks, some third-party code) are not counted.
+// EngineChecks' RealtimeSafetyGuard is the stricter probe.
+namespace AllocationCounter
+{
+    // Number of allocations seen on this thread while counting was enabled
+    std::int64_t getCount() noexcept;
+    void reset() noexcept;
+
+    // Enables counting on the current thread for the lifetime of the object
+    struct ScopedAllocationCount
+    {
+        ScopedAllocationCount() noexcept;
+        ~ScopedAllocationCount() noexcept;
+
+        ScopedAllocationCount(const ScopedAllocationCount&) = delete;
+        ScopedAllocationCount& operator=(const ScopedAllocationCount&) = delete;
+
+    private:
+        bool wasCounting;
+    };
+}
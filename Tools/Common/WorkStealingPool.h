@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a fixed list of coarse items (whole files, long chunks) on N threads.
+//
+// Each worker starts with a contiguous share of the items and works through
+// it front to back, so neighbouring items (which tend to share a sample rate
+// and so a prepared engine) stay on one worker. A worker that runs dry steals
+// from the back of another worker's queue. Items take milliseconds to
+// seconds, so one mutex per queue is never contended enough to matter; what
+// the stealing buys is that a few long files cannot leave most cores idle at
+// the end of a run.
+//
+// Interleaved dealing (item w to worker w, then w + N, ...) suits items that
+// are consumed in order, like the chunks of one file: all workers start near
+// the front and finish roughly in sequence.
+class WorkStealingPool
+{
+public:
+    struct WorkerStats
+    {
+        int itemsRun = 0;
+        int itemsStolen = 0;
+        double busySeconds = 0.0;
+    };
+
+    explicit WorkStealingPool(int numWorkersIn)
+        : numWorkers(std::max(1, numWorkersIn)), queues((size_t) numWorkers)
+    {
+    }
+
+    static int defaultNumWorkers()
+    {
+        return std::max(1, (int) std::thread::hardware_concurrency());
+    }
+
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+    enum class Dealing { contiguous, interleaved };
+
+    /** Calls task(worker, item) once for every item in [0, numItems) and
+        returns when all are done. worker is in [0, getNumWorkers()). */
+    std::vector<WorkerStats> run(int numItems, const std::function<void(int worker, int item)>& task,
+                                 Dealing dealing = Dealing::contiguous)
+    {
+        for (int w = 0; w < numWorkers; ++w)
+        {
+            auto& items = queues[(size_t) w].items;
+            items.clear();
+
+            if (dealing == Dealing::interleaved)
+            {
+                for (int i = w; i < numItems; i += numWorkers)
+                    items.push_back(i);
+            }
+            else
+            {
+                const int begin = (int) ((long long) numItems * w / numWorkers);
+                const int end = (int) ((long long) numItems * (w + 1) / numWorkers);
+
+                for (int i = begin; i < end; ++i)
+                    items.push_back(i);
+            }
+        }
+
+        std::vector<WorkerStats> stats((size_t) numWorkers);
+        std::vector<std::thread> threads;
+        threads.reserve((size_t) numWorkers);
+
+        for (int w = 0; w < numWorkers; ++w)
+        {
+            threads.emplace_back([this, w, &task, &stats]
+            {
+                auto& own = stats[(size_t) w];
+
+                for (;;)
+                {
+                    int item = -1;
+                    const bool stolen = !popLocal(w, item);
+                    if (stolen && !steal(w, item))
+                        break; // every queue is empty; nothing gets added during a run
+
+                    const auto start = std::chrono::steady_clock::now();
+                    task(w, item);
+                    own.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                    ++own.itemsRun;
+                    if (stolen)
+                        ++own.itemsStolen;
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        return stats;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<int> items;
+    };
+
+    bool popLocal(int worker, int& item)
+    {
+        auto& queue = queues[(size_t) worker];
+        const std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (queue.items.empty())
+            return false;
+
+        item = queue.items.front();
+        queue.items.pop_front();
+        return true;
+    }
+
+    // From the far end of the next non-empty queue: the work its owner would
+    // reach last
+    bool steal(int thief, int& item)
+    {
+        for (int offset = 1; offset < numWorkers; ++offset)
+        {
+            auto& queue = queues[(size_t) ((thief + offset) % numWorkers)];
+            const std::lock_guard<std::mutex> guard(queue.lock);
+
+            if (!queue.items.empty())
+            {
+                item = queue.items.back();
+                queue.items.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const int numWorkers;
+    std::vector<Queue> queues;
+};
@@ -0,0 +1,494 @@
+// Per-component microbenchmarks and equivalence checks.
+//
+// Times InterpolatedDelay::process, LowPass::processSample,
+// BrickWallLimiter::processSample, routeSample and routeBlock (with and
+// without a sidechain) in isolation on fixed-seed inputs with warm caches,
+// and checks each kernel against the frozen scalar copies in
+// ReferenceKernels.h. Delay ranges (1/10/100/500 ms) change how far
+// back the ring read reaches, modulator bandwidths change how much the read
+// position jumps between samples.
+//
+// Exits with a non-zero status if any kernel drifts past its tolerance, so it
+// can gate candidate rewrites.
+//
+// Delay backends: the engine's InterpolatedDelay (cubic and 6-point) and
+// JUCE's DelayLine (Lagrange3rd, Thiran) run the same inputs through
+// DelayBackends.h. Each is timed and null-tested against the engine's cubic
+// delay: largest difference and residual in dB. These rows compare, they do
+// not gate.
+//
+// Usage:
+//   FM_Engine_component_bench [--out=<file>] [--samples=<n>] [--repeats=<n>]
+//                             [--delay-backends=<name,name,...>|none]
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#endif
+
+#include "InterpolatedDelay.h"
+#include "LowPass.h"
+#include "BrickWallLimiter.h"
+#include "Routing.h"
+#include "ReferenceKernels.h"
+#include "DelayBackends.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    constexpr double benchSampleRate = 48000.0;
+    constexpr juce::int64 inputSeed = 0x464d456e;
+
+    // Delay rows: how far back the read reaches, and how fast it moves
+    constexpr float delayRangesMs[] = { 1.0f, 10.0f, 100.0f, 500.0f };
+    constexpr double modulatorBandwidthsHz[] = { 10.0, 100.0, 1000.0, 10000.0 };
+
+    // Stated tolerances for optimised kernels against the scalar reference.
+    // The delay gets a little headroom for alternative index arithmetic, the
+    // filter for re-associated biquad maths; routing must stay bit-exact.
+    constexpr double delayTolerance   = 1.0e-4;
+    constexpr double lowPassTolerance = 1.0e-5;
+    constexpr double limiterTolerance = 1.0e-6;
+    constexpr double routingTolerance = 0.0;
+
+    struct KernelResult
+    {
+        juce::String kernel;
+        juce::String variant;
+        double nsPerSample = 0.0;
+        double maxAbsError = 0.0;
+        double tolerance = 0.0;
+        double residualDb = std::numeric_limits<double>::quiet_NaN(); // error energy over the reference's
+        bool gated = true; // false: a comparison, reported but never failed
+
+        bool passed() const { return ! gated || maxAbsError <= tolerance; }
+    };
+
+    //==============================================================================
+    // White noise from a fixed seed, band-limited by a one-pole at cutoffHz and
+    // renormalised to +-1 so every bandwidth uses the full modulation range.
+    std::vector<float> makeBandLimitedNoise(int numSamples, double cutoffHz, juce::int64 seed)
+    {
+        juce::Random random(seed);
+        std::vector<float> out(static_cast<size_t>(numSamples));
+
+        const float a = 1.0f - static_cast<float>(std::exp(-juce::MathConstants<double>::twoPi * cutoffHz / benchSampleRate));
+        float y = 0.0f;
+        float peak = 1.0e-9f;
+
+        for (auto& s : out)
+        {
+            y += a * ((random.nextFloat() * 2.0f - 1.0f) - y);
+            s = y;
+            peak = std::max(peak, std::abs(y));
+        }
+
+        for (auto& s : out)
+            s /= peak;
+
+        return out;
+    }
+
+    std::vector<float> toUnipolar(const std::vector<float>& bipolar)
+    {
+        std::vector<float> out(bipolar.size());
+        for (size_t i = 0; i < bipolar.size(); ++i)
+            out[i] = (bipolar[i] + 1.0f) * 0.5f;
+        return out;
+    }
+
+    double maxAbsDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        double maxError = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+            maxError = std::max(maxError, static_cast<double>(std::abs(a[i] - b[i])));
+        return maxError;
+    }
+
+    double residualDb(const std::vector<float>& a, const std::vector<float>& reference)
+    {
+        double error = 0.0, signal = 1.0e-30;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            const double d = (double) a[i] - reference[i];
+            error += d * d;
+            signal += (double) reference[i] * reference[i];
+        }
+        return error > 0.0 ? 10.0 * std::log10(error / signal) : -std::numeric_limits<double>::infinity();
+    }
+
+    // Runs fn once to warm caches/branch predictors, then returns the best
+    // ns/sample over the requested number of repeats.
+    template <typename Fn>
+    double timeNsPerSample(int numSamples, int repeats, Fn&& fn)
+    {
+        fn();
+
+        double best = std::numeric_limits<double>::max();
+        for (int r = 0; r < repeats; ++r)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            fn();
+            const auto ticks = juce::Time::getHighResolutionTicks() - start;
+            best = std::min(best, juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / numSamples);
+        }
+
+        return best;
+    }
+
+    //==============================================================================
+    void benchmarkDelay(juce::Array<KernelResult>& results, const std::vector<float>& carrier, int repeats)
+    {
+        const int numSamples = static_cast<int>(carrier.size());
+        std::vector<float> output(carrier.size());
+        std::vector<float> reference(carrier.size());
+
+        for (double bandwidth : modulatorBandwidthsHz)
+        {
+            const auto modulator = toUnipolar(makeBandLimitedNoise(numSamples, bandwidth, inputSeed + 1));
+
+            for (float rangeMs : delayRangesMs)
+            {
+                KernelResult r;
+                r.kernel = "InterpolatedDelay::process";
+                r.variant = juce::String(rangeMs, 0) + "ms/" + juce::String(bandwidth, 0) + "Hz";
+                r.tolerance = delayTolerance;
+
+                {
+                    InterpolatedDelay delay;
+                    delay.prepare(benchSampleRate, rangeMs);
+                    r.nsPerSample = timeNsPerSample(numSamples, repeats, [&]
+                    {
+                        for (int i = 0; i < numSamples; ++i)
+                            output[(size_t) i] = delay.process(carrier[(size_t) i], modulator[(size_t) i]);
+                    });
+                }
+
+                InterpolatedDelay delay;
+                Reference::InterpolatedDelay referenceDelay;
+                delay.prepare(benchSampleRate, rangeMs);
+                referenceDelay.prepare(benchSampleRate, rangeMs);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    output[(size_t) i] = delay.process(carrier[(size_t) i], modulator[(size_t) i]);
+                    reference[(size_t) i] = referenceDelay.process(carrier[(size_t) i], modulator[(size_t) i]);
+                }
+
+                r.maxAbsError = maxAbsDifference(output, reference);
+                results.add(r);
+            }
+        }
+    }
+
+    // Same inputs as benchmarkDelay, through every selected backend. The
+    // engine's cubic delay is the baseline of the null test, so its own rows
+    // read zero difference.
+    void benchmarkDelayBackends(juce::Array<KernelResult>& results, const std::vector<float>& carrier, int repeats,
+                                const juce::Array<DelayBackend::Type>& types)
+    {
+        const int numSamples = static_cast<int>(carrier.size());
+        std::vector<float> output(carrier.size());
+        std::vector<float> baseline(carrier.size());
+
+        for (double bandwidth : modulatorBandwidthsHz)
+        {
+            const auto modulator = toUnipolar(makeBandLimitedNoise(numSamples, bandwidth, inputSeed + 1));
+
+            for (float rangeMs : delayRangesMs)
+            {
+                auto baselineDelay = DelayBackend::create(DelayBackend::Type::engineCubic);
+                baselineDelay->prepare(benchSampleRate, rangeMs);
+                baselineDelay->process(carrier.data(), modulator.data(), baseline.data(), numSamples);
+
+                for (const auto type : types)
+                {
+                    KernelResult r;
+                    r.kernel = DelayBackend::getName(type);
+                    r.variant = juce::String(rangeMs, 0) + "ms/" + juce::String(bandwidth, 0) + "Hz";
+                    r.gated = false;
+
+                    auto delay = DelayBackend::create(type);
+                    delay->prepare(benchSampleRate, rangeMs);
+
+                    r.nsPerSample = timeNsPerSample(numSamples, repeats, [&]
+                    {
+                        delay->process(carrier.data(), modulator.data(), output.data(), numSamples);
+                    });
+
+                    delay->reset();
+                    delay->process(carrier.data(), modulator.data(), output.data(), numSamples);
+
+                    r.maxAbsError = maxAbsDifference(output, baseline);
+                    r.residualDb = residualDb(output, baseline);
+                    results.add(r);
+                }
+            }
+        }
+    }
+
+    // --delay-backends: a comma-separated list of DelayBackend names, "none",
+    // or every backend when absent. Unknown names are reported and skipped.
+    juce::Array<DelayBackend::Type> parseDelayBackends(const juce::String& option)
+    {
+        juce::Array<DelayBackend::Type> types;
+
+        if (option.isEmpty())
+        {
+            for (const auto type : DelayBackend::allTypes)
+                types.add(type);
+            return types;
+        }
+
+        for (const auto& name : juce::StringArray::fromTokens(option, ",", ""))
+        {
+            if (name.trim() == "none")
+                continue;
+
+            bool found = false;
+            for (const auto type : DelayBackend::allTypes)
+            {
+                if (name.trim() == DelayBackend::getName(type))
+                {
+                    types.addIfNotAlreadyThere(type);
+                    found = true;
+                }
+            }
+
+            if (! found)
+                std::cerr << "unknown delay backend: " << name << std::endl;
+        }
+
+        return types;
+    }
+
+    void benchmarkLowPass(juce::Array<KernelResult>& results, const std::vector<float>& input, int repeats)
+    {
+        const int numSamples = static_cast<int>(input.size());
+        std::vector<float> output(input.size());
+        std::vector<float> reference(input.size());
+
+        // Slow logarithmic cutoff sweep, as produced by the LP_CUTOFF smoother
+        std::vector<float> cutoffSweep(input.size());
+        for (int i = 0; i < numSamples; ++i)
+            cutoffSweep[(size_t) i] = 20.0f * std::pow(1000.0f, static_cast<float>(i) / numSamples);
+
+        for (bool sweeping : { false, true })
+        {
+            KernelResult r;
+            r.kernel = "LowPass::processSample";
+            r.variant = sweeping ? "setCutoff per sample" : "fixed 1 kHz";
+            r.tolerance = lowPassTolerance;
+
+            auto run = [&](auto& filter, std::vector<float>& dest)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    if (sweeping)
+                        filter.setCutoff(cutoffSweep[(size_t) i]);
+                    dest[(size_t) i] = filter.processSample(input[(size_t) i]);
+                }
+            };
+
+            {
+                LowPass filter;
+                filter.prepare(benchSampleRate, 512);
+                filter.setCutoff(1000.0f);
+                r.nsPerSample = timeNsPerSample(numSamples, repeats, [&] { run(filter, output); });
+            }
+
+            LowPass filter;
+            Reference::LowPass referenceFilter;
+            filter.prepare(benchSampleRate, 512);
+            referenceFilter.prepare(benchSampleRate);
+            filter.setCutoff(1000.0f);
+            referenceFilter.setCutoff(1000.0f);
+
+            run(filter, output);
+            run(referenceFilter, reference);
+
+            r.maxAbsError = maxAbsDifference(output, reference);
+            results.add(r);
+        }
+    }
+
+    void benchmarkLimiter(juce::Array<KernelResult>& results, const std::vector<float>& noise, int repeats)
+    {
+        const int numSamples = static_cast<int>(noise.size());
+        std::vector<float> output(noise.size());
+        std::vector<float> reference(noise.size());
+
+        // Drive 3.5 dB over full scale so the limiter is actually working
+        std::vector<float> input(noise.size());
+        for (size_t i = 0; i < noise.size(); ++i)
+            input[i] = noise[i] * 1.5f;
+
+        KernelResult r;
+        r.kernel = "BrickWallLimiter::processSample";
+        r.variant = "-0.1 dB ceiling";
+        r.tolerance = limiterTolerance;
+
+        {
+            BrickWallLimiter limiter;
+            limiter.prepare(benchSampleRate);
+            limiter.setCeiling(-0.1f);
+            r.nsPerSample = timeNsPerSample(numSamples, repeats, [&]
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    output[(size_t) i] = limiter.processSample(input[(size_t) i]);
+            });
+        }
+
+        BrickWallLimiter limiter;
+        Reference::BrickWallLimiter referenceLimiter;
+        limiter.prepare(benchSampleRate);
+        limiter.setCeiling(-0.1f);
+        referenceLimiter.prepare(benchSampleRate);
+        referenceLimiter.setCeiling(-0.1f);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output[(size_t) i] = limiter.processSample(input[(size_t) i]);
+            reference[(size_t) i] = referenceLimiter.processSample(input[(size_t) i]);
+        }
+
+        r.maxAbsError = maxAbsDifference(output, reference);
+        results.add(r);
+    }
+
+    void benchmarkRouting(juce::Array<KernelResult>& results, int numSamples, int repeats)
+    {
+        std::vector<float> in[4];
+        for (int ch = 0; ch < 4; ++ch)
+            in[ch] = makeBandLimitedNoise(numSamples, 20000.0, inputSeed + 10 + ch);
+
+        std::vector<float> out[4], ref[4];
+        for (int ch = 0; ch < 4; ++ch)
+        {
+            out[ch].resize((size_t) numSamples);
+            ref[ch].resize((size_t) numSamples);
+        }
+
+        for (int algorithm = 0; algorithm < 3; ++algorithm)
+        {
+            for (int invert = 0; invert < 2; ++invert)
+            {
+                KernelResult r;
+                r.kernel = "routeSample";
+                r.variant = "algo " + juce::String(algorithm + 1) + (invert ? " swapped" : "");
+                r.tolerance = routingTolerance;
+
+                auto run = [&](auto&& route, std::vector<float>* dest)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const auto s = (size_t) i;
+                        const auto o = route(in[0][s], in[1][s], in[2][s], in[3][s], algorithm, invert);
+                        dest[0][s] = o.carrier.left;
+                        dest[1][s] = o.carrier.right;
+                        dest[2][s] = o.modulator.left;
+                        dest[3][s] = o.modulator.right;
+                    }
+                };
+
+                r.nsPerSample = timeNsPerSample(numSamples, repeats, [&] { run(routeSample, out); });
+                run(Reference::routeSample, ref);
+
+                for (int ch = 0; ch < 4; ++ch)
+                    r.maxAbsError = std::max(r.maxAbsError, maxAbsDifference(out[ch], ref[ch]));
+
+                results.add(r);
+
+                // The block kernels; no sidechain is checked against a silent one
+                for (const bool sidechain : { true, false })
+                {
+                    KernelResult block;
+                    block.kernel = "routeBlock";
+                    block.variant = r.variant + (sidechain ? "" : " no sidechain");
+                    block.tolerance = routingTolerance;
+
+                    block.nsPerSample = timeNsPerSample(numSamples, repeats, [&]
+                    {
+                        routeBlock(in[0].data(), in[1].data(), sidechain ? in[2].data() : nullptr,
+                                   sidechain ? in[3].data() : nullptr, numSamples, algorithm, invert != 0,
+                                   out[0].data(), out[1].data(), out[2].data(), out[3].data());
+                    });
+
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const auto s = (size_t) i;
+                        const auto o = Reference::routeSample(in[0][s], in[1][s], sidechain ? in[2][s] : 0.0f,
+                                                              sidechain ? in[3][s] : 0.0f, algorithm, invert);
+                        ref[0][s] = o.carrier.left;
+                        ref[1][s] = o.carrier.right;
+                        ref[2][s] = o.modulator.left;
+                        ref[3][s] = o.modulator.right;
+                    }
+
+                    for (int ch = 0; ch < 4; ++ch)
+                        block.maxAbsError = std::max(block.maxAbsError, maxAbsDifference(out[ch], ref[ch]));
+
+                    results.add(block);
+                }
+            }
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    int numSamples = args.getValueForOption("--samples").getIntValue();
+    if (numSamples <= 0)
+        numSamples = 1 << 18;
+
+    int repeats = args.getValueForOption("--repeats").getIntValue();
+    if (repeats <= 0)
+        repeats = 5;
+
+    const auto carrier = makeBandLimitedNoise(numSamples, 20000.0, inputSeed);
+
+    juce::Array<KernelResult> results;
+    benchmarkDelay(results, carrier, repeats);
+    benchmarkDelayBackends(results, carrier, repeats, parseDelayBackends(args.getValueForOption("--delay-backends")));
+    benchmarkLowPass(results, carrier, repeats);
+    benchmarkLimiter(results, carrier, repeats);
+    benchmarkRouting(results, numSamples, repeats);
+
+    juce::String csv = "kernel,variant,ns_per_sample,max_abs_error,tolerance,pass,residual_db\n";
+    int failures = 0;
+
+    for (const auto& r : results)
+    {
+        csv << r.kernel << ',' << r.variant << ','
+            << juce::String(r.nsPerSample, 3) << ','
+            << juce::String(r.maxAbsError, 9) << ','
+            << (r.gated ? juce::String(r.tolerance, 9) : juce::String()) << ','
+            << (! r.gated ? "n/a" : r.passed() ? "yes" : "NO") << ','
+            << (std::isnan(r.residualDb) ? juce::String() : juce::String(r.residualDb, 1)) << '\n';
+
+        if (! r.passed())
+        {
+            ++failures;
+            std::cerr << "MISMATCH: " << r.kernel << " [" << r.variant << "] max error "
+                      << r.maxAbsError << " > " << r.tolerance << std::endl;
+        }
+    }
+
+    const auto outPath = args.getValueForOption("--out");
+    if (outPath.isNotEmpty())
+        juce::File::getCurrentWorkingDirectory().getChildFile(outPath).replaceWithText(csv);
+    else
+        std::cout << csv;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+// The modulated delay behind one small interface, so the engine's
+// InterpolatedDelay can be measured against JUCE's dsp::DelayLine (the README
+// TODO) on the same input and modulation, and the backend picked at run time
+// by name. Every backend follows InterpolatedDelay's delay law: modSignal 0..1
+// maps linearly onto 0..maxDelayMs, no shorter than one sample.
+//
+// The JUCE lines are not in the engine: the core stays free of JUCE. They live
+// here so the decision to switch can be made on the bench's numbers.
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "InterpolatedDelay.h"
+
+#include <algorithm>
+#include <memory>
+
+class DelayBackend
+{
+public:
+    enum class Type { engineCubic, engineLagrange6, juceLagrange3rd, juceThiran };
+
+    static constexpr Type allTypes[] = { Type::engineCubic, Type::engineLagrange6, Type::juceLagrange3rd, Type::juceThiran };
+
+    virtual ~DelayBackend() = default;
+
+    virtual void prepare(double sampleRate, float maxDelayMs) = 0;
+    virtual void reset() = 0;
+
+    // One mono block; the virtual call is per block, not per sample
+    virtual void process(const float* input, const float* modSignal, float* output, int numSamples) noexcept = 0;
+
+    static std::unique_ptr<DelayBackend> create(Type type);
+
+    // The name --delay-backends takes, and the kernel column of the bench
+    static const char* getName(Type type) noexcept
+    {
+        switch (type)
+        {
+            case Type::engineCubic:     return "InterpolatedDelay";
+            case Type::engineLagrange6: return "InterpolatedDelay6";
+            case Type::juceLagrange3rd: return "DelayLine<Lagrange3rd>";
+            case Type::juceThiran:      return "DelayLine<Thiran>";
+        }
+
+        return "";
+    }
+};
+
+//==============================================================================
+class EngineDelayBackend : public DelayBackend
+{
+public:
+    explicit EngineDelayBackend(InterpolatedDelay::Interpolation interpolation)
+    {
+        delay.setInterpolation(interpolation);
+    }
+
+    void prepare(double sampleRate, float maxDelayMs) override { delay.prepare(sampleRate, maxDelayMs); }
+    void reset() override { delay.reset(); }
+
+    void process(const float* input, const float* modSignal, float* output, int numSamples) noexcept override
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = delay.process(input[i], modSignal[i]);
+    }
+
+private:
+    InterpolatedDelay delay;
+};
+
+//==============================================================================
+template <typename InterpolationType>
+class JuceDelayBackend : public DelayBackend
+{
+public:
+    void prepare(double newSampleRate, float newMaxDelayMs) override
+    {
+        sampleRate = newSampleRate;
+        maxDelayMs = std::clamp(newMaxDelayMs, 1.0f, 2000.0f);
+
+        // Lagrange3rd reads one sample either side of the delay; the headroom
+        // keeps the longest delay clear of the write position
+        line.setMaximumDelayInSamples(static_cast<int>(maxDelayMs * 0.001 * sampleRate) + 4);
+        line.prepare({ sampleRate, 512, 1 });
+    }
+
+    void reset() override { line.reset(); }
+
+    void process(const float* input, const float* modSignal, float* output, int numSamples) noexcept override
+    {
+        const float maxDelaySamples = static_cast<float>(maxDelayMs * 0.001 * sampleRate);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float delay = std::max(std::clamp(modSignal[i], 0.0f, 1.0f) * maxDelaySamples, 1.0f);
+
+            line.pushSample(0, input[i]);
+            output[i] = line.popSample(0, delay);
+        }
+    }
+
+private:
+    juce::dsp::DelayLine<float, InterpolationType> line;
+    double sampleRate = 44100.0;
+    float maxDelayMs = 100.0f;
+};
+
+//==============================================================================
+inline std::unique_ptr<DelayBackend> DelayBackend::create(Type type)
+{
+    using namespace juce::dsp::DelayLineInterpolationTypes;
+
+    switch (type)
+    {
+        case Type::engineCubic:     return std::make_unique<EngineDelayBackend>(InterpolatedDelay::Interpolation::cubic);
+        case Type::engineLagrange6: return std::make_unique<EngineDelayBackend>(InterpolatedDelay::Interpolation::lagrange6);
+        case Type::juceLagrange3rd: return std::make_unique<JuceDelayBackend<Lagrange3rd>>();
+        case Type::juceThiran:      return std::make_unique<JuceDelayBackend<Thiran>>();
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+// Frozen scalar reference implementations of the DSP kernels, copied from
+// Source/ at the point the component benchmark was introduced. Candidate
+// rewrites of InterpolatedDelay, LowPass, BrickWallLimiter and routeSample are
+// checked against these by FM_Engine_component_bench, so do NOT "fix" or
+// optimise anything in here - that would defeat the comparison. The one
+// deliberate change since: the delay's read position is a double, because
+// the engine's stopped losing precision along the buffer.
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "Routing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Reference
+{
+    //==============================================================================
+    class InterpolatedDelay
+    {
+    public:
+        InterpolatedDelay()
+        {
+            constexpr double maxDelaySeconds = 2.0;
+            constexpr double maxSampleRate = 192000.0;
+            constexpr int maxOversampling = 4;
+            const size_t maxBufferSize = static_cast<size_t>(maxDelaySeconds * maxSampleRate * maxOversampling) + 4;
+
+            buffer.resize(maxBufferSize, 0.0f);
+        }
+
+        void prepare(double newSampleRate, float newMaxDelayMs) noexcept
+        {
+            sampleRate = newSampleRate;
+            maxDelayMs = std::clamp(newMaxDelayMs, 1.0f, 2000.0f);
+            minDelayMs = std::min(static_cast<float>(1.0 / sampleRate * 1000.0), maxDelayMs - 0.1f);
+            writePos = 0;
+        }
+
+        void reset() noexcept
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            writePos = 0;
+        }
+
+        float process(float input, float modSignal) noexcept
+        {
+            if (!std::isfinite(input)) input = 0.0f;
+            if (!std::isfinite(modSignal)) modSignal = 0.0f;
+
+            if (writePos < 0 || writePos >= static_cast<int>(buffer.size()))
+                writePos = 0;
+
+            buffer[writePos] = input;
+
+            float delayMs = std::clamp(modSignal, 0.0f, 1.0f) * maxDelayMs;
+            delayMs = std::clamp(delayMs, minDelayMs, maxDelayMs);
+
+            // Read position in double: the engine's is exact (32.32 fixed
+            // point), and a float one is off by up to half a float ulp of
+            // writePos, far more than the tolerance a few seconds in
+            double delaySamples = std::clamp(delayMs * sampleRate * 0.001,
+                                             0.0,
+                                             static_cast<double>(buffer.size() - 4));
+
+            double t_pos = writePos - delaySamples;
+            if (t_pos < 0.0)
+                t_pos += buffer.size();
+
+            int idx = static_cast<int>(t_pos) % buffer.size();
+            if (idx < 0) idx += buffer.size();
+            float frac = static_cast<float>(std::clamp(t_pos - idx, 0.0, 1.0));
+
+            int idx_m1 = (idx - 1 + buffer.size()) % buffer.size();
+            int idx_1  = (idx + 1) % buffer.size();
+            int idx_2  = (idx + 2) % buffer.size();
+
+            const float y0 = buffer[idx_m1], y1 = buffer[idx], y2 = buffer[idx_1], y3 = buffer[idx_2];
+            const float c0 = y1;
+            const float c1 = 0.5f * (y2 - y0);
+            const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+            const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+            const float out = ((c3 * frac + c2) * frac + c1) * frac + c0;
+
+            writePos = (writePos + 1) % buffer.size();
+            return out;
+        }
+
+    private:
+        std::vector<float> buffer;
+        int writePos = 0;
+        double sampleRate = 44100.0;
+        float maxDelayMs = 100.0f;
+        float minDelayMs = 0.0f;
+    };
+
+    //==============================================================================
+    // Four cascaded JUCE biquads with coefficients rebuilt on every setCutoff()
+    class LowPass
+    {
+    public:
+        void prepare(double sampleRate)
+        {
+            currentSampleRate = sampleRate;
+            setCutoff(currentCutoff);
+            for (auto& f : filters)
+                f.reset();
+        }
+
+        void setCutoff(float frequencyHz)
+        {
+            const float safeCutoff = juce::jlimit(20.0f, static_cast<float>(currentSampleRate * 0.49f), frequencyHz);
+
+            // Changes of 0.01 Hz or less keep the previous cutoff
+            if (std::abs(currentCutoff - safeCutoff) > 0.01f)
+                currentCutoff = safeCutoff;
+
+            auto coeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSampleRate, currentCutoff);
+            for (auto& f : filters)
+                *f.coefficients = *coeffs;
+        }
+
+        float processSample(float input)
+        {
+            float y = input;
+            for (auto& f : filters)
+                y = f.processSample(y);
+            return std::isfinite(y) ? y : 0.0f;
+        }
+
+    private:
+        juce::dsp::IIR::Filter<float> filters[4];
+        float currentCutoff = 20000.0f;
+        double currentSampleRate = 44100.0;
+    };
+
+    //==============================================================================
+    class BrickWallLimiter
+    {
+    public:
+        void prepare(double sampleRate)
+        {
+            lookaheadSamples = std::max(4, static_cast<int>(0.003 * sampleRate));
+            lookaheadBuffer.assign(static_cast<size_t>(lookaheadSamples), 0.0f);
+            lookaheadIndex = 0;
+            gainReduction = 1.0f;
+            attackCoeff = static_cast<float>(std::exp(-1.0f / (0.1f * 0.001f * sampleRate)));
+            releaseCoeff = static_cast<float>(std::exp(-1.0f / (2.0f * 0.001f * sampleRate)));
+        }
+
+        void setCeiling(float ceilingDb)
+        {
+            ceiling = std::min(std::pow(10.0f, ceilingDb / 20.0f), 0.999f);
+        }
+
+        float processSample(float input)
+        {
+            lookaheadBuffer[lookaheadIndex] = input;
+            const float delayed = lookaheadBuffer[(lookaheadIndex + 1) % lookaheadSamples];
+
+            const float peak = std::abs(input);
+            float targetGain = 1.0f;
+            if (peak > ceiling && peak > 0.00001f)
+                targetGain = ceiling / peak;
+
+            if (targetGain < gainReduction)
+                gainReduction = targetGain + (gainReduction - targetGain) * attackCoeff;
+            else
+                gainReduction = targetGain + (gainReduction - targetGain) * releaseCoeff;
+
+            float limited = std::clamp(delayed * gainReduction, -ceiling, ceiling);
+            if (!std::isfinite(limited)) limited = 0.0f;
+
+            lookaheadIndex = (lookaheadIndex + 1) % lookaheadSamples;
+            return limited;
+        }
+
+    private:
+        int lookaheadSamples = 44;
+        std::vector<float> lookaheadBuffer;
+        int lookaheadIndex = 0;
+        float ceiling = 0.95f;
+        float gainReduction = 1.0f;
+        float attackCoeff = 0.9f;
+        float releaseCoeff = 0.999f;
+    };
+
+    //==============================================================================
+    inline RoutingOutputs routeSample(float L, float R, float SC_L, float SC_R, int algorithm, int invert)
+    {
+        RoutingOutputs output;
+        output.sideChain = { SC_L, SC_R };
+
+        StereoSample carrier {};
+        StereoSample modulator {};
+
+        switch (algorithm)
+        {
+            case 0:  carrier = { L, L }; modulator = { R, R }; break;
+            case 1:  carrier = { (L + R) * 0.5f, (L + R) * 0.5f };
+                     modulator = { (SC_L + SC_R) * 0.5f, (SC_L + SC_R) * 0.5f }; break;
+            case 2:  carrier = { L, R }; modulator = { SC_L, SC_R }; break;
+            default: carrier = { L, 0.0f }; modulator = { R, 0.0f }; break;
+        }
+
+        if (invert == 1)
+            std::swap(carrier, modulator);
+
+        output.carrier = carrier;
+        output.modulator = modulator;
+        return output;
+    }
+}
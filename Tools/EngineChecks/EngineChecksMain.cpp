@@ -0,0 +1,1253 @@
+// Headless correctness checks for FmEngineAudioProcessor.
+//
+// Real-time safety: drives the processor through its modes with the
+// RealtimeSafetyGuard probes armed around processBlock (and around the
+// parameterChanged callback, which hosts may invoke on the audio thread).
+// Any allocation, lock or blocking syscall fails the check and prints the
+// offending stack.
+//
+// Block partitioning: renders the same input with randomly cut host blocks
+// (smaller and larger than prepared) and requires bit-identical output, for
+// the single delay pair and for operator graphs.
+//
+// State: binary save/load round trip, loading legacy XML state (onto a
+// default snapshot bank), rejecting malformed chunks, oversized bank headers
+// included, without touching the parameters, and defaulting NaN/Inf values
+// in an otherwise valid chunk.
+//
+// Core: the plugin and the C API of the JUCE-free core produce the same output,
+// and the core's deterministic mode renders bit-identically for any prepared
+// size, host blocks and FPU rounding mode of the calling thread. Engines share
+// one aligned set of DSP tables, freed with the last of them. NaN and Inf are
+// rejected as parameters and washed out of the audio in the build as shipped
+// (the tools take the Release flags), not just in Debug. Algorithm, swap and
+// limiter changes crossfade rather than dipping.
+//
+// Automation: points given to the core ramp linearly and arrive on their
+// sample, with sub-blocks cut where the ramps end. Host automation in the
+// plugin is block-accurate only (one value per block); steps at block starts
+// that every block size shares render bit-identically at each.
+//
+// Layouts: main only, main + disabled sidechain and main + stereo sidechain
+// each run clean under the probes and match the C API given the same inputs
+// (no sidechain for the first two).
+//
+// Usage:
+//   FM_Engine_checks [--list] [--only=<check name>]
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#endif
+
+#include "DspTables.h"
+#include "PluginProcessor.h"
+#include "RealtimeSafetyGuard.h"
+#include "fm_engine.h"
+
+#include <algorithm>
+#include <cfenv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr double checkSampleRate = 48000.0;
+
+    //==============================================================================
+    // Owns a processor plus an input buffer big enough for the largest host
+    // block a check wants to send, and feeds it continuous test sines.
+    class ProcessorHarness
+    {
+    public:
+        ProcessorHarness(int preparedBlockSize, int maxHostBlockSize)
+        {
+            processor.setRateAndBufferSizeDetails(checkSampleRate, preparedBlockSize);
+            allocate(maxHostBlockSize);
+        }
+
+        // Adds or removes the sidechain bus, enables or disables it, and
+        // resizes the buffers for the channels left. False if the processor refused.
+        bool setSidechain(bool hasBus, bool enabled)
+        {
+            bool ok = true;
+
+            if (!hasBus && processor.getBusCount(true) > 1)
+                ok = processor.removeBus(true);
+            else if (hasBus && processor.getBusCount(true) < 2)
+                ok = processor.addBus(true);
+
+            if (ok && hasBus)
+                ok = processor.getBus(true, 1)->enable(enabled);
+
+            allocate(buffer.getNumSamples());
+            return ok;
+        }
+
+        void setParameter(const char* parameterID, float value)
+        {
+            if (auto* param = processor.apvts.getParameter(parameterID))
+                param->setValueNotifyingHost(param->convertTo0to1(value));
+        }
+
+        void prepare(int preparedBlockSize)
+        {
+            processor.setRateAndBufferSizeDetails(checkSampleRate, preparedBlockSize);
+            processor.prepareToPlay(checkSampleRate, preparedBlockSize);
+        }
+
+        // Fills and processes one host block of numSamples. The buffer view is
+        // built before the probes are armed; it refers to existing storage.
+        void processBlock(int numSamples, bool armed)
+        {
+            jassert(numSamples <= buffer.getNumSamples());
+            fill(numSamples);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                lastInput.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+            juce::AudioBuffer<float> hostBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+
+            if (armed)
+            {
+                RealtimeSafety::ScopedAudioThread audioThread;
+                processor.processBlock(hostBlock, midi);
+            }
+            else
+            {
+                processor.processBlock(hostBlock, midi);
+            }
+        }
+
+        // Output of the last processed block (main bus, left/right)
+        const float* getOutput(int channel) const { return buffer.getReadPointer(channel); }
+
+        // Input of the last processed block: main L/R, then sidechain L/R
+        const float* getInput(int channel) const { return lastInput.getReadPointer(channel); }
+
+        FmEngineAudioProcessor processor;
+
+    private:
+        void allocate(int maxHostBlockSize)
+        {
+            const int numChannels = juce::jmax(processor.getTotalNumInputChannels(),
+                                               processor.getTotalNumOutputChannels());
+            buffer.setSize(numChannels, maxHostBlockSize);
+            lastInput.setSize(numChannels, maxHostBlockSize);
+        }
+
+        void fill(int numSamples)
+        {
+            static constexpr double frequencies[] = { 220.0, 330.0, 3.0, 5.0 };
+
+            for (int ch = 0; ch < juce::jmin(4, buffer.getNumChannels()); ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                const double increment = juce::MathConstants<double>::twoPi * frequencies[ch] / checkSampleRate;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    data[i] = 0.5f * static_cast<float>(std::sin(phases[ch]));
+                    phases[ch] += increment;
+                }
+            }
+        }
+
+        juce::AudioBuffer<float> buffer, lastInput;
+        juce::MidiBuffer midi;
+        double phases[4] = {};
+    };
+
+    //==============================================================================
+    struct Check
+    {
+        const char* name;
+        std::function<bool()> run;
+    };
+
+    // Wraps a real-time-safety scenario: resets the violation counter, runs the
+    // body and passes only if no probe fired.
+    bool expectNoViolations(const std::function<void()>& body)
+    {
+        RealtimeSafety::resetViolationCount();
+        body();
+
+        const int violations = RealtimeSafety::getViolationCount();
+        if (violations != 0)
+            std::cerr << "    " << violations << " violation(s)" << std::endl;
+
+        return violations == 0;
+    }
+
+    bool checkRealtimeModeMatrix()
+    {
+        bool allPassed = true;
+
+        for (int algorithm = 0; algorithm < 3; ++algorithm)
+            for (int oversampling = 0; oversampling < 2; ++oversampling)
+                for (int limiter = 0; limiter < 2; ++limiter)
+                {
+                    const bool passed = expectNoViolations([&]
+                    {
+                        ProcessorHarness harness(512, 512);
+                        harness.setParameter(ParameterIDs::ALGORITHM, static_cast<float>(algorithm));
+                        harness.setParameter(ParameterIDs::OVERSAMPLING, oversampling ? 1.0f : 0.0f);
+                        harness.setParameter(ParameterIDs::LIMITER, limiter ? 1.0f : 0.0f);
+                        harness.setParameter(ParameterIDs::MOD_DEPTH, 0.7f);
+                        harness.prepare(512);
+
+                        for (int b = 0; b < 100; ++b)
+                            harness.processBlock(512, true);
+                    });
+
+                    if (! passed)
+                        std::cerr << "    (algorithm " << algorithm + 1 << ", oversampling " << oversampling
+                                  << ", limiter " << limiter << ")" << std::endl;
+
+                    allPassed = allPassed && passed;
+                }
+
+        return allPassed;
+    }
+
+    bool checkCutoffSweep()
+    {
+        return expectNoViolations([]
+        {
+            ProcessorHarness harness(256, 256);
+            harness.setParameter(ParameterIDs::MOD_DEPTH, 0.5f);
+            harness.prepare(256);
+
+            // Each new target makes the smoother walk the LowPass cutoff per sample
+            for (int b = 0; b < 200; ++b)
+            {
+                harness.setParameter(ParameterIDs::LP_CUTOFF, (b % 2 == 0) ? 80.0f : 12000.0f);
+                harness.processBlock(256, true);
+            }
+        });
+    }
+
+    // Sweeps MORPH between two snapshots that differ in every discrete
+    // setting, so the switch dips and crossfades happen across host block
+    // boundaries
+    bool checkPresetMorph()
+    {
+        return expectNoViolations([]
+        {
+            ProcessorHarness harness(256, 1024);
+            harness.setParameter(ParameterIDs::MOD_DEPTH, 0.2f);
+            harness.setParameter(ParameterIDs::LP_CUTOFF, 200.0f);
+            harness.processor.storeSnapshot(0);
+
+            harness.setParameter(ParameterIDs::MOD_DEPTH, 0.9f);
+            harness.setParameter(ParameterIDs::LP_CUTOFF, 15000.0f);
+            harness.setParameter(ParameterIDs::ALGORITHM, 2.0f);
+            harness.setParameter(ParameterIDs::MAX_DELAY_MS, 3.0f);
+            harness.setParameter(ParameterIDs::LIMITER, 1.0f);
+            harness.setParameter(ParameterIDs::SWAP, 1.0f);
+            harness.processor.storeSnapshot(1);
+
+            harness.setParameter(ParameterIDs::MORPH_ON, 1.0f);
+            harness.setParameter(ParameterIDs::MORPH_A, 0.0f);
+            harness.setParameter(ParameterIDs::MORPH_B, 1.0f);
+            harness.prepare(256);
+
+            juce::Random random(7);
+            for (int b = 0; b < 400; ++b)
+            {
+                harness.setParameter(ParameterIDs::MORPH, 0.5f + 0.5f * std::sin((float) b * 0.1f));
+                harness.processBlock(1 + random.nextInt(1024), true);
+            }
+        });
+    }
+
+    // Far more events than the ring holds: the overflow is dropped, never waited on
+    bool checkEventLogOverflow()
+    {
+        EventLog log;
+
+        return expectNoViolations([&log]
+        {
+            RealtimeSafety::ScopedAudioThread audioThread;
+            for (int i = 0; i < EventLog::ringSize * 4; ++i)
+                log.logAudio(EventLog::Event::discreteSwitch, i % 3, i % 4);
+        });
+    }
+
+    bool checkSmallerHostBlocks()
+    {
+        return expectNoViolations([]
+        {
+            ProcessorHarness harness(512, 512);
+            harness.setParameter(ParameterIDs::OVERSAMPLING, 1.0f);
+            harness.prepare(512);
+
+            juce::Random random(42);
+            for (int b = 0; b < 300; ++b)
+                harness.processBlock(1 + random.nextInt(512), true);
+        });
+    }
+
+    bool checkLargerHostBlocks()
+    {
+        return expectNoViolations([]
+        {
+            ProcessorHarness harness(256, 4096);
+            harness.setParameter(ParameterIDs::OVERSAMPLING, 1.0f);
+            harness.prepare(256);
+
+            for (int size : { 256, 1024, 4096, 300, 2048 })
+                harness.processBlock(size, true);
+        });
+    }
+
+    bool checkOfflineRender()
+    {
+        return expectNoViolations([]
+        {
+            ProcessorHarness harness(512, 512);
+            harness.prepare(512);
+            harness.processor.setNonRealtime(true);
+
+            for (int b = 0; b < 50; ++b)
+                harness.processBlock(512, true);
+
+            harness.processor.setNonRealtime(false);
+
+            for (int b = 0; b < 50; ++b)
+                harness.processBlock(512, true);
+        });
+    }
+
+    // Flagged before prepare, the render profile is in place from the first
+    // sample and its oversampling latency is reported; back to realtime, the
+    // latency goes back down
+    bool checkRenderProfileLatency()
+    {
+        ProcessorHarness harness(512, 512);
+
+        harness.prepare(512);
+        const int realtimeLatency = harness.processor.getLatencySamples();
+
+        harness.processor.setNonRealtime(true);
+        harness.prepare(512);
+        const int offlineLatency = harness.processor.getLatencySamples();
+
+        const bool passed = expectNoViolations([&harness]
+        {
+            for (int b = 0; b < 50; ++b)
+                harness.processBlock(512, true);
+        });
+
+        harness.processor.setNonRealtime(false);
+        harness.prepare(512);
+        const int restoredLatency = harness.processor.getLatencySamples();
+
+        if (offlineLatency <= realtimeLatency || restoredLatency != realtimeLatency)
+        {
+            std::cerr << "    latency realtime " << realtimeLatency << ", offline " << offlineLatency
+                      << ", back to realtime " << restoredLatency << std::endl;
+            return false;
+        }
+
+        return passed;
+    }
+
+    bool checkAutomationCallbacks()
+    {
+        return expectNoViolations([]
+        {
+            ProcessorHarness harness(512, 512);
+            harness.prepare(512);
+
+            static const char* const ids[] = { ParameterIDs::MOD_DEPTH, ParameterIDs::MAX_DELAY_MS,
+                                               ParameterIDs::ALGORITHM, ParameterIDs::LIMITER,
+                                               ParameterIDs::SWAP, ParameterIDs::OVERSAMPLING,
+                                               ParameterIDs::PREDELAY, ParameterIDs::LP_CUTOFF };
+
+            // Parameter IDs as hosts hand them over; built before arming
+            juce::StringArray parameterIDs;
+            for (auto* id : ids)
+                parameterIDs.add(id);
+
+            for (int b = 0; b < 20; ++b)
+            {
+                // Move the latency parameters first, so that a callback
+                // reporting the new latency straight away would be caught.
+                // setValue() stores without notifying anyone
+                for (auto* id : { ParameterIDs::MAX_DELAY_MS, ParameterIDs::PREDELAY })
+                    harness.processor.apvts.getParameter(id)->setValue(b % 2 == 0 ? 1.0f : 0.0f);
+
+                {
+                    RealtimeSafety::ScopedAudioThread audioThread;
+                    for (const auto& id : parameterIDs)
+                        harness.processor.parameterChanged(id, 0.0f);
+                }
+
+                harness.processBlock(512, true);
+            }
+        });
+    }
+
+    //==============================================================================
+    struct PartitionConfig
+    {
+        int algorithm;
+        bool oversampling;
+        bool limiter;
+        int range;
+        bool offline = false; // host flags an offline render before prepare (render profile)
+        int operators = 0;    // operator graph algorithm; 0 = the single delay pair
+    };
+
+    // Renders totalSamples through a fresh processor, cutting host blocks with
+    // nextBlockSize(), and returns the interleaved stereo output. beforeBlock,
+    // if given, gets the sample position of each block before it runs
+    std::vector<float> renderPartitioned(const PartitionConfig& config, int preparedBlockSize, int totalSamples,
+                                         const std::function<int()>& nextBlockSize, bool armed,
+                                         const std::function<void(ProcessorHarness&, int)>& beforeBlock = {})
+    {
+        ProcessorHarness harness(preparedBlockSize, 8192);
+        harness.setParameter(ParameterIDs::ALGORITHM, static_cast<float>(config.algorithm));
+        harness.setParameter(ParameterIDs::OVERSAMPLING, config.oversampling ? 1.0f : 0.0f);
+        harness.setParameter(ParameterIDs::LIMITER, config.limiter ? 1.0f : 0.0f);
+        harness.setParameter(ParameterIDs::MAX_DELAY_MS, static_cast<float>(config.range));
+        harness.setParameter(ParameterIDs::OPERATORS, static_cast<float>(config.operators));
+        harness.setParameter(ParameterIDs::MOD_DEPTH, 0.8f);
+        harness.setParameter(ParameterIDs::LP_CUTOFF, 2000.0f);
+        harness.processor.setNonRealtime(config.offline);
+        harness.prepare(preparedBlockSize);
+
+        std::vector<float> output;
+        output.reserve((size_t) totalSamples * 2);
+
+        for (int done = 0; done < totalSamples;)
+        {
+            const int blockSize = juce::jmin(juce::jlimit(1, 8192, nextBlockSize()), totalSamples - done);
+
+            if (beforeBlock)
+                beforeBlock(harness, done);
+
+            harness.processBlock(blockSize, armed);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                output.push_back(harness.getOutput(0)[i]);
+                output.push_back(harness.getOutput(1)[i]);
+            }
+
+            done += blockSize;
+        }
+
+        return output;
+    }
+
+    bool checkPartitionInvariance()
+    {
+        static const PartitionConfig configs[] =
+        {
+            { 0, false, false, 1 },
+            { 1, false, true,  2 },
+            { 2, true,  false, 1 },
+            { 2, true,  true,  3 },
+            { 0, true,  true,  0 },
+            { 1, false, true,  2, true },
+            { 0, true,  false, 1, false, 2 },   // stack
+            { 2, false, true,  1, true,  4 },   // feedback, render profile
+        };
+
+        constexpr int totalSamples = 48000;
+        static constexpr int preparedSizes[] = { 64, 256, 512, 1024 };
+
+        juce::Random random(0x5eed);
+        bool allPassed = true;
+
+        for (const auto& config : configs)
+        {
+            const auto reference = renderPartitioned(config, 512, totalSamples, [] { return 512; }, false);
+
+            for (int trial = 0; trial < 4; ++trial)
+            {
+                const int prepared = preparedSizes[random.nextInt(4)];
+
+                RealtimeSafety::resetViolationCount();
+                const auto fuzzed = renderPartitioned(config, prepared, totalSamples,
+                                                      [&random] { return 1 + random.nextInt(4096); }, true);
+
+                const bool identical = fuzzed.size() == reference.size()
+                                    && std::memcmp(fuzzed.data(), reference.data(), reference.size() * sizeof(float)) == 0;
+                const int violations = RealtimeSafety::getViolationCount();
+
+                if (! identical || violations != 0)
+                {
+                    std::cerr << "    algorithm " << config.algorithm + 1
+                              << ", oversampling " << config.oversampling
+                              << ", limiter " << config.limiter
+                              << ", range " << config.range
+                              << ", offline " << config.offline
+                              << ", operators " << config.operators
+                              << ", prepared " << prepared << ": "
+                              << (identical ? "identical" : "OUTPUT DIFFERS")
+                              << ", " << violations << " violation(s)" << std::endl;
+                    allPassed = false;
+                }
+            }
+        }
+
+        return allPassed;
+    }
+
+    //==============================================================================
+    // Puts every state parameter somewhere other than its default
+    void setNonDefaultState(ProcessorHarness& harness)
+    {
+        harness.setParameter(ParameterIDs::MOD_DEPTH, 0.37f);
+        harness.setParameter(ParameterIDs::MAX_DELAY_MS, 3.0f);
+        harness.setParameter(ParameterIDs::ALGORITHM, 2.0f);
+        harness.setParameter(ParameterIDs::LIMITER, 1.0f);
+        harness.setParameter(ParameterIDs::SWAP, 1.0f);
+        harness.setParameter(ParameterIDs::OVERSAMPLING, 1.0f);
+        harness.setParameter(ParameterIDs::PREDELAY, 1.0f);
+        harness.setParameter(ParameterIDs::LP_CUTOFF, 1234.0f);
+        harness.setParameter(ParameterIDs::OPERATORS, 3.0f);
+    }
+
+    bool parametersMatch(FmEngineAudioProcessor& expected, FmEngineAudioProcessor& actual)
+    {
+        bool allMatch = true;
+
+        for (const auto* id : BinaryState::parameterTable)
+        {
+            const float a = expected.apvts.getParameter(id)->getValue();
+            const float b = actual.apvts.getParameter(id)->getValue();
+
+            if (std::abs(a - b) > 1.0e-6f)
+            {
+                std::cerr << "    " << id << ": expected " << a << ", got " << b << std::endl;
+                allMatch = false;
+            }
+        }
+
+        return allMatch;
+    }
+
+    bool checkBinaryStateRoundTrip()
+    {
+        ProcessorHarness source(512, 512), restored(512, 512);
+        setNonDefaultState(source);
+
+        juce::MemoryBlock state;
+        source.processor.getStateInformation(state);
+
+        const int bankSize = 4 + PresetBank::numSlots * PresetBank::numValues * 4;
+        const bool compact = state.getSize() == (size_t) (BinaryState::headerSize + BinaryState::numParameters * 4 + bankSize)
+                          && BinaryState::isBinaryState(state.getData(), (int) state.getSize());
+        if (! compact)
+            std::cerr << "    unexpected chunk: " << (int) state.getSize() << " bytes" << std::endl;
+
+        restored.processor.setStateInformation(state.getData(), (int) state.getSize());
+
+        // What hosts do right after restoring: it must not recall anything
+        restored.processor.setCurrentProgram(0);
+
+        return compact && parametersMatch(source.processor, restored.processor);
+    }
+
+    bool checkPresetBankRoundTrip()
+    {
+        ProcessorHarness source(512, 512), restored(512, 512);
+
+        // Different settings in slots 2 and 5, current parameters elsewhere
+        setNonDefaultState(source);
+        source.processor.storeSnapshot(2);
+        source.setParameter(ParameterIDs::MOD_DEPTH, 0.81f);
+        source.setParameter(ParameterIDs::ALGORITHM, 1.0f);
+        source.processor.storeSnapshot(5);
+
+        juce::MemoryBlock state;
+        source.processor.getStateInformation(state);
+        restored.processor.setStateInformation(state.getData(), (int) state.getSize());
+
+        bool allMatch = true;
+        for (int slot = 0; slot < PresetBank::numSlots; ++slot)
+            for (int i = 0; i < PresetBank::numValues; ++i)
+                if (source.processor.presetBank.getValue(slot, i) != restored.processor.presetBank.getValue(slot, i))
+                {
+                    std::cerr << "    slot " << slot + 1 << ", " << BinaryState::parameterTable[i] << " differs" << std::endl;
+                    allMatch = false;
+                }
+
+        // Recalling a slot puts its values back on the parameters
+        restored.processor.recallSnapshot(2);
+        const bool recalled = std::abs(restored.processor.apvts.getParameter(ParameterIDs::MOD_DEPTH)->getValue() - 0.37f) < 1.0e-6f;
+        if (! recalled)
+            std::cerr << "    recall did not restore MOD_DEPTH" << std::endl;
+
+        return allMatch && recalled;
+    }
+
+    bool checkLegacyXmlState()
+    {
+        ProcessorHarness source(512, 512), restored(512, 512);
+        setNonDefaultState(source);
+
+        // Exactly what getStateInformation wrote before the binary format
+        juce::MemoryBlock state;
+        auto xml = source.processor.apvts.copyState().createXml();
+        juce::AudioProcessor::copyXmlToBinary(*xml, state);
+
+        // Snapshots from whatever the restored side held before must not survive
+        setNonDefaultState(restored);
+        restored.processor.storeSnapshot(0);
+
+        restored.processor.setStateInformation(state.getData(), (int) state.getSize());
+
+        auto* depth = restored.processor.apvts.getParameter(ParameterIDs::MOD_DEPTH);
+        const bool bankReset = restored.processor.presetBank.getValue(0, 0)
+                               == depth->convertFrom0to1(depth->getDefaultValue());
+        if (! bankReset)
+            std::cerr << "    snapshot 0 kept across the legacy load" << std::endl;
+
+        return parametersMatch(source.processor, restored.processor) && bankReset;
+    }
+
+    bool checkMalformedState()
+    {
+        ProcessorHarness reference(512, 512), target(512, 512);
+        setNonDefaultState(reference);
+        setNonDefaultState(target);
+
+        juce::MemoryBlock state;
+        reference.processor.getStateInformation(state);
+
+        // Truncated binary chunk, then bytes that are neither binary nor XML
+        target.processor.setStateInformation(state.getData(), (int) state.getSize() - 3);
+
+        const char garbage[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        target.processor.setStateInformation(garbage, (int) sizeof(garbage));
+
+        // A bank header claiming 65535 x 65535 values: the byte count would
+        // overflow an int and wrap past the size check
+        const int bankHeader = BinaryState::headerSize + BinaryState::numParameters * (int) sizeof(float);
+        const juce::uint8 hugeBank[] = { 0xff, 0xff, 0xff, 0xff };
+        state.copyFrom(hugeBank, bankHeader, sizeof(hugeBank));
+        target.processor.setStateInformation(state.getData(), (int) state.getSize());
+
+        return parametersMatch(reference.processor, target.processor);
+    }
+
+    // A chunk that parses but holds NaN/Inf: those parameters go to their
+    // defaults instead of through convertTo0to1
+    bool checkNonFiniteState()
+    {
+        ProcessorHarness source(512, 512), target(512, 512);
+        setNonDefaultState(source);
+
+        juce::MemoryBlock state;
+        source.processor.getStateInformation(state);
+
+        auto poke = [&state](int index, float value)
+        {
+            juce::uint32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = juce::ByteOrder::swapIfBigEndian(bits); // the chunk is little-endian
+            state.copyFrom(&bits, BinaryState::headerSize + index * (int) sizeof(float), sizeof(bits));
+        };
+
+        poke(0, std::numeric_limits<float>::quiet_NaN());   // MOD_DEPTH
+        poke(7, std::numeric_limits<float>::infinity());    // LP_CUTOFF
+        target.processor.setStateInformation(state.getData(), (int) state.getSize());
+
+        bool allPassed = true;
+
+        for (const auto* id : { ParameterIDs::MOD_DEPTH, ParameterIDs::LP_CUTOFF })
+        {
+            const auto* param = target.processor.apvts.getParameter(id);
+
+            if (param->getValue() != param->getDefaultValue())
+            {
+                std::cerr << "    " << id << ": " << param->getValue() << ", expected the default" << std::endl;
+                allPassed = false;
+            }
+        }
+
+        return allPassed;
+    }
+
+    // The plugin only wraps the core: the C API fed the same input and
+    // settings has to match it sample for sample, latency included
+    bool checkCoreMatchesPlugin()
+    {
+        constexpr int blockSize = 480;
+        ProcessorHarness harness(blockSize, blockSize);
+        harness.setParameter(ParameterIDs::MOD_DEPTH, 0.6f);
+        harness.setParameter(ParameterIDs::ALGORITHM, 2.0f);
+        harness.setParameter(ParameterIDs::MAX_DELAY_MS, 2.0f);
+        harness.setParameter(ParameterIDs::OVERSAMPLING, 1.0f);
+        harness.setParameter(ParameterIDs::LIMITER, 1.0f);
+        harness.setParameter(ParameterIDs::LP_CUTOFF, 3000.0f);
+        harness.prepare(blockSize);
+
+        std::unique_ptr<fm_engine, decltype(&fm_engine_destroy)> engine(fm_engine_create(), fm_engine_destroy);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, 0.6f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_ALGORITHM, 2.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MAX_DELAY_MS, 2.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_OVERSAMPLING, 1.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LIMITER, 1.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LP_CUTOFF, 3000.0f);
+        fm_engine_prepare(engine.get(), checkSampleRate, blockSize);
+
+        if (fm_engine_get_latency(engine.get()) != harness.processor.getLatencySamples())
+        {
+            std::cerr << "    latency: C API " << fm_engine_get_latency(engine.get())
+                      << ", plugin " << harness.processor.getLatencySamples() << std::endl;
+            return false;
+        }
+
+        std::vector<float> outL(blockSize), outR(blockSize);
+
+        for (int b = 0; b < 100; ++b)
+        {
+            harness.processBlock(blockSize, false);
+            fm_engine_process(engine.get(), harness.getInput(0), harness.getInput(1),
+                              harness.getInput(2), harness.getInput(3), outL.data(), outR.data(), blockSize);
+
+            if (std::memcmp(outL.data(), harness.getOutput(0), sizeof(float) * blockSize) != 0
+                || std::memcmp(outR.data(), harness.getOutput(1), sizeof(float) * blockSize) != 0)
+            {
+                std::cerr << "    outputs differ in block " << b << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // The C API with render settings, on a fixed stereo input and sidechain
+    std::vector<float> renderDeterministic(int preparedSize, juce::Random& blockSizes, int roundingMode)
+    {
+        constexpr int totalSamples = 48000;
+
+        std::vector<float> inL(totalSamples), inR(totalSamples), scL(totalSamples), scR(totalSamples);
+        juce::Random noise(0x5eed);
+
+        for (int i = 0; i < totalSamples; ++i)
+        {
+            inL[(size_t) i] = 0.5f * std::sin((float) i * 0.013f) + 0.05f * (noise.nextFloat() - 0.5f);
+            inR[(size_t) i] = noise.nextFloat() - 0.5f;
+            scL[(size_t) i] = std::sin((float) i * 0.0011f);
+            scR[(size_t) i] = noise.nextFloat() - 0.5f;
+        }
+
+        std::unique_ptr<fm_engine, decltype(&fm_engine_destroy)> engine(fm_engine_create(), fm_engine_destroy);
+        fm_engine_set_deterministic(engine.get(), 1);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, 0.7f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_ALGORITHM, 2.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LIMITER, 1.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_RENDER_QUALITY, 1.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LP_CUTOFF, 900.0f);
+        fm_engine_prepare(engine.get(), checkSampleRate, preparedSize);
+        fm_engine_reset(engine.get());
+
+        std::vector<float> out((size_t) totalSamples * 2);
+        std::fesetround(roundingMode);
+
+        for (int start = 0; start < totalSamples;)
+        {
+            const int n = juce::jmin(totalSamples - start, 1 + blockSizes.nextInt(3000));
+            fm_engine_process(engine.get(), &inL[(size_t) start], &inR[(size_t) start], &scL[(size_t) start],
+                              &scR[(size_t) start], &out[(size_t) start], &out[(size_t) (totalSamples + start)], n);
+            start += n;
+        }
+
+        std::fesetround(FE_TONEAREST);
+        return out;
+    }
+
+    bool checkDeterministicMode()
+    {
+        juce::Random blockSizes(0x5eed);
+        const auto reference = renderDeterministic(512, blockSizes, FE_TONEAREST);
+
+        static constexpr int preparedSizes[] = { 64, 480, 4096 };
+        static constexpr int roundingModes[] = { FE_TONEAREST, FE_UPWARD, FE_TOWARDZERO };
+
+        bool allPassed = true;
+
+        for (const int prepared : preparedSizes)
+        {
+            for (const int rounding : roundingModes)
+            {
+                const auto render = renderDeterministic(prepared, blockSizes, rounding);
+
+                if (std::memcmp(render.data(), reference.data(), reference.size() * sizeof(float)) != 0)
+                {
+                    std::cerr << "    prepared " << prepared << ", rounding mode " << rounding
+                              << ": OUTPUT DIFFERS" << std::endl;
+                    allPassed = false;
+                }
+            }
+        }
+
+        return allPassed;
+    }
+
+    //==============================================================================
+    // -ffast-math alone would let the compiler drop every std::isfinite guard.
+    // The check looks at the bit pattern, so its own flags can't hide anything
+    bool isFiniteBits(float x) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return (bits & 0x7f800000u) != 0x7f800000u;
+    }
+
+    bool checkNonFiniteRejected()
+    {
+        constexpr int totalSamples = 10240;
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        const float inf = std::numeric_limits<float>::infinity();
+
+        std::unique_ptr<fm_engine, decltype(&fm_engine_destroy)> engine(fm_engine_create(), fm_engine_destroy);
+        bool allPassed = true;
+
+        if (fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, nan) != -1
+            || fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LP_CUTOFF, inf) != -1
+            || fm_engine_automate(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, 0, nan) != -1
+            || fm_engine_get_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH) != fm_engine_param_default(FM_ENGINE_PARAM_MOD_DEPTH))
+        {
+            std::cerr << "    non-finite parameter value accepted" << std::endl;
+            allPassed = false;
+        }
+
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, 0.7f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_ALGORITHM, 2.0f);
+        fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LIMITER, 1.0f);
+        fm_engine_prepare(engine.get(), checkSampleRate, 512);
+
+        std::vector<float> inL(totalSamples), inR(totalSamples), scL(totalSamples), scR(totalSamples);
+        for (int i = 0; i < totalSamples; ++i)
+        {
+            inL[(size_t) i] = inR[(size_t) i] = 0.5f * std::sin((float) i * 0.05f);
+            scL[(size_t) i] = scR[(size_t) i] = std::sin((float) i * 0.003f);
+        }
+
+        inL[100] = nan;
+        inR[300] = inf;
+        scL[200] = -inf;
+        scR[400] = nan;
+
+        std::vector<float> outL(totalSamples), outR(totalSamples);
+        fm_engine_process(engine.get(), inL.data(), inR.data(), scL.data(), scR.data(), outL.data(), outR.data(), totalSamples);
+
+        int nonFinite = 0;
+        for (int i = 0; i < totalSamples; ++i)
+            nonFinite += (isFiniteBits(outL[(size_t) i]) ? 0 : 1) + (isFiniteBits(outR[(size_t) i]) ? 0 : 1);
+
+        if (nonFinite != 0)
+        {
+            std::cerr << "    " << nonFinite << " non-finite output samples" << std::endl;
+            allPassed = false;
+        }
+
+        return allPassed;
+    }
+
+    //==============================================================================
+    // Every engine reads the one process-wide set of tables, cache-line
+    // aligned, and it goes away with the last engine
+    bool checkSharedTables()
+    {
+        std::weak_ptr<const DspTables> released;
+        bool allPassed = true;
+
+        {
+            ProcessorHarness first(512, 512), second(512, 512);
+            first.prepare(512);
+            second.prepare(512);
+
+            const auto tables = DspTables::get();
+
+            // Each engine holds it from two limiters and two oversamplers
+            if (tables != DspTables::get() || tables.use_count() < 1 + 2 * 4)
+            {
+                std::cerr << "    " << tables.use_count() - 1 << " holders, expected 8 or more" << std::endl;
+                allPassed = false;
+            }
+
+            auto aligned = [](const void* p) { return reinterpret_cast<std::uintptr_t>(p) % 64 == 0; };
+
+            for (int s = 0; s < DspTables::numHalfBandStages; ++s)
+                allPassed = aligned(&tables->getHalfBandKernel(s)) && allPassed;
+
+            if (! aligned(&tables->getTruePeakCoefficients()) || ! allPassed)
+            {
+                std::cerr << "    tables not on cache-line boundaries" << std::endl;
+                allPassed = false;
+            }
+
+            released = tables;
+        }
+
+        if (! released.expired())
+        {
+            std::cerr << "    tables outlived every engine" << std::endl;
+            allPassed = false;
+        }
+
+        return allPassed;
+    }
+
+    //==============================================================================
+    // Algorithm, swap and limiter crossfade: the same sine on every input
+    // never drops towards silence through them (the limiter's comes out of its
+    // lookahead line, so mixing it with the dry output combs briefly, but
+    // stays well clear). A range change still dips to silence.
+    bool checkSwitchCrossfades()
+    {
+        FmEngineCore core;
+        FmEngineCore::Settings settings;
+        core.setSettings(settings);
+        core.prepare(checkSampleRate, 512);
+
+        constexpr int blockSize = 4800;
+        constexpr int window = 48;
+        std::vector<float> input(blockSize), outL(blockSize), outR(blockSize);
+        int position = 0;
+
+        // Lowest 1 ms RMS over the first 20 ms of a block, and the block's last
+        auto render = [&](float& lowest, float& last)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                input[(size_t) i] = 0.5f * (float) std::sin(2.0 * juce::MathConstants<double>::pi * 440.0 * (position + i) / checkSampleRate);
+            position += blockSize;
+
+            core.process(input.data(), input.data(), input.data(), input.data(), outL.data(), outR.data(), blockSize);
+
+            auto rms = [&](int start)
+            {
+                double sum = 0.0;
+                for (int i = start; i < start + window; ++i)
+                    sum += outL[(size_t) i] * outL[(size_t) i];
+                return (float) std::sqrt(sum / window);
+            };
+
+            lowest = std::numeric_limits<float>::max();
+            for (int start = 0; start < 20 * window; start += window / 2)
+                lowest = std::min(lowest, rms(start));
+            last = rms(blockSize - window);
+        };
+
+        float lowest = 0.0f, steady = 0.0f;
+        for (int b = 0; b < 5; ++b)
+            render(lowest, steady);
+
+        bool passed = true;
+
+        auto change = [&](const char* name, const std::function<void(FmEngineCore::Settings&)>& apply, bool dips)
+        {
+            apply(settings);
+            core.setSettings(settings);
+
+            const float before = steady;
+            render(lowest, steady);
+
+            if (dips != (lowest < 0.1f * before))
+            {
+                std::cerr << "    " << name << ": level fell to " << lowest << " from " << before
+                          << (dips ? ", expected a dip" : "") << std::endl;
+                passed = false;
+            }
+        };
+
+        change("algorithm", [](auto& s) { s.algorithm = 2; }, false);
+        change("swap",      [](auto& s) { s.swap = true; }, false);
+        change("limiter",   [](auto& s) { s.limiter = true; }, false);
+        change("both",      [](auto& s) { s.limiter = false; s.algorithm = 1; }, false);
+        change("range",     [](auto& s) { s.range = 2; }, true);
+
+        return passed;
+    }
+
+    //==============================================================================
+    // Collects the depth-scaled modulator and the sub-block sizes
+    struct ModulatorCapture : FmEngineCore::Observer
+    {
+        std::vector<float> modulator;
+        std::vector<int> subBlockSizes;
+
+        void subBlockProcessed(float, float, const float* modL, const float*, int numSamples, float) noexcept override
+        {
+            modulator.insert(modulator.end(), modL, modL + numSamples);
+            subBlockSizes.push_back(numSamples);
+        }
+    };
+
+    bool checkSampleAccurateAutomation()
+    {
+        // Full stereo routing with a DC sidechain: once the low-pass has
+        // settled, the captured modulator is the depth itself
+        FmEngineCore core;
+        ModulatorCapture capture;
+        core.setObserver(&capture);
+
+        FmEngineCore::Settings settings;
+        settings.algorithm = 2;
+        settings.modDepth = 0.0f;
+        core.setSettings(settings);
+        core.prepare(checkSampleRate, 512);
+        core.reset();
+
+        constexpr int blockSize = 2048;
+        std::vector<float> silence(blockSize, 0.0f), ones(blockSize, 1.0f), outL(blockSize), outR(blockSize);
+
+        for (int b = 0; b < 10; ++b)
+            core.process(silence.data(), silence.data(), ones.data(), ones.data(), outL.data(), outR.data(), blockSize);
+
+        capture.modulator.clear();
+        capture.subBlockSizes.clear();
+
+        // Out of order on purpose
+        core.addAutomationPoint(FmEngineCore::AutomatedParameter::modDepth, 1500, 0.25f);
+        core.addAutomationPoint(FmEngineCore::AutomatedParameter::modDepth, 1000, 1.0f);
+        core.process(silence.data(), silence.data(), ones.data(), ones.data(), outL.data(), outR.data(), blockSize);
+
+        bool passed = true;
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const float expected = i < 1000 ? (float) (i + 1) / 1000.0f
+                                 : i < 1500 ? 1.0f - 0.75f * (float) (i - 999) / 500.0f
+                                            : 0.25f;
+
+            if (std::abs(capture.modulator[(size_t) i] - expected) > 1.0e-4f)
+            {
+                std::cerr << "    sample " << i << ": depth " << capture.modulator[(size_t) i]
+                          << ", expected " << expected << std::endl;
+                passed = false;
+                break;
+            }
+        }
+
+        // Cuts at both points, so the held stretch after 1500 runs settled
+        std::vector<int> boundaries;
+        for (int size : capture.subBlockSizes)
+            boundaries.push_back((boundaries.empty() ? 0 : boundaries.back()) + size);
+
+        for (int point : { 1000, 1500 })
+        {
+            if (std::find(boundaries.begin(), boundaries.end(), point) == boundaries.end())
+            {
+                std::cerr << "    no sub-block boundary at " << point << std::endl;
+                passed = false;
+            }
+        }
+
+        if (core.getSettings().modDepth != 0.25f)
+        {
+            std::cerr << "    target depth " << core.getSettings().modDepth << " after the last point" << std::endl;
+            passed = false;
+        }
+
+        return passed;
+    }
+
+    // Host automation steps depth and cutoff every 4096 samples. The plugin
+    // only sees a value per block, so this is about block starts, not sample
+    // positions: every block size that divides 4096 sees the steps at the same
+    // samples, and must render the same, the smoothing running a fixed time
+    // rather than to the block's end
+    bool checkHostStepBlockSizes()
+    {
+        static const PartitionConfig configs[] =
+        {
+            { 0, false, false, 1 },
+            { 2, true,  true,  2 },
+            { 1, false, false, 1, false, 3 },   // parallel
+        };
+
+        constexpr int stepInterval = 4096;
+        constexpr int totalSamples = 8 * stepInterval;
+
+        const auto automate = [](ProcessorHarness& harness, int position)
+        {
+            if (position % stepInterval != 0)
+                return;
+
+            const int step = position / stepInterval;
+            harness.setParameter(ParameterIDs::MOD_DEPTH, 0.1f + 0.4f * (float) (step % 3));
+            harness.setParameter(ParameterIDs::LP_CUTOFF, 300.0f + 1500.0f * (float) (step % 4));
+        };
+
+        bool allPassed = true;
+
+        for (const auto& config : configs)
+        {
+            const auto reference = renderPartitioned(config, stepInterval, totalSamples,
+                                                     [] { return stepInterval; }, false, automate);
+
+            for (int blockSize : { 32, 64, 512, 1024 })
+            {
+                const auto output = renderPartitioned(config, blockSize, totalSamples,
+                                                      [blockSize] { return blockSize; }, false, automate);
+
+                if (output.size() != reference.size()
+                    || std::memcmp(output.data(), reference.data(), reference.size() * sizeof(float)) != 0)
+                {
+                    std::cerr << "    algorithm " << config.algorithm + 1
+                              << ", oversampling " << config.oversampling
+                              << ", limiter " << config.limiter
+                              << ", operators " << config.operators
+                              << ", blocks of " << blockSize << ": OUTPUT DIFFERS" << std::endl;
+                    allPassed = false;
+                }
+            }
+        }
+
+        return allPassed;
+    }
+
+    //==============================================================================
+    struct LayoutConfig
+    {
+        const char* name;
+        bool hasBus, enabled;
+    };
+
+    bool checkInputLayouts()
+    {
+        static const LayoutConfig layouts[] =
+        {
+            { "main only",          false, false },
+            { "sidechain disabled", true,  false },
+            { "main + sidechain",   true,  true },
+        };
+
+        constexpr int blockSize = 512;
+        bool allPassed = true;
+
+        for (const auto& layout : layouts)
+        {
+            for (int algorithm = 0; algorithm < 3; ++algorithm)
+            {
+                ProcessorHarness harness(blockSize, blockSize);
+                if (!harness.setSidechain(layout.hasBus, layout.enabled))
+                {
+                    std::cerr << "    " << layout.name << ": layout refused" << std::endl;
+                    allPassed = false;
+                    break;
+                }
+
+                harness.setParameter(ParameterIDs::ALGORITHM, (float) algorithm);
+                harness.setParameter(ParameterIDs::MOD_DEPTH, 0.6f);
+                harness.prepare(blockSize);
+
+                std::unique_ptr<fm_engine, decltype(&fm_engine_destroy)> engine(fm_engine_create(), fm_engine_destroy);
+                fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_ALGORITHM, (float) algorithm);
+                fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, 0.6f);
+                fm_engine_prepare(engine.get(), checkSampleRate, blockSize);
+
+                const bool withSidechain = layout.hasBus && layout.enabled;
+                std::vector<float> outL(blockSize), outR(blockSize);
+                bool identical = true;
+
+                RealtimeSafety::resetViolationCount();
+
+                for (int b = 0; b < 50 && identical; ++b)
+                {
+                    harness.processBlock(blockSize, true);
+                    fm_engine_process(engine.get(), harness.getInput(0), harness.getInput(1),
+                                      withSidechain ? harness.getInput(2) : nullptr,
+                                      withSidechain ? harness.getInput(3) : nullptr,
+                                      outL.data(), outR.data(), blockSize);
+
+                    identical = std::memcmp(outL.data(), harness.getOutput(0), sizeof(float) * blockSize) == 0
+                             && std::memcmp(outR.data(), harness.getOutput(1), sizeof(float) * blockSize) == 0;
+                }
+
+                const int violations = RealtimeSafety::getViolationCount();
+
+                if (!identical || violations != 0)
+                {
+                    std::cerr << "    " << layout.name << ", algorithm " << algorithm + 1 << ": "
+                              << (identical ? "identical" : "OUTPUT DIFFERS") << ", "
+                              << violations << " violation(s)" << std::endl;
+                    allPassed = false;
+                }
+            }
+        }
+
+        return allPassed;
+    }
+
+    const Check checks[] =
+    {
+        { "rt-safety: mode matrix",             checkRealtimeModeMatrix },
+        { "rt-safety: cutoff sweep",            checkCutoffSweep },
+        { "rt-safety: preset morph",            checkPresetMorph },
+        { "rt-safety: event log overflow",      checkEventLogOverflow },
+        { "rt-safety: smaller host blocks",     checkSmallerHostBlocks },
+        { "rt-safety: larger host blocks",      checkLargerHostBlocks },
+        { "rt-safety: offline render",          checkOfflineRender },
+        { "rt-safety: render profile latency",  checkRenderProfileLatency },
+        { "rt-safety: automation callbacks",    checkAutomationCallbacks },
+        { "partitioning: bit-identical output", checkPartitionInvariance },
+        { "state: binary round trip",           checkBinaryStateRoundTrip },
+        { "state: preset bank round trip",      checkPresetBankRoundTrip },
+        { "state: legacy XML load",             checkLegacyXmlState },
+        { "state: malformed chunks ignored",    checkMalformedState },
+        { "state: NaN/Inf values defaulted",    checkNonFiniteState },
+        { "core: C API matches the plugin",     checkCoreMatchesPlugin },
+        { "core: deterministic mode",           checkDeterministicMode },
+        { "core: shared DSP tables",            checkSharedTables },
+        { "core: NaN/Inf rejected in Release",  checkNonFiniteRejected },
+        { "core: cheap switches crossfade",     checkSwitchCrossfades },
+        { "automation: sample-accurate points", checkSampleAccurateAutomation },
+        { "automation: host steps, any blocks", checkHostStepBlockSizes },
+        { "layouts: every supported layout",    checkInputLayouts },
+    };
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    RealtimeSafety::initialise();
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--list"))
+    {
+        for (const auto& check : checks)
+            std::cout << check.name << std::endl;
+        return 0;
+    }
+
+    const auto only = args.getValueForOption("--only");
+    std::cout << "Probing: " << RealtimeSafety::getProbeDescription() << std::endl;
+
+    int failures = 0;
+    for (const auto& check : checks)
+    {
+        if (only.isNotEmpty() && ! juce::String(check.name).containsIgnoreCase(only))
+            continue;
+
+        std::cout << "[ RUN  ] " << check.name << std::endl;
+        const bool passed = check.run();
+        std::cout << (passed ? "[  OK  ] " : "[ FAIL ] ") << check.name << std::endl;
+
+        if (! passed)
+            ++failures;
+    }
+
+    std::cout << (failures == 0 ? "All checks passed" : juce::String(failures) + " check(s) failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
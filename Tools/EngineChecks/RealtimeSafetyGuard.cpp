@@ -0,0 +1,286 @@
+#include "RealtimeSafetyGuard.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__) || defined(__APPLE__)
+ #define FM_RT_PROBE_POSIX 1
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+ #include <time.h>
+ #include <unistd.h>
+#else
+ #define FM_RT_PROBE_POSIX 0
+#endif
+
+#if defined(__linux__)
+ #define FM_RT_PROBE_MALLOC 1
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void  __libc_free(void*);
+    void* __libc_memalign(size_t, size_t);
+}
+#else
+ #define FM_RT_PROBE_MALLOC 0
+#endif
+
+namespace
+{
+    thread_local bool isAudioThread = false;
+    thread_local bool isReporting = false;
+
+    std::atomic<int> violationCount { 0 };
+
+    // Only the first few violations get a full stack; per-sample offenders
+    // would otherwise bury the output
+    constexpr int maxReportedStacks = 8;
+
+   #if FM_RT_PROBE_POSIX
+    using WriteFn      = ssize_t (*)(int, const void*, size_t);
+    using ReadFn       = ssize_t (*)(int, void*, size_t);
+    using MutexFn      = int (*)(pthread_mutex_t*);
+    using CondWaitFn   = int (*)(pthread_cond_t*, pthread_mutex_t*);
+    using NanosleepFn  = int (*)(const struct timespec*, struct timespec*);
+    using UsleepFn     = int (*)(useconds_t);
+
+    WriteFn     realWrite = nullptr;
+    ReadFn      realRead = nullptr;
+    MutexFn     realMutexLock = nullptr;
+    CondWaitFn  realCondWait = nullptr;
+    NanosleepFn realNanosleep = nullptr;
+    UsleepFn    realUsleep = nullptr;
+
+    template <typename Fn>
+    Fn resolve(Fn& slot, const char* name) noexcept
+    {
+        if (slot == nullptr)
+            slot = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+        return slot;
+    }
+
+    void writeToStderr(const char* text) noexcept
+    {
+        if (auto fn = resolve(realWrite, "write"))
+            fn(STDERR_FILENO, text, std::strlen(text));
+    }
+   #else
+    void writeToStderr(const char*) noexcept {}
+   #endif
+
+    void noteViolation(const char* what) noexcept
+    {
+        if (! isAudioThread || isReporting)
+            return;
+
+        isReporting = true;
+        const int index = ++violationCount;
+
+        if (index <= maxReportedStacks)
+        {
+            writeToStderr("\n*** real-time violation on audio thread: ");
+            writeToStderr(what);
+            writeToStderr("\n");
+
+           #if FM_RT_PROBE_POSIX
+            void* frames[48];
+            const int numFrames = backtrace(frames, 48);
+            backtrace_symbols_fd(frames, numFrames, STDERR_FILENO);
+           #endif
+        }
+        else if (index == maxReportedStacks + 1)
+        {
+            writeToStderr("*** further violations counted but not printed\n");
+        }
+
+        isReporting = false;
+    }
+
+    //==============================================================================
+    void* rawMalloc(std::size_t size) noexcept
+    {
+       #if FM_RT_PROBE_MALLOC
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void rawFree(void* p) noexcept
+    {
+       #if FM_RT_PROBE_MALLOC
+        __libc_free(p);
+       #else
+        std::free(p);
+       #endif
+    }
+
+    void* checkedNew(std::size_t size)
+    {
+        noteViolation("operator new");
+
+        if (void* p = rawMalloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void* checkedAlignedNew(std::size_t size, std::align_val_t alignment)
+    {
+        noteViolation("operator new (aligned)");
+
+        const auto align = static_cast<std::size_t>(alignment);
+        size = size == 0 ? align : size;
+
+       #if FM_RT_PROBE_MALLOC
+        if (void* p = __libc_memalign(align, size))
+            return p;
+       #elif FM_RT_PROBE_POSIX
+        void* p = nullptr;
+        if (posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size) == 0)
+            return p;
+       #else
+        if (void* p = _aligned_malloc(size, align))
+            return p;
+       #endif
+
+        throw std::bad_alloc();
+    }
+
+    void checkedDelete(void* p) noexcept
+    {
+        if (p != nullptr)
+            noteViolation("operator delete");
+        rawFree(p);
+    }
+
+    void checkedAlignedDelete(void* p) noexcept
+    {
+        if (p != nullptr)
+            noteViolation("operator delete (aligned)");
+
+       #if FM_RT_PROBE_POSIX
+        rawFree(p);
+       #else
+        _aligned_free(p);
+       #endif
+    }
+}
+
+//==============================================================================
+namespace RealtimeSafety
+{
+    void initialise()
+    {
+       #if FM_RT_PROBE_POSIX
+        resolve(realWrite, "write");
+        resolve(realRead, "read");
+        resolve(realMutexLock, "pthread_mutex_lock");
+        resolve(realCondWait, "pthread_cond_wait");
+        resolve(realNanosleep, "nanosleep");
+        resolve(realUsleep, "usleep");
+
+        // The first backtrace() call may dlopen the unwinder, which allocates
+        void* frames[4];
+        backtrace(frames, 4);
+       #endif
+    }
+
+    int getViolationCount() noexcept      { return violationCount.load(); }
+    void resetViolationCount() noexcept   { violationCount = 0; }
+
+    const char* getProbeDescription() noexcept
+    {
+       #if FM_RT_PROBE_MALLOC
+        return "operator new/delete, malloc/calloc/realloc/free, pthread_mutex_lock, "
+               "pthread_cond_wait, read, write, nanosleep, usleep";
+       #elif FM_RT_PROBE_POSIX
+        return "operator new/delete, plus pthread_mutex_lock, pthread_cond_wait, read, write, nanosleep, usleep "
+               "when called directly from this executable (not from inside system libraries)";
+       #else
+        return "operator new/delete";
+       #endif
+    }
+
+    ScopedAudioThread::ScopedAudioThread() noexcept   { isAudioThread = true; }
+    ScopedAudioThread::~ScopedAudioThread() noexcept  { isAudioThread = false; }
+}
+
+//==============================================================================
+void* operator new  (std::size_t size)                                  { return checkedNew(size); }
+void* operator new[](std::size_t size)                                  { return checkedNew(size); }
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept  { try { return checkedNew(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept  { try { return checkedNew(size); } catch (...) { return nullptr; } }
+void* operator new  (std::size_t size, std::align_val_t a)              { return checkedAlignedNew(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a)              { return checkedAlignedNew(size, a); }
+
+void operator delete  (void* p) noexcept                                { checkedDelete(p); }
+void operator delete[](void* p) noexcept                                { checkedDelete(p); }
+void operator delete  (void* p, std::size_t) noexcept                   { checkedDelete(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { checkedDelete(p); }
+void operator delete  (void* p, const std::nothrow_t&) noexcept         { checkedDelete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept         { checkedDelete(p); }
+void operator delete  (void* p, std::align_val_t) noexcept              { checkedAlignedDelete(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { checkedAlignedDelete(p); }
+void operator delete  (void* p, std::size_t, std::align_val_t) noexcept { checkedAlignedDelete(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { checkedAlignedDelete(p); }
+
+//==============================================================================
+// C-level interposers. Defining these in the executable makes every call from
+// the processor, JUCE and libstdc++ land here first on Linux; on macOS only
+// the executable's own calls do (see RealtimeSafetyGuard.h).
+#if FM_RT_PROBE_MALLOC
+extern "C"
+{
+    void* malloc(size_t size)               { noteViolation("malloc");  return __libc_malloc(size); }
+    void* calloc(size_t n, size_t size)     { noteViolation("calloc");  return __libc_calloc(n, size); }
+    void* realloc(void* p, size_t size)     { noteViolation("realloc"); return __libc_realloc(p, size); }
+    void  free(void* p)                     { if (p != nullptr) noteViolation("free"); __libc_free(p); }
+}
+#endif
+
+#if FM_RT_PROBE_POSIX
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        noteViolation("pthread_mutex_lock");
+        return resolve(realMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+    {
+        noteViolation("pthread_cond_wait");
+        return resolve(realCondWait, "pthread_cond_wait")(cond, mutex);
+    }
+
+    ssize_t write(int fd, const void* data, size_t size)
+    {
+        noteViolation("write");
+        return resolve(realWrite, "write")(fd, data, size);
+    }
+
+    ssize_t read(int fd, void* data, size_t size)
+    {
+        noteViolation("read");
+        return resolve(realRead, "read")(fd, data, size);
+    }
+
+    int nanosleep(const struct timespec* request, struct timespec* remaining)
+    {
+        noteViolation("nanosleep");
+        return resolve(realNanosleep, "nanosleep")(request, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        noteViolation("usleep");
+        return resolve(realUsleep, "usleep")(microseconds);
+    }
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+// Audio-thread safety probes for FM_Engine_checks.
+//
+// RealtimeSafetyGuard.cpp replaces operator new/delete for the whole
+// executable and, where the platform allows, interposes malloc/calloc/
+// realloc/free (Linux), pthread mutex/condition waits and a handful of
+// blocking syscalls. While a ScopedAudioThread is alive on a thread, every
+// call to one of those from that thread counts as a violation and its stack
+// is written to stderr.
+//
+// On Linux the C-level probes see calls from every library in the process.
+// On macOS the two-level namespace binds each dylib's calls when it is
+// linked, so they only see calls made directly from code built into this
+// executable (the processor, the core, JUCE). The same functions reached
+// from inside libc++, libSystem or a framework (std::mutex, for one) go
+// unseen there; only operator new/delete is complete.
+namespace RealtimeSafety
+{
+    // Resolves the real symbols and primes backtrace() so that neither
+    // allocates the first time a violation is reported. Call once from main().
+    void initialise();
+
+    // Violations seen since the last reset, across all threads
+    int getViolationCount() noexcept;
+    void resetViolationCount() noexcept;
+
+    // Human-readable list of what is being probed on this platform
+    const char* getProbeDescription() noexcept;
+
+    // Marks the calling thread as the audio thread for the object's lifetime
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+
+        ScopedAudioThread(const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator=(const ScopedAudioThread&) = delete;
+    };
+}
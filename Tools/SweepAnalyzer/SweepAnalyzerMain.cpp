@@ -0,0 +1,375 @@
+// Quality/CPU sweep of the engine core over its parameter grid.
+//
+// For every combination of MOD_DEPTH x MAX_DELAY_MS x LP_CUTOFF x ALGORITHM
+// x oversampling (off, 2x, the 4x render profile) it renders a sine carrier
+// modulated by a sine, measures the spectrum of the steady-state output and
+// times the render. Points run in parallel, one engine per worker.
+//
+// The test tones sit exactly on FFT bins (carrier bin 1367, modulator bin
+// 137 of 65536: about 1001 Hz and 100 Hz at 48 kHz), so with a rectangular
+// window every periodic component lands in one bin. The ideal,
+// continuous-time effect can only produce the carrier and its harmonics,
+// each with modulator sidebands: bins |n * carrier + k * modulator| for
+// n = 0..5 and any k, i.e. bins congruent to +-n * carrier modulo the
+// modulator bin. Images of those products folded back from m * fs (m = 1..4,
+// up to the 4x domain) fall into other residue classes; the rest is noise,
+// which does not repeat with the input (rounding, delay read-position
+// jitter). Noise spreads evenly, so aliasing is the excess of the image bins
+// over the noise floor measured in the remaining bins. Below 20 Hz is left
+// out: that is the DC high-pass's business.
+//
+//   THD+N     everything but the FM spectrum of the carrier itself (n = 1),
+//             relative to the whole output
+//   aliasing  folded images above the noise floor, relative to the output
+//   harmonics the legitimate products with n != 1 (clipper/limiter)
+//   noise     the non-periodic remainder, relative to the output
+//
+// ns/sample is measured while all workers run; use --threads=1 for numbers
+// that are comparable with FM_Engine_benchmark.
+//
+// Usage:
+//   FM_Engine_sweep [--out=<file.csv>] [--threads=N] [--sample-rate=48000] [--quick]
+
+#if __has_include("JuceHeader.h")
+#include "JuceHeader.h"
+#else
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "fm_engine.h"
+#include "WorkStealingPool.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr int fftOrder = 16;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int carrierBin = 1367;
+    constexpr int modulatorBin = 137; // prime; with this carrier no image shares a residue with a product
+    constexpr int maxHarmonic = 5;
+    constexpr int maxImage = 4;       // images of the 4x domain fold back from up to 4 * fs
+    constexpr double lowestHz = 20.0; // below this, the DC high-pass's business
+    constexpr int blockSize = 512;
+
+    constexpr int rangeMs[] = { 1, 10, 100, 500 }; // FM_ENGINE_PARAM_MAX_DELAY_MS index to ms
+
+    enum class Oversampling { off, twoTimes, renderProfile };
+
+    const char* toString(Oversampling oversampling)
+    {
+        switch (oversampling)
+        {
+            case Oversampling::off:           return "off";
+            case Oversampling::twoTimes:      return "2x";
+            case Oversampling::renderProfile: return "4x-render";
+        }
+
+        return "";
+    }
+
+    struct SweepPoint
+    {
+        float modDepth = 0.0f;
+        int range = 0;
+        float lpCutoff = 20000.0f;
+        int algorithm = 0;
+        Oversampling oversampling = Oversampling::off;
+    };
+
+    struct SweepResult
+    {
+        double nsPerSample = 0.0;
+        double thdPlusNoiseDb = 0.0;
+        double aliasingDb = 0.0;
+        double harmonicsDb = 0.0;
+        double noiseDb = 0.0;
+    };
+
+    double toDb(double powerRatio)
+    {
+        return 10.0 * std::log10(juce::jmax(powerRatio, 1.0e-30));
+    }
+
+    // What each bin can hold: harmonic n (0..maxHarmonic) for a product
+    // |n * carrier + k * modulator|, imageBin for a folded image of one, or
+    // noiseBin. Products are congruent to +-n * carrier modulo the modulator
+    // bin, images to +-(m * fftSize - n * carrier).
+    constexpr int imageBin = -2;
+    constexpr int noiseBin = -1;
+
+    std::vector<int> classifyBins()
+    {
+        std::vector<int> classOfResidue((size_t) modulatorBin, noiseBin);
+
+        auto mark = [&classOfResidue](juce::int64 value, int binClass)
+        {
+            const auto residue = (int) (((value % modulatorBin) + modulatorBin) % modulatorBin);
+            classOfResidue[(size_t) residue] = binClass;
+            classOfResidue[(size_t) ((modulatorBin - residue) % modulatorBin)] = binClass;
+        };
+
+        for (int m = 1; m <= maxImage; ++m)
+            for (int n = 0; n <= maxHarmonic; ++n)
+                mark((juce::int64) m * fftSize - (juce::int64) n * carrierBin, imageBin);
+
+        // Legitimate products win any residue they share with an image
+        for (int n = maxHarmonic; n >= 0; --n)
+            mark((juce::int64) n * carrierBin, n);
+
+        std::vector<int> classOfBin((size_t) fftSize / 2 + 1);
+        for (int bin = 0; bin <= fftSize / 2; ++bin)
+            classOfBin[(size_t) bin] = classOfResidue[(size_t) (bin % modulatorBin)];
+
+        return classOfBin;
+    }
+
+    // One period of each test tone plus a block's worth of wrap-around, so any
+    // block can be read contiguously from position % fftSize
+    struct TestSignals
+    {
+        std::vector<float> carrier, modulator;
+
+        TestSignals()
+        {
+            for (auto* signal : { &carrier, &modulator })
+            {
+                const int bin = signal == &carrier ? carrierBin : modulatorBin;
+                const float amplitude = signal == &carrier ? 0.5f : 1.0f;
+
+                signal->resize((size_t) (fftSize + blockSize));
+                for (size_t i = 0; i < signal->size(); ++i)
+                    (*signal)[i] = amplitude * (float) std::sin(juce::MathConstants<double>::twoPi * bin * (double) (i % fftSize) / fftSize);
+            }
+        }
+    };
+
+    class PointRenderer
+    {
+    public:
+        PointRenderer(double sampleRateIn, const TestSignals& signalsIn, const std::vector<int>& classOfBinIn)
+            : sampleRate(sampleRateIn), signals(signalsIn), classOfBin(classOfBinIn),
+              engine(fm_engine_create(), &fm_engine_destroy), fft(fftOrder)
+        {
+            output.resize((size_t) fftSize);
+            outputR.resize((size_t) blockSize);
+            spectrum.resize((size_t) fftSize * 2);
+        }
+
+        SweepResult run(const SweepPoint& point)
+        {
+            for (int i = 0; i < FM_ENGINE_NUM_PARAMS; ++i)
+                fm_engine_set_param(engine.get(), (fm_engine_param) i, fm_engine_param_default((fm_engine_param) i));
+
+            fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MOD_DEPTH, point.modDepth);
+            fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_MAX_DELAY_MS, (float) point.range);
+            fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_LP_CUTOFF, point.lpCutoff);
+            fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_ALGORITHM, (float) point.algorithm);
+            fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_OVERSAMPLING, point.oversampling == Oversampling::twoTimes ? 1.0f : 0.0f);
+            fm_engine_set_param(engine.get(), FM_ENGINE_PARAM_RENDER_QUALITY, point.oversampling == Oversampling::renderProfile ? 1.0f : 0.0f);
+
+            if (!prepared)
+            {
+                fm_engine_prepare(engine.get(), sampleRate, blockSize);
+                prepared = true;
+            }
+
+            fm_engine_reset(engine.get());
+
+            // Settle, then time and keep exactly one period of the input
+            const int warmup = fm_engine_get_warmup(engine.get()) + fm_engine_get_latency(engine.get());
+            juce::int64 position = 0;
+
+            for (int done = 0; done < warmup; done += blockSize)
+                process(point.algorithm, position, output.data(), blockSize);
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int done = 0; done < fftSize; done += blockSize)
+                process(point.algorithm, position, output.data() + done, blockSize);
+
+            SweepResult result;
+            result.nsPerSample = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / fftSize;
+
+            measure(result);
+            return result;
+        }
+
+    private:
+        // Algorithm 0 takes its modulator from the right input; 1 and 2 from the sidechain
+        void process(int algorithm, juce::int64& position, float* outL, int numSamples)
+        {
+            const auto offset = (size_t) (position % fftSize);
+            const float* carrier = signals.carrier.data() + offset;
+            const float* modulator = signals.modulator.data() + offset;
+
+            fm_engine_process(engine.get(), carrier, algorithm == 0 ? modulator : carrier, modulator, modulator,
+                              outL, outputR.data(), numSamples);
+            position += numSamples;
+        }
+
+        void measure(SweepResult& result)
+        {
+            std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+            std::copy(output.begin(), output.end(), spectrum.begin());
+            fft.performFrequencyOnlyForwardTransform(spectrum.data(), true);
+
+            double total = 0.0, carrierProducts = 0.0, otherProducts = 0.0, images = 0.0, noise = 0.0;
+            int numImageBins = 0, numNoiseBins = 0;
+
+            const int firstBin = (int) std::ceil(lowestHz * fftSize / sampleRate);
+
+            for (int bin = firstBin; bin <= fftSize / 2; ++bin)
+            {
+                const double power = (double) spectrum[(size_t) bin] * spectrum[(size_t) bin];
+                const int binClass = classOfBin[(size_t) bin];
+
+                total += power;
+
+                if (binClass == 1)
+                {
+                    carrierProducts += power;
+                }
+                else if (binClass >= 0)
+                {
+                    otherProducts += power;
+                }
+                else if (binClass == imageBin)
+                {
+                    images += power;
+                    ++numImageBins;
+                }
+                else
+                {
+                    noise += power;
+                    ++numNoiseBins;
+                }
+            }
+
+            // The noise floor runs under the image bins too
+            const double noisePerBin = noise / juce::jmax(1, numNoiseBins);
+            const double aliasing = juce::jmax(0.0, images - noisePerBin * numImageBins);
+
+            total = juce::jmax(total, 1.0e-30);
+            result.thdPlusNoiseDb = toDb((total - carrierProducts) / total);
+            result.aliasingDb = toDb(aliasing / total);
+            result.harmonicsDb = toDb(otherProducts / total);
+            result.noiseDb = toDb(noisePerBin * (numImageBins + numNoiseBins) / total);
+        }
+
+        const double sampleRate;
+        const TestSignals& signals;
+        const std::vector<int>& classOfBin;
+
+        std::unique_ptr<fm_engine, decltype(&fm_engine_destroy)> engine;
+        bool prepared = false;
+
+        juce::dsp::FFT fft;
+        std::vector<float> output, outputR, spectrum;
+    };
+
+    std::vector<SweepPoint> makeGrid(bool quick)
+    {
+        const std::vector<float> depths = quick ? std::vector<float> { 0.5f } : std::vector<float> { 0.1f, 0.5f, 1.0f };
+        const std::vector<int> ranges = quick ? std::vector<int> { 0, 1 } : std::vector<int> { 0, 1, 2, 3 };
+        const std::vector<float> cutoffs = quick ? std::vector<float> { 20000.0f } : std::vector<float> { 200.0f, 2000.0f, 20000.0f };
+        const std::vector<int> algorithms = quick ? std::vector<int> { 2 } : std::vector<int> { 0, 1, 2 };
+
+        std::vector<SweepPoint> grid;
+
+        for (float depth : depths)
+            for (int range : ranges)
+                for (float cutoff : cutoffs)
+                    for (int algorithm : algorithms)
+                        for (auto oversampling : { Oversampling::off, Oversampling::twoTimes, Oversampling::renderProfile })
+                            grid.push_back({ depth, range, cutoff, algorithm, oversampling });
+
+        return grid;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    double sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+    if (sampleRate <= 0.0)
+        sampleRate = 48000.0;
+
+    const auto grid = makeGrid(args.containsOption("--quick"));
+
+    int numThreads = args.getValueForOption("--threads").getIntValue();
+    if (numThreads <= 0)
+        numThreads = WorkStealingPool::defaultNumWorkers();
+    numThreads = juce::jmin(numThreads, (int) grid.size());
+
+    const TestSignals signals;
+    const auto classOfBin = classifyBins();
+
+    std::vector<std::unique_ptr<PointRenderer>> renderers;
+    for (int i = 0; i < numThreads; ++i)
+        renderers.push_back(std::make_unique<PointRenderer>(sampleRate, signals, classOfBin));
+
+    std::vector<SweepResult> results(grid.size());
+
+    WorkStealingPool pool(numThreads);
+    pool.run((int) grid.size(), [&](int worker, int item)
+    {
+        results[(size_t) item] = renderers[(size_t) worker]->run(grid[(size_t) item]);
+    });
+
+    // Table for reading, CSV for plotting
+    const auto binHz = sampleRate / fftSize;
+    std::cout << "carrier " << juce::String(carrierBin * binHz, 1) << " Hz, modulator " << juce::String(modulatorBin * binHz, 1)
+              << " Hz, " << juce::String(sampleRate, 0) << " Hz, " << numThreads << " threads\n\n";
+
+    std::cout << "depth  range  cutoff  alg  oversampling  ns/sample  THD+N dB  aliasing dB  harmonics dB  noise dB\n";
+
+    juce::String csv = "sample_rate,mod_depth,max_delay_ms,lp_cutoff_hz,algorithm,oversampling,"
+                       "ns_per_sample,thdn_db,aliasing_db,harmonics_db,noise_db\n";
+
+    for (size_t i = 0; i < grid.size(); ++i)
+    {
+        const auto& point = grid[i];
+        const auto& result = results[i];
+        const auto maxDelayMs = juce::String(rangeMs[point.range]);
+
+        std::cout << juce::String(point.modDepth, 2).paddedLeft(' ', 5)
+                  << maxDelayMs.paddedLeft(' ', 7)
+                  << juce::String(point.lpCutoff, 0).paddedLeft(' ', 8)
+                  << juce::String(point.algorithm).paddedLeft(' ', 5)
+                  << juce::String(toString(point.oversampling)).paddedLeft(' ', 14)
+                  << juce::String(result.nsPerSample, 1).paddedLeft(' ', 11)
+                  << juce::String(result.thdPlusNoiseDb, 1).paddedLeft(' ', 10)
+                  << juce::String(result.aliasingDb, 1).paddedLeft(' ', 13)
+                  << juce::String(result.harmonicsDb, 1).paddedLeft(' ', 14)
+                  << juce::String(result.noiseDb, 1).paddedLeft(' ', 10) << '\n';
+
+        csv << juce::String(sampleRate, 0) << ',' << juce::String(point.modDepth, 2) << ',' << maxDelayMs << ','
+            << juce::String(point.lpCutoff, 0) << ',' << point.algorithm << ',' << toString(point.oversampling) << ','
+            << juce::String(result.nsPerSample, 2) << ',' << juce::String(result.thdPlusNoiseDb, 2) << ','
+            << juce::String(result.aliasingDb, 2) << ',' << juce::String(result.harmonicsDb, 2) << ','
+            << juce::String(result.noiseDb, 2) << '\n';
+    }
+
+    std::cout << std::flush;
+
+    const auto outPath = args.getValueForOption("--out");
+    if (outPath.isNotEmpty())
+    {
+        const auto outFile = juce::File::getCurrentWorkingDirectory().getChildFile(outPath);
+        if (! outFile.replaceWithText(csv))
+        {
+            std::cerr << "Could not write " << outFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}